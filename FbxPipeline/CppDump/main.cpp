@@ -1,7 +1,6 @@
 // STL
 //
 
-#include <fstream>
 #include <iostream>
 #include <memory>
 
@@ -9,22 +8,19 @@
 // ThirdParty
 //
 
-#include <flatbuffers/flatbuffers.h>
-#include <flatbuffers/util.h>
 #include <spdlog/spdlog.h>
 #include <cxxopts.hpp>
 
 //
-// Generated
+// Runtime
 //
 
-#include <scene_generated.h>
+#include <runtime/FbxPipelineRuntime.h>
 
 auto console = spdlog::stdout_color_mt( "cppdump" );
 
 int main( int argc, char** argv ) {
     std::string file;
-    bool convert = false;
 
     try {
         cxxopts::Options options( argv[ 0 ] );
@@ -36,14 +32,39 @@ int main( int argc, char** argv ) {
         std::exit( 1 );
     }
 
-    std::string f;
-    if ( flatbuffers::LoadFile( file.c_str( ), true, &f ) ) {
-        if ( auto scene = fbxp::fb::GetSceneFb( f.c_str( ) ) ) {
-            if ( auto names = scene->names( ) ) {
-                for ( auto name : *names ) {
-                    console->info( "{} -> {}", name->h( ), name->v( )->c_str( ) );
-                }
+    apemode::runtime::SceneFile sceneFile;
+    if ( false == sceneFile.Load( file, apemode::runtime::eVerification_OnLoad ) ) {
+        console->critical( "failed to load: {0}", file );
+        std::exit( 1 );
+    }
+
+    auto scene = sceneFile.GetScene( );
+    if ( auto stringValues = scene->string_values( ) ) {
+        for ( auto stringValue : *stringValues ) {
+            console->info( "string: {}", stringValue->c_str( ) );
+        }
+    }
+
+    if ( auto meshes = scene->meshes( ) ) {
+        for ( uint32_t meshIndex = 0; meshIndex < meshes->size( ); ++meshIndex ) {
+            std::vector< uint8_t >       vertices;
+            std::vector< uint8_t >       indices;
+            apemode::runtime::VertexSpan vertexSpan = sceneFile.GetVertices( meshIndex );
+            apemode::runtime::IndexSpan  indexSpan  = sceneFile.GetIndices( meshIndex );
+
+            const bool encoded = sceneFile.IsMeshEncoded( meshIndex );
+            if ( encoded && false == sceneFile.DecodeMesh( meshIndex, vertices, indices, vertexSpan, indexSpan ) ) {
+                console->warn( "mesh {}: failed to decode", meshIndex );
+                continue;
             }
+
+            console->info( "mesh {}: {} vertices ({}), {} indices, {} subsets{}",
+                           meshIndex,
+                           vertexSpan.size( ),
+                           apemodefb::EnumNameEVertexFormatFb( vertexSpan.GetFormat( ) ),
+                           indexSpan.size( ),
+                           sceneFile.GetSubsets( meshIndex ).size( ),
+                           encoded ? ", decoded" : "" );
         }
     }
 
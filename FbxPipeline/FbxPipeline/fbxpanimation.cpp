@@ -16,8 +16,7 @@ void BezierFitterFitSamples( FbxAnimCurve* pAnimCurve,
                              double&       OutFittedBezier2 );
 
 template < int TCurveCount >
-void ApplyFilter( FbxAnimCurveFilter* pFilter, FbxAnimCurve** ppCurves ) {
-    auto& s = apemode::State::Get( );
+void ApplyFilter( apemode::State& s, FbxAnimCurveFilter* pFilter, FbxAnimCurve** ppCurves ) {
     FbxStatus status  = FbxStatus::eSuccess;
 
     pFilter->Apply( ppCurves, TCurveCount, &status );
@@ -30,7 +29,7 @@ void ApplyFilter( FbxAnimCurveFilter* pFilter, FbxAnimCurve** ppCurves ) {
         }
     } else {
         for ( int i = 0; i < TCurveCount; ++i ) {
-            s.console->info( "Applied{}: \"{}\": \"{}\"", P, pFilter->GetName( ), ppCurves[ i ]->GetName( ) );
+            s.console->debug( "Applied{}: \"{}\": \"{}\"", P, pFilter->GetName( ), ppCurves[ i ]->GetName( ) );
         }
     }
 }
@@ -49,11 +48,14 @@ struct FbxAnimCurveComposite {
     FbxAnimCurve*                   pAnimCurve;
     FbxAnimLayer*                   pAnimLayer;
     FbxAnimStack*                   pAnimStack;
+    int                             sourceKeyCount    = 0; /* Key counts for the build report */
+    int                             reducedKeyCount   = 0;
+    int                             resampledKeyCount = 0;
 };
 
-void ExportAnimation( FbxNode* pNode, apemode::Node& n ) {
-    auto& s      = apemode::State::Get( );
-    auto  pScene = pNode->GetScene( );
+void ExportAnimation( apemode::State& s, FbxNode* pNode, apemode::Node& n ) {
+    FBXP_PROFILE_SCOPE( "ExportAnimation", pNode->GetName( ) );
+    auto pScene = pNode->GetScene( );
 
     std::vector< FbxAnimLayerComposite > animLayers;
     animLayers.reserve( s.animLayers.size( ) );
@@ -169,10 +171,10 @@ void ExportAnimation( FbxNode* pNode, apemode::Node& n ) {
             ss.clear( );
         }
 
-        s.console->info( "\"{}\" <- \"{}\" ({} keys)",
-                         pNode->GetName( ),
-                         pAnimCurveComposite.pAnimCurve->GetName( ),
-                         pAnimCurveComposite.pAnimCurve->KeyGetCount( ) );
+        s.console->debug( "\"{}\" <- \"{}\" ({} keys)",
+                          pNode->GetName( ),
+                          pAnimCurveComposite.pAnimCurve->GetName( ),
+                          pAnimCurveComposite.pAnimCurve->KeyGetCount( ) );
     }
 
     bool  shouldResample    = false;
@@ -221,6 +223,10 @@ void ExportAnimation( FbxNode* pNode, apemode::Node& n ) {
             animCurves[ i + 1 ].pAnimCurve,
             animCurves[ i + 2 ].pAnimCurve};
 
+        for ( int j = 0; j < 3; ++j )
+            if ( nullptr != pAnimChannels[ j ] )
+                animCurves[ i + j ].sourceKeyCount = pAnimChannels[ j ]->KeyGetCount( );
+
         /* Apply filters on channels */
 
         int availableCurves = 0;
@@ -234,10 +240,10 @@ void ExportAnimation( FbxNode* pNode, apemode::Node& n ) {
                     keyCount = pAnimCurve->KeyGetCount( );
 
                     if ( reduceConstKeys )
-                        ApplyFilter< 1 >( &constantKeyReducer, &pAnimCurve );
+                        ApplyFilter< 1 >( s, &constantKeyReducer, &pAnimCurve );
 
                     if ( reduceKeys )
-                        ApplyFilter< 1 >( &keyReducer, &pAnimCurve );
+                        ApplyFilter< 1 >( s, &keyReducer, &pAnimCurve );
                 }
 
                 /* NOTE: After key reducers key count can become zero. */
@@ -250,27 +256,31 @@ void ExportAnimation( FbxNode* pNode, apemode::Node& n ) {
                                          keyCount,
                                          pAnimCurve->KeyGetCount( ) );}
                     else{
-                        s.console->info( "Reduced: \"{}\": {} -> {} keys",
-                                         pAnimCurve->GetName( ),
-                                         keyCount,
-                                         pAnimCurve->KeyGetCount( ) );}
+                        s.console->debug( "Reduced: \"{}\": {} -> {} keys",
+                                          pAnimCurve->GetName( ),
+                                          keyCount,
+                                          pAnimCurve->KeyGetCount( ) );}
 
                 }
             }
 
+        for ( int j = 0; j < 3; ++j )
+            if ( nullptr != pAnimChannels[ j ] )
+                animCurves[ i + j ].reducedKeyCount = pAnimChannels[ j ]->KeyGetCount( );
+
         /* Apply filters on properties */
 
         if ( availableCurves == 3 ) {
 
             if ( propertyCurveSync )
-                ApplyFilter< 3 >( &keySync, pAnimChannels );
+                ApplyFilter< 3 >( s, &keySync, pAnimChannels );
 
             switch ( animCurves[ i ].eAnimCurveProperty ) {
                 case apemodefb::EAnimCurvePropertyFb_GeometricRotation:
                 case apemodefb::EAnimCurvePropertyFb_LclRotation:
                 case apemodefb::EAnimCurvePropertyFb_PreRotation:
                 case apemodefb::EAnimCurvePropertyFb_PostRotation:
-                    ApplyFilter< 3 >( &gimbleKiller, pAnimChannels );
+                    ApplyFilter< 3 >( s, &gimbleKiller, pAnimChannels );
                     break;
 
                 default:
@@ -299,7 +309,7 @@ void ExportAnimation( FbxNode* pNode, apemode::Node& n ) {
                 resample.SetStopTime( stopTime );
 
                 /* NOTE: After resampling all the keys become auto keys. */
-                ApplyFilter< 3 >( &resample, pAnimChannels );
+                ApplyFilter< 3 >( s, &resample, pAnimChannels );
 
                 auto expectedApproxKeyCount = ( stopTime.Get( ) - startTime.Get( ) ) / periodTime.Get( );
                 auto resampledKeyCount      = pAnimChannels[ 0 ]->KeyGetCount( );
@@ -311,7 +321,7 @@ void ExportAnimation( FbxNode* pNode, apemode::Node& n ) {
 
                     spdlog::level::level_enum level = diffKeyCount > 3
                                                     ? spdlog::level::warn
-                                                    : spdlog::level::info;
+                                                    : spdlog::level::debug;
 
                     s.console->log( level,
                                     "Resampled (P): \"{}\": {} -> {} ({} -> {})",
@@ -341,7 +351,7 @@ void ExportAnimation( FbxNode* pNode, apemode::Node& n ) {
                         resample.SetStopTime( stopTime );
 
                         /* NOTE: After resampling all the keys become auto keys. */
-                        ApplyFilter< 1 >( &resample, &pAnimCurve );
+                        ApplyFilter< 1 >( s, &resample, &pAnimCurve );
 
                         auto expectedApproxKeyCount = ( stopTime.Get( ) - startTime.Get( ) ) / periodTime.Get( );
                         auto resampledKeyCount      = pAnimCurve->KeyGetCount( );
@@ -349,7 +359,7 @@ void ExportAnimation( FbxNode* pNode, apemode::Node& n ) {
 
                         spdlog::level::level_enum level = diffKeyCount > 2
                                                         ? spdlog::level::warn
-                                                        : spdlog::level::info;
+                                                        : spdlog::level::debug;
 
                         s.console->log( level,
                                         "Resampled: \"{}\": {} -> {} ({} -> {})",
@@ -360,6 +370,10 @@ void ExportAnimation( FbxNode* pNode, apemode::Node& n ) {
                                         diffKeyCount );
                     }
             }
+
+            for ( int j = 0; j < 3; ++j )
+                if ( nullptr != pAnimChannels[ j ] )
+                    animCurves[ i + j ].resampledKeyCount = pAnimChannels[ j ]->KeyGetCount( );
         }
     }
 
@@ -373,6 +387,15 @@ void ExportAnimation( FbxNode* pNode, apemode::Node& n ) {
             auto pAnimStack = pAnimCurveTuple.pAnimStack;
             auto pAnimLayer = pAnimCurveTuple.pAnimLayer;
 
+            s.report.animCurves.emplace_back( );
+            apemode::AnimCurveReport& curveReport = s.report.animCurves.back( );
+            curveReport.name              = pAnimCurve->GetName( );
+            curveReport.property          = apemodefb::EnumNameEAnimCurvePropertyFb( pAnimCurveTuple.eAnimCurveProperty );
+            curveReport.channel           = apemodefb::EnumNameEAnimCurveChannelFb( pAnimCurveTuple.eAnimCurveChannel );
+            curveReport.sourceKeyCount    = (uint32_t) pAnimCurveTuple.sourceKeyCount;
+            curveReport.reducedKeyCount   = (uint32_t) pAnimCurveTuple.reducedKeyCount;
+            curveReport.resampledKeyCount = (uint32_t) pAnimCurveTuple.resampledKeyCount;
+
             const int32_t keyCount = pAnimCurve->KeyGetCount( );
             if ( keyCount < 1 ) {
                 s.console->warn( "Skipped \"{}\" curve: no keys to serialize.", pAnimCurve->GetName( ) );
@@ -467,6 +490,8 @@ void ExportAnimation( FbxNode* pNode, apemode::Node& n ) {
                 }
             }
 
+            curveReport.uncompressedSize = curve.keys.size( );
+
             apemode::Stopwatch sw;
             if ( shouldCompress && keyCount > 2 ) {
 
@@ -573,7 +598,7 @@ void ExportAnimation( FbxNode* pNode, apemode::Node& n ) {
                                       ToPrettySizeString( curve.keys.size( ) ),
                                       ToPrettySizeString( encoderBuffer.size( ) ) );
                 } else {
-                    s.console->info(
+                    s.console->debug(
                         "Encoded keyframe animation: {} -> {}, ({} -> {}), "
                         "compression: {}% ({}x), keys: {}, format: {}, dt: {} seconds",
                         curve.keys.size( ),
@@ -589,8 +614,18 @@ void ExportAnimation( FbxNode* pNode, apemode::Node& n ) {
                     curve.keys.resize( encoderBuffer.size( ) );
                     memcpy( curve.keys.data( ), encoderBuffer.data( ), encoderBuffer.size( ) );
                     curve.compressionType = apemodefb::ECompressionTypeFb_GoogleDraco3D;
+                    curveReport.encodeSeconds = sw.ElapsedSeconds( );
                 }
             }
+
+            s.SerializeAnimCurveKeys( curve );
+
+            curveReport.curveId         = curveId;
+            curveReport.keyCount        = (uint32_t) keyCount;
+            curveReport.keyType         = apemodefb::EnumNameEAnimCurveKeyTypeFb( curve.keyType );
+            curveReport.compressionType = apemodefb::EnumNameECompressionTypeFb( curve.compressionType );
+            curveReport.keysSize        = curve.keysSize;
+            curveReport.blockCompressionType = apemodefb::EnumNameECompressionTypeFb( curve.keysCompression.compression_type( ) );
         }
     }
 }
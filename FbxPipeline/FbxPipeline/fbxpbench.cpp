@@ -0,0 +1,431 @@
+#include <fbxppch.h>
+#include <fbxpstate.h>
+
+#include <fstream>
+#include <random>
+
+/**
+ * Stage benchmark on procedurally generated scenes.
+ * The scene is generated with the FBX SDK (no assets required) and exported several times,
+ * the stages are timed with the profiler scopes and the statistics are computed over the iterations.
+ * The generator is seeded, the same arguments always produce the same scene.
+ **/
+
+void ExportScene( apemode::State& s, FbxScene* pScene );
+
+struct BenchSceneParams {
+    int      nodeCount        = 64;
+    int      meshCount        = 16;
+    int      triangleCount    = 10000;
+    int      skinnedMeshCount = 4;
+    int      boneCount        = 32;
+    int      curveCount       = 256;
+    int      keyCount         = 120;
+    int      materialCount    = 32;
+    uint32_t seed             = 1;
+};
+
+struct BenchStageStats {
+    std::string           name;
+    std::vector< double > milliseconds;
+    std::vector< size_t > callCounts;
+};
+
+FbxMesh* CreateGridMesh( FbxScene* pScene, const char* pszName, int triangleCount, std::mt19937& rng ) {
+    std::uniform_real_distribution< double > noise( -0.05, 0.05 );
+
+    const int columnCount = std::max( 1, (int) std::ceil( std::sqrt( triangleCount * 0.5 ) ) );
+    const int rowCount    = std::max( 1, ( triangleCount + columnCount * 2 - 1 ) / ( columnCount * 2 ) );
+
+    FbxMesh* pMesh = FbxMesh::Create( pScene, pszName );
+    pMesh->InitControlPoints( ( rowCount + 1 ) * ( columnCount + 1 ) );
+
+    FbxGeometryElementNormal* pNormals = pMesh->CreateElementNormal( );
+    pNormals->SetMappingMode( FbxGeometryElement::eByControlPoint );
+    pNormals->SetReferenceMode( FbxGeometryElement::eDirect );
+
+    FbxGeometryElementUV* pUVs = pMesh->CreateElementUV( "UVSet" );
+    pUVs->SetMappingMode( FbxGeometryElement::eByControlPoint );
+    pUVs->SetReferenceMode( FbxGeometryElement::eDirect );
+
+    FbxVector4* pControlPoints = pMesh->GetControlPoints( );
+    for ( int y = 0; y <= rowCount; ++y ) {
+        for ( int x = 0; x <= columnCount; ++x ) {
+            const double u = double( x ) / columnCount;
+            const double v = double( y ) / rowCount;
+
+            pControlPoints[ y * ( columnCount + 1 ) + x ] = FbxVector4( u * 10.0 - 5.0, v * 10.0 - 5.0, noise( rng ) );
+            pNormals->GetDirectArray( ).Add( FbxVector4( 0, 0, 1 ) );
+            pUVs->GetDirectArray( ).Add( FbxVector2( u, v ) );
+        }
+    }
+
+    /* Rows alternate between two materials (subsets). */
+    FbxGeometryElementMaterial* pMaterials = pMesh->CreateElementMaterial( );
+    pMaterials->SetMappingMode( FbxGeometryElement::eByPolygon );
+    pMaterials->SetReferenceMode( FbxGeometryElement::eIndexToDirect );
+
+    int addedTriangleCount = 0;
+    for ( int y = 0; y < rowCount && addedTriangleCount < triangleCount; ++y ) {
+        for ( int x = 0; x < columnCount && addedTriangleCount < triangleCount; ++x ) {
+            const int i0 = y * ( columnCount + 1 ) + x;
+            const int i1 = i0 + 1;
+            const int i2 = i0 + columnCount + 1;
+            const int i3 = i2 + 1;
+
+            pMesh->BeginPolygon( y % 2 );
+            pMesh->AddPolygon( i0 );
+            pMesh->AddPolygon( i1 );
+            pMesh->AddPolygon( i3 );
+            pMesh->EndPolygon( );
+
+            if ( ++addedTriangleCount < triangleCount ) {
+                pMesh->BeginPolygon( y % 2 );
+                pMesh->AddPolygon( i0 );
+                pMesh->AddPolygon( i3 );
+                pMesh->AddPolygon( i2 );
+                pMesh->EndPolygon( );
+                ++addedTriangleCount;
+            }
+        }
+    }
+
+    return pMesh;
+}
+
+void CreateSkin( FbxScene* pScene, FbxNode* pMeshNode, const std::vector< FbxNode* >& bones, std::mt19937& rng ) {
+    std::uniform_real_distribution< double > weight( 0.1, 1.0 );
+
+    FbxMesh* pMesh = pMeshNode->GetMesh( );
+    FbxSkin* pSkin = FbxSkin::Create( pScene, "" );
+
+    std::vector< FbxCluster* > clusters;
+    clusters.reserve( bones.size( ) );
+
+    for ( FbxNode* pBoneNode : bones ) {
+        FbxCluster* pCluster = FbxCluster::Create( pScene, "" );
+        pCluster->SetLink( pBoneNode );
+        pCluster->SetLinkMode( FbxCluster::eNormalize );
+        pCluster->SetTransformMatrix( pMeshNode->EvaluateGlobalTransform( ) );
+        pCluster->SetTransformLinkMatrix( pBoneNode->EvaluateGlobalTransform( ) );
+        pSkin->AddCluster( pCluster );
+        clusters.push_back( pCluster );
+    }
+
+    /* Each control point is influenced by 4 neighbouring bones. */
+    const int influenceCount = std::min< int >( 4, (int) bones.size( ) );
+    const int boneCount      = (int) bones.size( );
+
+    for ( int i = 0; i < pMesh->GetControlPointsCount( ); ++i ) {
+        double weights[ 4 ] = {};
+        double weightSum    = 0;
+        for ( int j = 0; j < influenceCount; ++j ) {
+            weights[ j ] = weight( rng );
+            weightSum += weights[ j ];
+        }
+
+        const int firstBone = ( i * boneCount ) / pMesh->GetControlPointsCount( );
+        for ( int j = 0; j < influenceCount; ++j ) {
+            clusters[ ( firstBone + j ) % boneCount ]->AddControlPointIndex( i, weights[ j ] / weightSum );
+        }
+    }
+
+    pMesh->AddDeformer( pSkin );
+}
+
+void CreateCurve( FbxAnimLayer* pAnimLayer, FbxPropertyT< FbxDouble3 >& property, const char* pszChannel, int keyCount, std::mt19937& rng ) {
+    std::uniform_real_distribution< double > noise( -0.1, 0.1 );
+
+    FbxAnimCurve* pAnimCurve = property.GetCurve( pAnimLayer, pszChannel, true );
+    if ( nullptr == pAnimCurve )
+        return;
+
+    /* All the curves have the same duration, the key density is defined by the key count. */
+    const double duration = 4.0;
+    const double phase    = noise( rng ) * 10.0;
+
+    pAnimCurve->KeyModifyBegin( );
+    for ( int i = 0; i < keyCount; ++i ) {
+        FbxTime time;
+        time.SetSecondDouble( duration * i / std::max( 1, keyCount - 1 ) );
+
+        const int keyIndex = pAnimCurve->KeyAdd( time );
+        pAnimCurve->KeySetValue( keyIndex, float( std::sin( phase + 6.28318 * i / std::max( 1, keyCount - 1 ) ) + noise( rng ) ) );
+
+        /* Mostly cubic keys, some linear and constant keys. */
+        if ( i % 7 == 6 )
+            pAnimCurve->KeySetInterpolation( keyIndex, FbxAnimCurveDef::eInterpolationConstant );
+        else if ( i % 5 == 4 )
+            pAnimCurve->KeySetInterpolation( keyIndex, FbxAnimCurveDef::eInterpolationLinear );
+        else
+            pAnimCurve->KeySetInterpolation( keyIndex, FbxAnimCurveDef::eInterpolationCubic );
+    }
+    pAnimCurve->KeyModifyEnd( );
+}
+
+void GenerateScene( FbxScene* pScene, const BenchSceneParams& params ) {
+    FBXP_PROFILE_SCOPE( "GenerateScene" );
+
+    std::mt19937 rng( params.seed );
+    std::uniform_real_distribution< double > unit( 0.0, 1.0 );
+
+    /* Materials */
+
+    std::vector< FbxSurfacePhong* > materials;
+    for ( int i = 0; i < params.materialCount; ++i ) {
+        const std::string materialName = "Material" + std::to_string( i );
+        FbxSurfacePhong* pMaterial = FbxSurfacePhong::Create( pScene, materialName.c_str( ) );
+        pMaterial->Diffuse.Set( FbxDouble3( unit( rng ), unit( rng ), unit( rng ) ) );
+        pMaterial->Specular.Set( FbxDouble3( unit( rng ), unit( rng ), unit( rng ) ) );
+        pMaterial->Shininess.Set( unit( rng ) * 100.0 );
+        materials.push_back( pMaterial );
+    }
+
+    /* Nodes: a tree with 4 children per node */
+
+    std::vector< FbxNode* > nodes;
+    for ( int i = 0; i < params.nodeCount; ++i ) {
+        const std::string nodeName = "Node" + std::to_string( i );
+        FbxNode* pNode = FbxNode::Create( pScene, nodeName.c_str( ) );
+        pNode->LclTranslation.Set( FbxDouble3( unit( rng ) * 10.0, unit( rng ) * 10.0, unit( rng ) * 10.0 ) );
+        pNode->LclRotation.Set( FbxDouble3( unit( rng ) * 90.0, unit( rng ) * 90.0, unit( rng ) * 90.0 ) );
+
+        FbxNode* pParentNode = i == 0 ? pScene->GetRootNode( ) : nodes[ ( i - 1 ) / 4 ];
+        pParentNode->AddChild( pNode );
+        nodes.push_back( pNode );
+    }
+
+    /* Bones: a chain under the root */
+
+    std::vector< FbxNode* > bones;
+    for ( int i = 0; i < params.boneCount; ++i ) {
+        const std::string boneName = "Bone" + std::to_string( i );
+        FbxSkeleton* pSkeleton = FbxSkeleton::Create( pScene, boneName.c_str( ) );
+        pSkeleton->SetSkeletonType( i == 0 ? FbxSkeleton::eRoot : FbxSkeleton::eLimbNode );
+
+        FbxNode* pBoneNode = FbxNode::Create( pScene, boneName.c_str( ) );
+        pBoneNode->SetNodeAttribute( pSkeleton );
+        pBoneNode->LclTranslation.Set( FbxDouble3( 0, i == 0 ? 0.0 : 10.0 / params.boneCount, 0 ) );
+
+        FbxNode* pParentNode = i == 0 ? pScene->GetRootNode( ) : bones.back( );
+        pParentNode->AddChild( pBoneNode );
+        bones.push_back( pBoneNode );
+    }
+
+    /* Meshes: the first nodes get the meshes, the first meshes get the skins */
+
+    const int meshCount = std::min( params.meshCount, params.nodeCount );
+    for ( int i = 0; i < meshCount; ++i ) {
+        const std::string meshName = "Mesh" + std::to_string( i );
+        FbxNode* pMeshNode = nodes[ i ];
+        pMeshNode->SetNodeAttribute( CreateGridMesh( pScene, meshName.c_str( ), params.triangleCount, rng ) );
+
+        if ( false == materials.empty( ) ) {
+            pMeshNode->AddMaterial( materials[ ( i * 2 ) % materials.size( ) ] );
+            pMeshNode->AddMaterial( materials[ ( i * 2 + 1 ) % materials.size( ) ] );
+        }
+
+        if ( i < params.skinnedMeshCount && false == bones.empty( ) )
+            CreateSkin( pScene, pMeshNode, bones, rng );
+    }
+
+    /* Curves: translation, rotation and scaling channels of the nodes and bones */
+
+    if ( params.curveCount > 0 ) {
+        FbxAnimStack* pAnimStack = FbxAnimStack::Create( pScene, "BenchStack" );
+        FbxAnimLayer* pAnimLayer = FbxAnimLayer::Create( pScene, "BenchLayer" );
+        pAnimStack->AddMember( pAnimLayer );
+
+        std::vector< FbxNode* > animatedNodes( nodes );
+        animatedNodes.insert( animatedNodes.end( ), bones.begin( ), bones.end( ) );
+
+        const char* channels[] = {FBXSDK_CURVENODE_COMPONENT_X, FBXSDK_CURVENODE_COMPONENT_Y, FBXSDK_CURVENODE_COMPONENT_Z};
+        const int   curveCount = std::min< int >( params.curveCount, (int) animatedNodes.size( ) * 9 );
+
+        for ( int i = 0; i < curveCount; ++i ) {
+            FbxNode* pNode = animatedNodes[ i / 9 ];
+
+            /* Key density varies from 0.5x to 2x of the key count argument. */
+            const int keyCount = std::max( 2, params.keyCount * ( 1 + i % 4 ) / 2 );
+
+            switch ( ( i / 3 ) % 3 ) {
+                case 0: CreateCurve( pAnimLayer, pNode->LclTranslation, channels[ i % 3 ], keyCount, rng ); break;
+                case 1: CreateCurve( pAnimLayer, pNode->LclRotation, channels[ i % 3 ], keyCount, rng ); break;
+                case 2: CreateCurve( pAnimLayer, pNode->LclScaling, channels[ i % 3 ], keyCount, rng ); break;
+            }
+        }
+    }
+}
+
+void ComputeStats( std::vector< double > samples, double& minValue, double& medianValue, double& meanValue, double& stddevValue, double& maxValue ) {
+    minValue = medianValue = meanValue = stddevValue = maxValue = 0;
+    if ( samples.empty( ) )
+        return;
+
+    std::sort( samples.begin( ), samples.end( ) );
+    minValue    = samples.front( );
+    maxValue    = samples.back( );
+    medianValue = samples.size( ) % 2 ? samples[ samples.size( ) / 2 ]
+                                      : ( samples[ samples.size( ) / 2 - 1 ] + samples[ samples.size( ) / 2 ] ) * 0.5;
+
+    for ( const double sample : samples )
+        meanValue += sample;
+    meanValue /= samples.size( );
+
+    if ( samples.size( ) > 1 ) {
+        for ( const double sample : samples )
+            stddevValue += ( sample - meanValue ) * ( sample - meanValue );
+        stddevValue = std::sqrt( stddevValue / ( samples.size( ) - 1 ) );
+    }
+}
+
+int GetIntOption( apemode::State& s, const char* name, int defaultValue ) {
+    return s.options[ name ].count( ) > 0 ? s.options[ name ].as< int >( ) : defaultValue;
+}
+
+int main( int argc, char** argv ) {
+    auto& s = apemode::State::Get( );
+
+    s.options.add_options( "bench" )( "nodes", "Node count (64 - default).", cxxopts::value< int >( ) );
+    s.options.add_options( "bench" )( "meshes", "Mesh count, each mesh is attached to its own node (16 - default).", cxxopts::value< int >( ) );
+    s.options.add_options( "bench" )( "triangles", "Triangle count per mesh (10000 - default).", cxxopts::value< int >( ) );
+    s.options.add_options( "bench" )( "skinned-meshes", "Skinned mesh count (4 - default).", cxxopts::value< int >( ) );
+    s.options.add_options( "bench" )( "bones", "Bone count in the skeleton (32 - default).", cxxopts::value< int >( ) );
+    s.options.add_options( "bench" )( "curves", "Animation curve count (256 - default).", cxxopts::value< int >( ) );
+    s.options.add_options( "bench" )( "keys", "Average key count per curve, varies from 0.5x to 2x (120 - default).", cxxopts::value< int >( ) );
+    s.options.add_options( "bench" )( "materials", "Material count (32 - default).", cxxopts::value< int >( ) );
+    s.options.add_options( "bench" )( "seed", "Generator seed (1 - default).", cxxopts::value< int >( ) );
+    s.options.add_options( "bench" )( "iterations", "Measured iterations (5 - default).", cxxopts::value< int >( ) );
+    s.options.add_options( "bench" )( "warmup", "Warmup iterations, not included into the statistics (1 - default).", cxxopts::value< int >( ) );
+    s.options.add_options( "bench" )( "bench-report", "JSON file with the stage statistics.", cxxopts::value< std::string >( ) );
+
+    apemode::State::Main( argc, (const char**&) argv );
+
+    BenchSceneParams params;
+    params.nodeCount        = std::max( 1, GetIntOption( s, "nodes", params.nodeCount ) );
+    params.meshCount        = std::max( 0, GetIntOption( s, "meshes", params.meshCount ) );
+    params.triangleCount    = std::max( 1, GetIntOption( s, "triangles", params.triangleCount ) );
+    params.skinnedMeshCount = std::max( 0, GetIntOption( s, "skinned-meshes", params.skinnedMeshCount ) );
+    params.boneCount        = std::max( 0, GetIntOption( s, "bones", params.boneCount ) );
+    params.curveCount       = std::max( 0, GetIntOption( s, "curves", params.curveCount ) );
+    params.keyCount         = std::max( 2, GetIntOption( s, "keys", params.keyCount ) );
+    params.materialCount    = std::max( 0, GetIntOption( s, "materials", params.materialCount ) );
+    params.seed             = (uint32_t) GetIntOption( s, "seed", (int) params.seed );
+
+    const int iterationCount = std::max( 1, GetIntOption( s, "iterations", 5 ) );
+    const int warmupCount    = std::max( 0, GetIntOption( s, "warmup", 1 ) );
+
+    /* The stages are timed with the profiler scopes, the trace is also saved if requested. */
+    s.profiler.Enable( );
+
+    if ( false == s.Initialize( ) )
+        return 1;
+
+    /* The output goes to the current directory unless the output file is specified. */
+    s.folderPath = "";
+    s.fileName   = "fbxp_bench";
+
+    s.summary->info( "Bench: nodes: {}, meshes: {} x {} triangles, skinned meshes: {}, bones: {}, curves: {} x ~{} keys, materials: {}, seed: {}",
+                     params.nodeCount,
+                     params.meshCount,
+                     params.triangleCount,
+                     params.skinnedMeshCount,
+                     params.boneCount,
+                     params.curveCount,
+                     params.keyCount,
+                     params.materialCount,
+                     params.seed );
+
+    std::vector< BenchStageStats > stages;
+    for ( int iteration = 0; iteration < warmupCount + iterationCount; ++iteration ) {
+        /* The export modifies the scene (triangulation, key reduction), so it is generated for every iteration. */
+        s.Reset( );
+        GenerateScene( s.scene, params );
+
+        const size_t firstEvent = s.profiler.events.size( );
+        {
+            FBXP_PROFILE_SCOPE( "Total" );
+            ExportScene( s, s.scene );
+            s.Finalize( );
+        }
+
+        if ( iteration < warmupCount )
+            continue;
+
+        /* Nested and repeated scopes (ExportMesh, ExportAnimation, ...) are summed per iteration. */
+        std::lock_guard< std::mutex > lock( s.profiler.mutex );
+
+        std::map< std::string, std::pair< double, size_t > > iterationStages;
+        for ( size_t i = firstEvent; i < s.profiler.events.size( ); ++i ) {
+            const apemode::ProfileEvent& profileEvent = s.profiler.events[ i ];
+            auto& iterationStage = iterationStages[ profileEvent.name ];
+            iterationStage.first += profileEvent.durationMicroseconds * 0.001;
+            iterationStage.second += 1;
+        }
+
+        for ( auto& iterationStage : iterationStages ) {
+            auto stageIt = std::find_if( stages.begin( ), stages.end( ), [&]( const BenchStageStats& stage ) {
+                return stage.name == iterationStage.first;
+            } );
+
+            if ( stageIt == stages.end( ) ) {
+                stages.emplace_back( );
+                stageIt = stages.end( ) - 1;
+                stageIt->name = iterationStage.first;
+            }
+
+            stageIt->milliseconds.push_back( iterationStage.second.first );
+            stageIt->callCounts.push_back( iterationStage.second.second );
+        }
+    }
+
+    std::sort( stages.begin( ), stages.end( ), []( const BenchStageStats& a, const BenchStageStats& b ) {
+        return a.name < b.name;
+    } );
+
+    std::ofstream benchReport;
+    if ( s.options[ "bench-report" ].count( ) > 0 ) {
+        benchReport.open( s.options[ "bench-report" ].as< std::string >( ), std::ios::out | std::ios::trunc );
+        benchReport << "{\"iterations\":" << iterationCount << ",\"warmup\":" << warmupCount << ",\"stages\":[\n";
+    }
+
+    s.summary->info( "" );
+    s.summary->info( "{:<28} {:>6} {:>10} {:>10} {:>10} {:>10} {:>10}", "Stage (ms)", "calls", "min", "median", "mean", "stddev", "max" );
+    for ( size_t i = 0; i < stages.size( ); ++i ) {
+        const BenchStageStats& stage = stages[ i ];
+
+        double minValue, medianValue, meanValue, stddevValue, maxValue;
+        ComputeStats( stage.milliseconds, minValue, medianValue, meanValue, stddevValue, maxValue );
+
+        s.summary->info( "{:<28} {:>6} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f}",
+                         stage.name,
+                         stage.callCounts.back( ),
+                         minValue,
+                         medianValue,
+                         meanValue,
+                         stddevValue,
+                         maxValue );
+
+        /* Stage names are the profiler scope names, there is nothing to escape. */
+        if ( benchReport.is_open( ) ) {
+            benchReport << "{\"name\":\"" << stage.name << "\"";
+            benchReport << ",\"calls\":" << stage.callCounts.back( );
+            benchReport << ",\"samples\":" << stage.milliseconds.size( );
+            benchReport << ",\"min\":" << minValue;
+            benchReport << ",\"median\":" << medianValue;
+            benchReport << ",\"mean\":" << meanValue;
+            benchReport << ",\"stddev\":" << stddevValue;
+            benchReport << ",\"max\":" << maxValue;
+            benchReport << ( i + 1 < stages.size( ) ? "},\n" : "}\n" );
+        }
+    }
+
+    if ( benchReport.is_open( ) )
+        benchReport << "]}\n";
+
+    if ( s.options[ "trace" ].count( ) > 0 )
+        s.profiler.Save( s.options[ "trace" ].as< std::string >( ) );
+
+    s.Release( );
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include <fbxppch.h>
+#include <scene_generated.h>
+
+#include <zstd.h>
+#include <lz4.h>
+#include <lz4hc.h>
+
+/**
+ * Block codecs (--block-compression argument).
+ * The buffers are compressed as a whole, the uncompressed size is stored next to the buffer (BlockCompressionFb).
+ * Zstd gives the better ratio, LZ4 decodes at several GB/s (the levels above 0 use LZ4HC, same decoder).
+ **/
+
+bool ParseBlockCompressionType( const std::string& name, apemodefb::ECompressionTypeFb& compressionType ) {
+    if ( name.empty( ) || name == "none" ) {
+        compressionType = apemodefb::ECompressionTypeFb_None;
+        return true;
+    }
+    if ( name == "zstd" ) {
+        compressionType = apemodefb::ECompressionTypeFb_Zstd;
+        return true;
+    }
+    if ( name == "lz4" ) {
+        compressionType = apemodefb::ECompressionTypeFb_LZ4;
+        return true;
+    }
+
+    return false;
+}
+
+int GetDefaultBlockCompressionLevel( apemodefb::ECompressionTypeFb compressionType ) {
+    switch ( compressionType ) {
+        case apemodefb::ECompressionTypeFb_Zstd:
+            return 9;
+        case apemodefb::ECompressionTypeFb_LZ4:
+            return LZ4HC_CLEVEL_DEFAULT;
+        default:
+            return 0;
+    }
+}
+
+/* Returns false if the codec failed, the destination is left empty then. */
+bool CompressBlock( apemodefb::ECompressionTypeFb compressionType,
+                    int                           level,
+                    const void*                   src,
+                    size_t                        srcSize,
+                    std::vector< uint8_t >&       dst ) {
+    dst.clear( );
+
+    switch ( compressionType ) {
+        case apemodefb::ECompressionTypeFb_Zstd: {
+            level = std::min( std::max( level, 1 ), ZSTD_maxCLevel( ) );
+            dst.resize( ZSTD_compressBound( srcSize ) );
+
+            const size_t dstSize = ZSTD_compress( dst.data( ), dst.size( ), src, srcSize, level );
+            if ( ZSTD_isError( dstSize ) ) {
+                dst.clear( );
+                return false;
+            }
+
+            dst.resize( dstSize );
+            return true;
+        }
+
+        case apemodefb::ECompressionTypeFb_LZ4: {
+            if ( srcSize > LZ4_MAX_INPUT_SIZE )
+                return false;
+
+            dst.resize( LZ4_compressBound( int( srcSize ) ) );
+
+            const int dstSize = level > 0
+                ? LZ4_compress_HC( (const char*) src, (char*) dst.data( ), int( srcSize ), int( dst.size( ) ), std::min( level, LZ4HC_CLEVEL_MAX ) )
+                : LZ4_compress_default( (const char*) src, (char*) dst.data( ), int( srcSize ), int( dst.size( ) ) );
+
+            if ( dstSize <= 0 ) {
+                dst.clear( );
+                return false;
+            }
+
+            dst.resize( size_t( dstSize ) );
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+/* The destination size must match the uncompressed size exactly. */
+bool DecompressBlock( apemodefb::ECompressionTypeFb compressionType,
+                      const void*                   src,
+                      size_t                        srcSize,
+                      void*                         dst,
+                      size_t                        dstSize ) {
+    switch ( compressionType ) {
+        case apemodefb::ECompressionTypeFb_None:
+            if ( srcSize != dstSize )
+                return false;
+            memcpy( dst, src, srcSize );
+            return true;
+
+        case apemodefb::ECompressionTypeFb_Zstd: {
+            const size_t decompressedSize = ZSTD_decompress( dst, dstSize, src, srcSize );
+            return false == ZSTD_isError( decompressedSize ) && decompressedSize == dstSize;
+        }
+
+        case apemodefb::ECompressionTypeFb_LZ4: {
+            if ( srcSize > LZ4_MAX_INPUT_SIZE || dstSize > LZ4_MAX_INPUT_SIZE )
+                return false;
+
+            const int decompressedSize = LZ4_decompress_safe( (const char*) src, (char*) dst, int( srcSize ), int( dstSize ) );
+            return decompressedSize >= 0 && size_t( decompressedSize ) == dstSize;
+        }
+
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,353 @@
+#include <fbxppch.h>
+#include <fbxpstate.h>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+bool        MakeDirectory( const char* directory );
+bool        FileExists( const char* filePath );
+bool        WriteFile( const char* srcFilePath, const void* data, size_t dataSize );
+bool        GetBinFileSize( const char* srcPath, size_t& fileSize );
+bool        ReadBinFile( const char* srcPath, uint8_t* fileBuffer, size_t fileSize );
+bool        RenameFile( const char* srcPath, const char* dstPath );
+std::string ResolveFullPath( const char* path );
+std::string FileExtension( const char* path );
+std::string ToPrettySizeString( size_t size );
+void        UpdateSearchLocations( apemode::State& s );
+void        SplitFilename( const std::string& filePath, std::string* parentFolderName, std::string* fileName );
+
+namespace {
+    /* Bump when the layout of the cache entries changes. */
+    const uint32_t kCacheVersion = 2;
+    const uint64_t kHashSeed     = 0xcbf29ce484222325ull;
+
+    /* Options that do not change the output (logging, output paths, threading, reports) are not hashed. */
+    const char* const kBoolOptions[]       = {"c", "p", "b", "s", "t", "sync-keys", "reduce-keys", "reduce-const-keys", "enable-fat-skinned-vertices", "split-blobs", "pack-orm"};
+    const char* const kStringOptions[]     = {"password", "mesh-compression", "anim-compression", "block-compression", "texture-format"};
+    const char* const kFloatOptions[]      = {"resample-framerate", "mesh-decode-budget", "mesh-error-tolerance"};
+    const char* const kIntOptions[]        = {"block-compression-level", "atlas-max-size", "atlas-size"};
+    const char* const kStringListOptions[] = {"e", "m", "script-file", "script-input"};
+
+    void HashString( uint64_t& hash, const std::string& value ) {
+        const uint64_t valueSize = value.size( );
+        HashCombine( hash, &valueSize, sizeof( valueSize ) );
+        HashCombine( hash, value.data( ), value.size( ) );
+    }
+
+    /* The inputs can be large, the file is hashed in chunks. */
+    bool HashFile( uint64_t& hash, const std::string& filePath ) {
+        std::ifstream fileStream( filePath, std::ios::binary );
+        if ( false == fileStream.good( ) )
+            return false;
+
+        std::vector< char > chunk( 1 << 20 );
+        while ( fileStream ) {
+            fileStream.read( chunk.data( ), chunk.size( ) );
+            HashCombine( hash, chunk.data( ), static_cast< size_t >( fileStream.gcount( ) ) );
+        }
+
+        return true;
+    }
+
+    /* Files added to or removed from the search locations can change the resolved textures. */
+    uint64_t HashSearchLocations( const apemode::State& s ) {
+        uint64_t hash = kHashSeed;
+        for ( auto& searchLocationFilePath : s.searchLocationFilePaths )
+            HashString( hash, searchLocationFilePath );
+
+        return hash;
+    }
+
+    std::string ToHexString( const uint64_t value ) {
+        std::stringstream ss;
+        ss << std::hex << std::setw( 16 ) << std::setfill( '0' ) << value;
+        return ss.str( );
+    }
+
+    bool HashAssetInputs( apemode::State& s, uint64_t& hash ) {
+        HashCombine( hash, &kCacheVersion, sizeof( kCacheVersion ) );
+
+        const uint8_t version = apemodefb::EVersionFb_Value;
+        HashCombine( hash, &version, sizeof( version ) );
+
+        if ( false == HashFile( hash, s.inputFile ) )
+            return false;
+
+        for ( const char* optionName : kBoolOptions ) {
+            const bool value = s.options[ optionName ].count( ) > 0 && s.options[ optionName ].as< bool >( );
+            HashCombine( hash, &value, sizeof( value ) );
+        }
+
+        for ( const char* optionName : kStringOptions ) {
+            HashString( hash, s.options[ optionName ].count( ) > 0 ? s.options[ optionName ].as< std::string >( ) : "" );
+        }
+
+        for ( const char* optionName : kStringListOptions ) {
+            if ( s.options[ optionName ].count( ) > 0 )
+                for ( auto& value : s.options[ optionName ].as< std::vector< std::string > >( ) )
+                    HashString( hash, value );
+        }
+
+        /* Script inputs are usually files (glTF materials), their contents matter too. */
+        if ( s.options[ "script-input" ].count( ) > 0 )
+            for ( auto& scriptInput : s.options[ "script-input" ].as< std::vector< std::string > >( ) )
+                if ( FileExists( scriptInput.c_str( ) ) )
+                    HashFile( hash, scriptInput );
+
+        /* The scripts are read directly, the embedded files (-m) are patterns and the matched files go to the dependencies. */
+        if ( s.options[ "script-file" ].count( ) > 0 )
+            for ( auto& scriptFile : s.options[ "script-file" ].as< std::vector< std::string > >( ) )
+                if ( false == HashFile( hash, scriptFile ) )
+                    s.console->warn( "Cache: Failed to read the script \"{}\"", scriptFile );
+
+        for ( const char* optionName : kFloatOptions ) {
+            const float value = s.options[ optionName ].count( ) > 0 ? s.options[ optionName ].as< float >( ) : -1.0f;
+            HashCombine( hash, &value, sizeof( value ) );
+        }
+
+        for ( const char* optionName : kIntOptions ) {
+            const int value = s.options[ optionName ].count( ) > 0 ? s.options[ optionName ].as< int >( ) : -1;
+            HashCombine( hash, &value, sizeof( value ) );
+        }
+
+        return true;
+    }
+
+    /* The buffer is left untouched on failures. */
+    bool ReadCacheFile( const std::string& filePath, std::vector< uint8_t >& fileBuffer ) {
+        size_t fileSize = 0;
+        if ( false == GetBinFileSize( filePath.c_str( ), fileSize ) )
+            return false;
+
+        std::vector< uint8_t > cachedBuffer( fileSize );
+        if ( false == ReadBinFile( filePath.c_str( ), cachedBuffer.data( ), fileSize ) )
+            return false;
+
+        fileBuffer.swap( cachedBuffer );
+        return true;
+    }
+
+    /* Written to a temporary file and renamed, the concurrent jobs can store the same entry. */
+    bool WriteCacheFile( const std::string& filePath, const void* data, size_t dataSize ) {
+        std::stringstream tempFilePath;
+        tempFilePath << filePath << "." << std::this_thread::get_id( ) << ".tmp";
+
+        return WriteFile( tempFilePath.str( ).c_str( ), data, dataSize ) &&
+               RenameFile( tempFilePath.str( ).c_str( ), filePath.c_str( ) );
+    }
+} // namespace
+
+bool apemode::BuildCache::Enabled( ) const {
+    return false == directory.empty( );
+}
+
+bool apemode::BuildCache::RestoreAsset( State& s ) {
+    assetKey = 0;
+    restoredDependencies.clear( );
+    if ( false == Enabled( ) )
+        return false;
+
+    FBXP_PROFILE_SCOPE( "CacheLookup", s.inputFile.c_str( ) );
+
+    uint64_t inputsHash = kHashSeed;
+    if ( false == HashAssetInputs( s, inputsHash ) ) {
+        s.console->warn( "Cache: Failed to hash the inputs of {}", s.inputFile );
+        return false;
+    }
+
+    assetKey = inputsHash;
+    const std::string entryPath = directory + "/assets/" + ToHexString( assetKey );
+
+    /* The list of the referenced files is written last, its presence means the entry is complete. */
+    std::ifstream dependenciesStream( entryPath + ".deps" );
+    if ( false == dependenciesStream.good( ) ) {
+        s.console->info( "Cache: Miss {}", s.inputFile );
+        return false;
+    }
+
+    /* The lines are "<hash> <path>" for the found files, "missing <name>" and "listing <hash>" for the search locations. */
+    UpdateSearchLocations( s );
+
+    std::vector< std::string > dependencyPaths;
+    std::string                dependencyHash;
+    std::string                dependencyPath;
+    while ( dependenciesStream >> dependencyHash && std::getline( dependenciesStream >> std::ws, dependencyPath ) ) {
+        if ( dependencyHash == "listing" ) {
+            if ( ToHexString( HashSearchLocations( s ) ) != dependencyPath ) {
+                s.console->info( "Cache: Miss {}, search locations changed", s.inputFile );
+                return false;
+            }
+        } else if ( dependencyHash == "missing" ) {
+            const auto fileIt = s.searchLocationFiles.find( dependencyPath );
+            if ( fileIt != s.searchLocationFiles.end( ) && false == fileIt->second.empty( ) ) {
+                s.console->info( "Cache: Miss {}, \"{}\" found", s.inputFile, dependencyPath );
+                return false;
+            }
+        } else {
+            uint64_t fileHash = kHashSeed;
+            if ( false == HashFile( fileHash, dependencyPath ) || ToHexString( fileHash ) != dependencyHash ) {
+                s.console->info( "Cache: Miss {}, \"{}\" changed", s.inputFile, dependencyPath );
+                return false;
+            }
+
+            dependencyPaths.push_back( dependencyPath );
+        }
+    }
+
+    std::vector< uint8_t > output;
+    const std::string      outputEntryPath = entryPath + "." + apemodefb::SceneFbExtension( );
+    if ( false == ReadCacheFile( outputEntryPath, output ) ) {
+        s.console->warn( "Cache: Missing output {}", outputEntryPath );
+        return false;
+    }
+
+    const std::string outputFile = s.GetOutputFile( );
+    std::string       outputFolder;
+    SplitFilename( outputFile, &outputFolder, nullptr );
+    if ( false == outputFolder.empty( ) )
+        MakeDirectory( outputFolder.c_str( ) );
+
+    /* The blob files of the split mode are stored under the entry path with their extensions, and restored next to the scene. */
+    const auto scene = apemodefb::GetSceneFb( output.data( ) );
+    if ( scene->blob_files( ) ) {
+        const std::string      outputFilePrefix = outputFile.substr( 0, outputFile.find_last_of( "/\\" ) + 1 );
+        std::vector< uint8_t > blob;
+        for ( auto blobFileName : *scene->blob_files( ) ) {
+            const std::string blobEntryPath = entryPath + FileExtension( blobFileName->c_str( ) );
+            const std::string blobFile      = outputFilePrefix + blobFileName->str( );
+            if ( false == ReadCacheFile( blobEntryPath, blob ) ) {
+                s.console->warn( "Cache: Missing output {}", blobEntryPath );
+                return false;
+            }
+
+            if ( false == WriteFile( blobFile.c_str( ), blob.data( ), blob.size( ) ) ) {
+                s.console->error( "Cache: Failed to write output to {}", blobFile );
+                return false;
+            }
+        }
+    }
+
+    if ( false == WriteFile( outputFile.c_str( ), output.data( ), output.size( ) ) ) {
+        s.console->error( "Cache: Failed to write output to {}", outputFile );
+        return false;
+    }
+
+    s.report.inputFile  = s.inputFile;
+    s.report.outputFile = ResolveFullPath( outputFile.c_str( ) );
+    s.report.outputSize = output.size( );
+    s.report.cached     = true;
+    restoredDependencies.swap( dependencyPaths );
+
+    s.summary->info( "Cache: Hit {} -> {} ({})", s.inputFile, outputFile, ToPrettySizeString( output.size( ) ) );
+    return true;
+}
+
+void apemode::BuildCache::StoreAsset( State& s ) {
+    if ( false == Enabled( ) || 0 == assetKey )
+        return;
+
+    FBXP_PROFILE_SCOPE( "CacheStore", s.inputFile.c_str( ) );
+
+    const std::string entryPath = directory + "/assets/" + ToHexString( assetKey );
+    if ( false == WriteCacheFile( entryPath + "." + apemodefb::SceneFbExtension( ), s.builder.GetBufferPointer( ), s.builder.GetSize( ) ) ) {
+        s.console->warn( "Cache: Failed to store {}", entryPath );
+        return;
+    }
+
+    /* The blob files are closed in State::Finalize. */
+    std::vector< uint8_t > blob;
+    for ( auto& blobFile : s.blobFiles ) {
+        if ( blobFile.id == (uint32_t) -1 )
+            continue;
+
+        if ( false == ReadCacheFile( blobFile.fullPath, blob ) ||
+             false == WriteCacheFile( entryPath + FileExtension( blobFile.fullPath.c_str( ) ), blob.data( ), blob.size( ) ) ) {
+            s.console->warn( "Cache: Failed to store {}", entryPath );
+            return;
+        }
+    }
+
+    /* The textures are found in the search locations, the key does not cover them. */
+    std::stringstream dependencies;
+    dependencies << "listing " << ToHexString( HashSearchLocations( s ) ) << "\n";
+    for ( auto& unresolvedFile : s.unresolvedFiles )
+        dependencies << "missing " << unresolvedFile << "\n";
+
+    for ( auto& embeddedFile : s.embeddedFiles ) {
+        uint64_t fileHash = kHashSeed;
+        if ( false == embeddedFile.fullPath.empty( ) && HashFile( fileHash, embeddedFile.fullPath ) )
+            dependencies << ToHexString( fileHash ) << " " << embeddedFile.fullPath << "\n";
+    }
+
+    const std::string dependenciesContent = dependencies.str( );
+    if ( false == WriteCacheFile( entryPath + ".deps", dependenciesContent.data( ), dependenciesContent.size( ) ) ) {
+        s.console->warn( "Cache: Failed to store {}", entryPath );
+        return;
+    }
+
+    s.console->info( "Cache: Stored {}", entryPath );
+}
+
+bool apemode::BuildCache::StagesEnabled( ) const {
+    return Enabled( ) || resident;
+}
+
+bool apemode::BuildCache::LoadStage( const char* stageName, uint64_t stageKey, std::vector< uint8_t >& stageOutput ) {
+    if ( false == StagesEnabled( ) )
+        return false;
+
+    const std::string stageFileName = std::string( stageName ) + "-" + ToHexString( stageKey ) + ".bin";
+    if ( resident ) {
+        const auto residentStageIt = residentStages.find( stageFileName );
+        if ( residentStageIt != residentStages.end( ) ) {
+            usedResidentStages.insert( stageFileName );
+            stageOutput = residentStageIt->second;
+            return true;
+        }
+    }
+
+    if ( false == Enabled( ) || false == ReadCacheFile( directory + "/stages/" + stageFileName, stageOutput ) )
+        return false;
+
+    if ( resident ) {
+        usedResidentStages.insert( stageFileName );
+        residentStages[ stageFileName ] = stageOutput;
+    }
+
+    return true;
+}
+
+void apemode::BuildCache::StoreStage( const char* stageName, uint64_t stageKey, const std::vector< uint8_t >& stageOutput ) {
+    if ( false == StagesEnabled( ) )
+        return;
+
+    const std::string stageFileName = std::string( stageName ) + "-" + ToHexString( stageKey ) + ".bin";
+    if ( resident ) {
+        usedResidentStages.insert( stageFileName );
+        residentStages[ stageFileName ] = stageOutput;
+    }
+
+    if ( Enabled( ) )
+        WriteCacheFile( directory + "/stages/" + stageFileName, stageOutput.data( ), stageOutput.size( ) );
+}
+
+void apemode::BuildCache::TrimResidentStages( ) {
+    for ( auto residentStageIt = residentStages.begin( ); residentStageIt != residentStages.end( ); ) {
+        if ( usedResidentStages.count( residentStageIt->first ) )
+            ++residentStageIt;
+        else
+            residentStageIt = residentStages.erase( residentStageIt );
+    }
+
+    usedResidentStages.clear( );
+}
+
+void apemode::BuildCache::CreateDirectories( ) const {
+    if ( false == Enabled( ) )
+        return;
+
+    MakeDirectory( directory.c_str( ) );
+    MakeDirectory( ( directory + "/assets" ).c_str( ) );
+    MakeDirectory( ( directory + "/stages" ).c_str( ) );
+}
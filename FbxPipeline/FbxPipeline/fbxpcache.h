@@ -0,0 +1,47 @@
+#pragma once
+#include <fbxppch.h>
+#include <map>
+#include <set>
+
+/**
+ * Incremental build cache (--cache argument).
+ *
+ * Assets are keyed by the hash of the input file, the options that change the output,
+ * the format version and the contents of the scripts.
+ * Along with the output, the entry keeps the files referenced during the export (textures found in search locations,
+ * files embedded with -m) with their hashes, the names that were not found and the hash of the search location listing,
+ * and is valid while all of them are unchanged.
+ *
+ * The expensive per-mesh stages (Draco encoding) are keyed by the hash of their input buffers
+ * and are reused even if some other part of the asset changed.
+ * In the watch mode the stage results are also kept in memory (resident), even without the cache directory.
+ **/
+
+namespace apemode {
+
+    struct State;
+
+    struct FBXPIPELINE_API BuildCache {
+        std::string                                     directory;
+        uint64_t                                        assetKey = 0;
+        bool                                            resident = false;
+        std::map< std::string, std::vector< uint8_t > > residentStages;
+        std::set< std::string >                         usedResidentStages;
+        std::vector< std::string >                      restoredDependencies; /* The referenced files of the restored asset (watch mode). */
+
+        bool Enabled( ) const;
+        bool StagesEnabled( ) const;
+        void CreateDirectories( ) const;
+
+        /* Computes the asset key, copies the cached output and returns true if the entry is valid. */
+        bool RestoreAsset( State& s );
+        /* Stores the output (still in the builder after State::Finalize) and the referenced files of the asset. */
+        void StoreAsset( State& s );
+
+        bool LoadStage( const char* stageName, uint64_t stageKey, std::vector< uint8_t >& stageOutput );
+        void StoreStage( const char* stageName, uint64_t stageKey, const std::vector< uint8_t >& stageOutput );
+        /* Releases the resident stages that were not used since the previous call (replaced meshes). */
+        void TrimResidentStages( );
+    };
+
+} // namespace apemode
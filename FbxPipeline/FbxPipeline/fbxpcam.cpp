@@ -1,9 +1,7 @@
 #include <fbxppch.h>
 #include <fbxpstate.h>
 
-void ExportCamera( FbxNode* pNode, apemode::Node& n ) {
-    auto& s = apemode::State::Get( );
-
+void ExportCamera( apemode::State& s, FbxNode* pNode, apemode::Node& n ) {
     if ( auto pCamera = pNode->GetCamera( ) ) {
         float width, height;
         switch ( const auto format = pCamera->CameraFormat.Get( ) ) {
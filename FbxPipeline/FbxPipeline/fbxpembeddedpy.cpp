@@ -156,9 +156,14 @@ void InitializePyModule( py::module & m ) {
         .def_readwrite( "int_values",       &apemode::State::intValues )
         .def_readwrite( "float_values",     &apemode::State::floatValues )
         .def_readwrite( "string_values",    &apemode::State::stringValues )
-        .def_readwrite( "textures",         &apemode::State::textures )
+        .def_property( "textures",          []( apemode::State* pState ) { return pState->textures; },
+                                            []( apemode::State* pState, const std::vector< apemodefb::TextureFb >& textures ) {
+                                                /* The lookup is rebuilt on the next push, the replaced textures can have the same count. */
+                                                pState->textures = textures;
+                                                pState->textureHashDict.clear( );
+                                            } )
         .def_readwrite( "materials",        &apemode::State::materials )
-        .def( "embed_file",                 &apemode::State::EmbedFile )
+        .def( "embed_file",                 []( apemode::State* pState, std::string fullPath ) { return pState->EmbedFile( fullPath ); } )
         .def( "push_texture",               []( apemode::State* pState, const apemodefb::TextureFb t ) { return (uint32_t) pState->PushValue( t ); } )
         .def( "push_string",                []( apemode::State* pState, std::string s ) { return (uint32_t) pState->PushValue( s ); } )
         .def( "push_float4",                []( apemode::State* pState, const float x, const float y, const float z, const float w ) { return (uint32_t) pState->PushValue( x, y, z, w ); } )
@@ -12,9 +12,14 @@ std::string FileExtension( const char* path );
 std::string ToPrettySizeString( size_t size );
 bool        ReadTxtFile( const char* srcPath, std::string& fileBuffer, bool findFile );
 
-void RunExtensionsOnFinalize( ) {
-    auto& s = apemode::State::Get( );
-
+/**
+ * The interpreter is created once and kept alive until the state is released,
+ * the scripts are executed once (or after reloading, watch mode), and the registered extensions run for every asset (batch mode).
+ **/
+std::unique_ptr< py::scoped_interpreter > pythonInterpreter;
+bool                                      pythonScriptsExecuted = false;
+
+void RunExtensionsOnFinalize( apemode::State& s ) {
     s.console->info( "" );
     s.console->info( "" );
     s.console->info( "RunExtensionsOnFinalize" );
@@ -33,11 +38,15 @@ void RunExtensionsOnFinalize( ) {
         }
     }
 
-    if ( bContainsPythonExtensions ) {
+    if ( bContainsPythonExtensions && !pythonInterpreter ) {
 
         // Start the interpreter and keep it alive
         s.console->info( "Creating python interpreter ..." );
-        py::scoped_interpreter guard{};
+        pythonInterpreter.reset( new py::scoped_interpreter( ) );
+    }
+
+    if ( bContainsPythonExtensions && !pythonScriptsExecuted ) {
+        pythonScriptsExecuted = true;
 
         // Load FbxPipeline module from .pyd in current directory.
         s.console->info( "Importing python FbxPipeline module ..." );
@@ -64,7 +73,9 @@ void RunExtensionsOnFinalize( ) {
                 }
             }
         }
+    }
 
+    if ( bContainsPythonExtensions ) {
         for ( auto& extensionFunc : s.extensions ) {
             for ( auto& scriptInput : scriptInputs ) {
                 try {
@@ -85,3 +96,15 @@ void RunExtensionsOnFinalize( ) {
     // TODO: Other interpreters.
     //       JS, lua, ...
 }
+
+void ReloadExtensions( apemode::State& s ) {
+    // The scripts register the functions again on the next finalization
+    s.extensions.clear( );
+    pythonScriptsExecuted = false;
+}
+
+void ReleaseExtensions( apemode::State& s ) {
+    // Registered python functions must be released before the interpreter
+    ReloadExtensions( s );
+    pythonInterpreter.reset( );
+}
@@ -2,9 +2,8 @@
 #include <fbxpstate.h>
 
 // #define _FbxPipeline_UnsafeFileReadWrite
-#if defined( _FbxPipeline_UnsafeFileReadWrite )
 #include <stdio.h>
-#endif
+#include <string.h>
 
 #if !defined(_WIN32)
 #include <boost/filesystem.hpp>
@@ -22,9 +21,17 @@ namespace std {
 #endif
 
 #include <fstream>
+#include <future>
 #include <iterator>
+#include <map>
+#include <regex>
+#include <set>
 #include <string>
 
+/* xxHash64 bundled with LZ4, compiled into this unit. */
+#define XXH_PRIVATE_API
+#include <xxhash.h>
+
 std::string CurrentDirectory( ) {
     return std::filesystem::current_path( ).string( );
 }
@@ -37,6 +44,17 @@ bool MakeDirectory( const char* directory ) {
     return std::filesystem::create_directory( directory );
 }
 
+/* Replaces the destination file if it exists. */
+bool RenameFile( const char* srcPath, const char* dstPath ) {
+    try {
+        std::filesystem::rename( srcPath, dstPath );
+        return true;
+    } catch ( const std::exception& ) {
+    }
+
+    return false;
+}
+
 std::string GetFileName( const char* filePath ) {
     return std::filesystem::path( filePath ).filename( ).string( );
 }
@@ -53,6 +71,12 @@ bool FileExists( const char* filePath ) {
     return std::filesystem::is_regular_file( filePath );
 }
 
+int64_t GetDirectoryWriteTime( const std::string& directoryPath ) {
+    std::error_code errorCode;
+    const auto writeTime = std::filesystem::last_write_time( directoryPath, errorCode );
+    return errorCode ? -1 : static_cast< int64_t >( writeTime.time_since_epoch( ).count( ) );
+}
+
 std::string ReplaceSlashes( std::string path ) {
     std::replace( path.begin( ), path.end( ), '\\', '/' );
     return path;
@@ -82,18 +106,22 @@ std::string ResolveFullPath( const char* path ) {
     return ReplaceSlashes( RealPath( std::filesystem::absolute( path ).string( ) ) );
 }
 
+/**
+ * Looks up the file name in the search location index (see InitializeSeachLocations).
+ * In case there are multiple files with the same name, the one from the first search location is returned.
+ * The names that are not found are remembered for the build cache (see BuildCache::StoreAsset).
+ **/
 std::string FindFile( const char* filepath ) {
     auto& s = apemode::State::Get( );
 
     if ( filepath && strlen( filepath ) ) {
-        const std::string filename = GetFileName( filepath );
-        for ( auto& searchLocation : s.searchLocations ) {
-            for ( auto fileOrFolderPath : std::filesystem::directory_iterator( searchLocation ) ) {
-                if ( std::filesystem::is_regular_file( fileOrFolderPath ) && fileOrFolderPath.path( ).filename( ) == filename ) {
-                    return ResolveFullPath( fileOrFolderPath.path( ).string( ).c_str( ) );
-                }
-            }
+        const std::string fileName = GetFileName( filepath );
+        const auto fileIt = s.searchLocationFiles.find( fileName );
+        if ( fileIt != s.searchLocationFiles.end( ) && false == fileIt->second.empty( ) ) {
+            return fileIt->second.front( );
         }
+
+        s.unresolvedFiles.insert( fileName );
     }
 
     return "";
@@ -252,6 +280,345 @@ bool ReadBinFile( const char* srcPath, std::vector< uint8_t >& fileBuffer, bool
     return false;
 }
 
+bool GetBinFileSize( const char* srcPath, size_t& fileSize ) {
+    fileSize = 0;
+
+    /* Called from the prefetching threads, no logging here. */
+    try {
+        if ( srcPath && std::filesystem::is_regular_file( srcPath ) ) {
+            fileSize = static_cast< size_t >( std::filesystem::file_size( srcPath ) );
+            return true;
+        }
+    } catch ( const std::exception& ) {
+    }
+
+    return false;
+}
+
+/**
+ * Reads exactly fileSize bytes into the preallocated memory (for example, the builder's uninitialized vector).
+ * The stream is unbuffered, so the bytes go directly from the OS to the destination.
+ **/
+bool ReadBinFile( const char* srcPath, uint8_t* fileBuffer, size_t fileSize ) {
+    if ( FILE* srcFile = fopen( srcPath, "rb" ) ) {
+        setvbuf( srcFile, nullptr, _IONBF, 0 );
+
+        size_t readSize = 0;
+        while ( readSize < fileSize ) {
+            const size_t chunkSize = fread( fileBuffer + readSize, 1, fileSize - readSize, srcFile );
+            if ( 0 == chunkSize )
+                break;
+
+            readSize += chunkSize;
+        }
+
+        fclose( srcFile );
+        return readSize == fileSize;
+    }
+
+    return false;
+}
+
+/* Content hash of the embedded files, the duplicates are written once (see State::DeduplicateFile). */
+uint64_t HashFileContent( const void* data, size_t dataSize ) {
+    return XXH64( data, dataSize, 0 );
+}
+
+/* Compares the file with the buffer in chunks (the embedded files with the same hash, see State::DeduplicateFile). */
+bool CompareFileContent( const char* srcPath, const void* data, size_t dataSize ) {
+    FILE* srcFile = fopen( srcPath, "rb" );
+    if ( nullptr == srcFile )
+        return false;
+
+    const uint8_t* dataBytes = static_cast< const uint8_t* >( data );
+    size_t         readSize  = 0;
+    bool           equal     = true;
+
+    std::vector< uint8_t > chunk( 1 << 20 );
+    while ( const size_t chunkSize = fread( chunk.data( ), 1, chunk.size( ), srcFile ) ) {
+        if ( readSize + chunkSize > dataSize || 0 != memcmp( chunk.data( ), dataBytes + readSize, chunkSize ) ) {
+            equal = false;
+            break;
+        }
+
+        readSize += chunkSize;
+    }
+
+    equal = equal && readSize == dataSize && 0 == ferror( srcFile );
+    fclose( srcFile );
+    return equal;
+}
+
+/* Compares the files in chunks. */
+bool CompareFileContent( const char* srcPath, const char* otherSrcPath ) {
+    FILE* srcFile      = fopen( srcPath, "rb" );
+    FILE* otherSrcFile = fopen( otherSrcPath, "rb" );
+
+    bool equal = srcFile && otherSrcFile;
+    if ( equal ) {
+        std::vector< uint8_t > chunk( 1 << 20 );
+        std::vector< uint8_t > otherChunk( 1 << 20 );
+        for ( ;; ) {
+            const size_t chunkSize      = fread( chunk.data( ), 1, chunk.size( ), srcFile );
+            const size_t otherChunkSize = fread( otherChunk.data( ), 1, otherChunk.size( ), otherSrcFile );
+            if ( chunkSize != otherChunkSize || 0 != memcmp( chunk.data( ), otherChunk.data( ), chunkSize ) ) {
+                equal = false;
+                break;
+            }
+
+            if ( 0 == chunkSize )
+                break;
+        }
+
+        equal = equal && 0 == ferror( srcFile ) && 0 == ferror( otherSrcFile );
+    }
+
+    if ( srcFile )
+        fclose( srcFile );
+    if ( otherSrcFile )
+        fclose( otherSrcFile );
+    return equal;
+}
+
+apemode::FilePrefetcher::~FilePrefetcher( ) {
+    Stop( );
+}
+
+void apemode::FilePrefetcher::Start( uint32_t workerCount, size_t memoryBudget ) {
+    Stop( );
+
+    std::lock_guard< std::mutex > lock( mutex );
+    stop        = false;
+    threadCount = workerCount;
+    budget      = memoryBudget;
+
+    if ( budget ) {
+        for ( uint32_t i = 0; i < threadCount; ++i ) {
+            workers.emplace_back( &apemode::FilePrefetcher::Run, this );
+        }
+    }
+}
+
+void apemode::FilePrefetcher::Stop( ) {
+    {
+        std::lock_guard< std::mutex > lock( mutex );
+        stop = true;
+        queue.clear( );
+        ready.clear( );
+    }
+
+    cv.notify_all( );
+    for ( auto& worker : workers ) {
+        worker.join( );
+    }
+
+    workers.clear( );
+}
+
+void apemode::FilePrefetcher::Push( uint32_t fileId, const std::string& fullPath, ETextureUsage usage ) {
+    {
+        std::lock_guard< std::mutex > lock( mutex );
+        if ( entries.size( ) <= fileId )
+            entries.resize( fileId + 1 );
+
+        entries[ fileId ].fullPath = fullPath;
+        entries[ fileId ].usage    = usage;
+        entries[ fileId ].state    = eState_Queued;
+
+        if ( false == workers.empty( ) )
+            queue.push_back( fileId );
+    }
+
+    cv.notify_all( );
+}
+
+bool apemode::FilePrefetcher::Acquire( uint32_t fileId, std::vector< uint8_t >& buffer, uint64_t& contentHash, size_t& contentSize ) {
+    std::unique_lock< std::mutex > lock( mutex );
+    if ( entries.size( ) <= fileId )
+        return false;
+
+    /* The file is either ready, failed, or was not started (it will be skipped by the workers). */
+    cv.wait( lock, [&] { return entries[ fileId ].state != eState_Reading; } );
+
+    auto& entry = entries[ fileId ];
+    const bool ready = entry.state == eState_Ready;
+    if ( ready ) {
+        contentHash = entry.contentHash;
+        contentSize = entry.contentSize;
+        buffer      = std::move( entry.buffer );
+        entry.buffer.clear( );
+        entry.buffer.shrink_to_fit( );
+        budgetUsed -= buffer.size( );
+    }
+
+    entry.state = eState_Taken;
+    lock.unlock( );
+
+    cv.notify_all( );
+    return ready;
+}
+
+bool apemode::FilePrefetcher::AcquireReady( uint32_t& fileId, std::vector< uint8_t >& buffer, uint64_t& contentHash, size_t& contentSize ) {
+    std::unique_lock< std::mutex > lock( mutex );
+
+    /* Skip the files that were already acquired by their ids. */
+    while ( false == ready.empty( ) ) {
+        const uint32_t readyFileId = ready.front( );
+        ready.pop_front( );
+
+        auto& entry = entries[ readyFileId ];
+        if ( entry.state == eState_Ready ) {
+            fileId      = readyFileId;
+            contentHash = entry.contentHash;
+            contentSize = entry.contentSize;
+            buffer      = std::move( entry.buffer );
+            entry.buffer.clear( );
+            entry.buffer.shrink_to_fit( );
+            entry.state = eState_Taken;
+            budgetUsed -= buffer.size( );
+
+            lock.unlock( );
+            cv.notify_all( );
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void apemode::FilePrefetcher::Restore( uint32_t fileId, std::vector< uint8_t >& buffer, uint64_t contentHash, size_t contentSize ) {
+    {
+        std::lock_guard< std::mutex > lock( mutex );
+        if ( entries.size( ) <= fileId )
+            entries.resize( fileId + 1 );
+
+        /* The budget can be exceeded, the workers wait until the buffer is acquired. */
+        auto& entry = entries[ fileId ];
+        budgetUsed -= entry.buffer.size( );
+        budgetUsed += buffer.size( );
+        entry.contentHash = contentHash;
+        entry.contentSize = contentSize;
+        entry.buffer      = std::move( buffer );
+        entry.state       = eState_Ready;
+        ready.push_back( fileId );
+    }
+
+    buffer.clear( );
+    cv.notify_all( );
+}
+
+void apemode::FilePrefetcher::Run( ) {
+    std::unique_lock< std::mutex > lock( mutex );
+
+    for ( ;; ) {
+        cv.wait( lock, [&] { return stop || false == queue.empty( ); } );
+        if ( stop )
+            return;
+
+        const uint32_t fileId = queue.front( );
+        queue.pop_front( );
+
+        const std::string   fullPath = entries[ fileId ].fullPath;
+        const ETextureUsage usage    = entries[ fileId ].usage;
+        lock.unlock( );
+
+        size_t fileSize = 0;
+        const bool gotFileSize = GetBinFileSize( fullPath.c_str( ), fileSize );
+        lock.lock( );
+
+        /* Files that can never fit into the budget are left to the caller. */
+        if ( false == gotFileSize || fileSize > budget )
+            continue;
+
+        cv.wait( lock, [&] { return stop || entries[ fileId ].state == eState_Taken || budgetUsed + fileSize <= budget; } );
+        if ( stop )
+            return;
+        if ( entries[ fileId ].state == eState_Taken )
+            continue;
+
+        entries[ fileId ].state = eState_Reading;
+        budgetUsed += fileSize;
+        lock.unlock( );
+
+        std::vector< uint8_t > buffer( fileSize );
+        ProfileScope readScope( "PrefetchFile", fullPath.c_str( ) );
+        const bool readFile = ReadBinFile( fullPath.c_str( ), buffer.data( ), fileSize );
+        readScope.End( );
+
+        /* The source contents are hashed before the transcoding. */
+        const uint64_t contentHash = readFile ? HashFileContent( buffer.data( ), buffer.size( ) ) : 0;
+
+        /* The transcoded buffer replaces the file in the budget. */
+        if ( readFile && process ) {
+            process( fullPath, usage, buffer );
+        }
+
+        lock.lock( );
+
+        auto& entry = entries[ fileId ];
+        if ( readFile ) {
+            budgetUsed = budgetUsed - fileSize + buffer.size( );
+            entry.contentHash = contentHash;
+            entry.contentSize = fileSize;
+            entry.buffer      = std::move( buffer );
+            entry.state  = eState_Ready;
+            ready.push_back( fileId );
+        } else {
+            entry.state = eState_Failed;
+            budgetUsed -= fileSize;
+        }
+
+        cv.notify_all( );
+    }
+}
+
+apemode::BlobFile::~BlobFile( ) {
+    Close( );
+}
+
+bool apemode::BlobFile::Open( const std::string& filePath ) {
+    Close( );
+
+    fullPath = filePath;
+    size     = 0;
+    stream   = fopen( filePath.c_str( ), "wb" );
+    failed   = nullptr == stream;
+    return false == failed;
+}
+
+bool apemode::BlobFile::Append( const void* data, size_t dataSize, size_t alignment, uint64_t& offset ) {
+    if ( nullptr == stream || failed )
+        return false;
+
+    /* The file is written sequentially, the padding is written instead of seeking (no 64-bit fseek). */
+    static const uint8_t kZeros[ 256 ] = {};
+    assert( alignment <= sizeof( kZeros ) );
+
+    const size_t paddingSize = static_cast< size_t >( ( alignment - size % alignment ) % alignment );
+    if ( paddingSize && fwrite( kZeros, 1, paddingSize, stream ) != paddingSize ) {
+        failed = true;
+        return false;
+    }
+
+    offset = size + paddingSize;
+    if ( dataSize && fwrite( data, 1, dataSize, stream ) != dataSize ) {
+        failed = true;
+        return false;
+    }
+
+    size = offset + dataSize;
+    return true;
+}
+
+bool apemode::BlobFile::Close( ) {
+    if ( stream ) {
+        failed |= 0 != fclose( stream );
+        stream = nullptr;
+    }
+
+    return false == failed;
+}
+
 template < int TPrecision = 100 >
 float RoundOff( float n ) {
     const float i = n * static_cast< float >( TPrecision ) + 0.5f;
@@ -280,18 +647,16 @@ std::string ToPrettySizeString( size_t size ) {
     return oss.str( );
 }
 
-void InitializeSeachLocations( ) {
-    auto& s = apemode::State::Get( );
-
-    s.console->info( "" );
-    s.console->info( "" );
-    s.console->info( "InitializeSeachLocations" );
-
+/**
+ * Search locations are scanned once, each top-level location in its own thread.
+ * The result is the index of file names to full paths, that makes file look-ups O(1).
+ **/
+void IndexSearchLocations( apemode::State& s ) {
     auto searchLocations = s.options[ "search-location" ].as< std::vector< std::string > >( );
 
     searchLocations.push_back( CurrentDirectory( ) );
 
-    std::string inputFile = s.options[ "input-file" ].as< std::string >( );
+    std::string inputFile = s.inputFile;
     ReplaceSlashes( inputFile );
 
     const std::string fbmDirectory = ReplaceSlashes( ReplaceExtension( inputFile.c_str( ), "fbm" ) );
@@ -321,7 +686,12 @@ void InitializeSeachLocations( ) {
         }
     }
 
-    std::set< std::string > searchDirectories;
+    struct SearchLocationScan {
+        std::map< std::string, std::set< std::string > > files;
+    };
+
+    std::vector< std::future< SearchLocationScan > > searchLocationScans;
+    searchLocationScans.reserve( searchLocations.size( ) );
 
     for ( auto searchDirectory : searchLocations ) {
         bool addSubDirectories = false;
@@ -336,38 +706,121 @@ void InitializeSeachLocations( ) {
         }
 
         if ( DirectoryExists( searchDirectory.c_str( ) ) ) {
-            if ( !addSubDirectories ) {
-                searchDirectories.insert( ResolveFullPath( searchDirectory.c_str( ) ) );
-            } else {
-                const std::string resolvedSearchDirectory = ResolveFullPath( searchDirectory.c_str( ) );
-                searchDirectories.insert( resolvedSearchDirectory );
-
-                for ( auto& searchDirectoryIt : std::filesystem::recursive_directory_iterator( resolvedSearchDirectory ) ) {
-                    if ( std::filesystem::is_directory( searchDirectoryIt.path( ) ) )
-                        searchDirectories.insert( ResolveFullPath( searchDirectoryIt.path( ).string( ).c_str( ) ) );
+            const std::string resolvedSearchDirectory = ResolveFullPath( searchDirectory.c_str( ) );
+
+            searchLocationScans.push_back( std::async( std::launch::async, [resolvedSearchDirectory, addSubDirectories]( ) {
+                FBXP_PROFILE_SCOPE( "ScanSearchLocation", resolvedSearchDirectory.c_str( ) );
+
+                SearchLocationScan scan;
+                scan.files[ resolvedSearchDirectory ];
+
+                if ( !addSubDirectories ) {
+                    for ( auto& fileOrFolderPath : std::filesystem::directory_iterator( resolvedSearchDirectory ) ) {
+                        if ( std::filesystem::is_regular_file( fileOrFolderPath.path( ) ) )
+                            scan.files[ resolvedSearchDirectory ].insert( fileOrFolderPath.path( ).filename( ).string( ) );
+                    }
+                } else {
+                    /* Every directory is resolved once, the file names are joined onto it. */
+                    std::map< std::string, std::string > resolvedDirectories;
+                    auto resolveDirectory = [&resolvedDirectories]( const std::string& directory ) -> const std::string& {
+                        auto resolvedDirectoryIt = resolvedDirectories.find( directory );
+                        if ( resolvedDirectoryIt == resolvedDirectories.end( ) )
+                            resolvedDirectoryIt = resolvedDirectories.emplace( directory, ResolveFullPath( directory.c_str( ) ) ).first;
+                        return resolvedDirectoryIt->second;
+                    };
+
+                    for ( auto& fileOrFolderPath : std::filesystem::recursive_directory_iterator( resolvedSearchDirectory ) ) {
+                        const auto& path = fileOrFolderPath.path( );
+                        if ( std::filesystem::is_directory( path ) ) {
+                            scan.files[ resolveDirectory( path.string( ) ) ];
+                        } else if ( std::filesystem::is_regular_file( path ) ) {
+                            scan.files[ resolveDirectory( path.parent_path( ).string( ) ) ].insert( path.filename( ).string( ) );
+                        }
+                    }
                 }
-            }
+
+                return scan;
+            } ) );
         }
     }
 
+    /* Merge the scans, std::map keeps the directories sorted (same order as before). */
+    std::map< std::string, std::set< std::string > > searchDirectories;
+    for ( auto& searchLocationScan : searchLocationScans ) {
+        for ( auto& directoryFiles : searchLocationScan.get( ).files ) {
+            searchDirectories[ directoryFiles.first ].insert( directoryFiles.second.begin( ), directoryFiles.second.end( ) );
+        }
+    }
+
+    s.searchLocations.clear( );
+    s.searchLocationWriteTimes.clear( );
+    s.searchLocationFiles.clear( );
+    s.searchLocationFilePaths.clear( );
+
     if ( false == searchDirectories.empty( ) ) {
-        s.searchLocations.assign( searchDirectories.begin( ), searchDirectories.end( ) );
+        s.searchLocations.reserve( searchDirectories.size( ) );
+        s.searchLocationWriteTimes.reserve( searchDirectories.size( ) );
+
+        for ( auto& directoryFiles : searchDirectories ) {
+            s.searchLocations.push_back( directoryFiles.first );
+            s.searchLocationWriteTimes.push_back( GetDirectoryWriteTime( directoryFiles.first ) );
+
+            for ( auto& fileName : directoryFiles.second ) {
+                std::string fullPath = ReplaceSlashes( directoryFiles.first + "/" + fileName );
+                s.searchLocationFiles[ fileName ].push_back( fullPath );
+                s.searchLocationFilePaths.push_back( std::move( fullPath ) );
+            }
+        }
 
-        s.console->info( "Search locations:" );
+        s.console->debug( "Search locations:" );
         for ( auto& searchLocation : s.searchLocations ) {
-            s.console->info( "\t> {}", searchLocation );
+            s.console->debug( "\t> {}", searchLocation );
         }
 
-        const auto& embedFilePatterns = s.options[ "embed-file" ].as< std::vector< std::string > >( );
-        for ( auto& embedFilePattern : embedFilePatterns ) {
-            std::regex embedFilePatternRegex( embedFilePattern );
-            for ( auto& searchLocation : s.searchLocations ) {
-                for ( auto fileOrFolderPath : std::filesystem::directory_iterator( searchLocation ) ) {
-                    if ( std::filesystem::is_regular_file( fileOrFolderPath ) &&
-                         std::regex_match( fileOrFolderPath.path( ).string( ), embedFilePatternRegex ) ) {
-                        s.EmbedFile( ResolveFullPath( fileOrFolderPath.path( ).string( ).c_str( ) ) );
-                    }
-                }
+        s.console->info( "Indexed {} files.", s.searchLocationFilePaths.size( ) );
+    }
+}
+
+/* The files added, removed or renamed in the directory change its write time. */
+bool SearchLocationsChanged( const apemode::State& s ) {
+    if ( s.searchLocationWriteTimes.size( ) != s.searchLocations.size( ) )
+        return true;
+
+    for ( size_t i = 0; i < s.searchLocations.size( ); ++i ) {
+        if ( GetDirectoryWriteTime( s.searchLocations[ i ] ) != s.searchLocationWriteTimes[ i ] ) {
+            s.console->info( "Search location \"{}\" changed.", s.searchLocations[ i ] );
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* The index is kept while the same input is exported again (watch mode, bench) and the directories are unchanged. */
+void UpdateSearchLocations( apemode::State& s ) {
+    if ( s.searchLocationsInputFile != s.inputFile || s.searchLocations.empty( ) || SearchLocationsChanged( s ) ) {
+        IndexSearchLocations( s );
+        s.searchLocationsInputFile = s.inputFile;
+    } else {
+        s.console->info( "Reused {} indexed files.", s.searchLocationFilePaths.size( ) );
+    }
+}
+
+void InitializeSeachLocations( apemode::State& s ) {
+    FBXP_PROFILE_SCOPE( "InitializeSeachLocations" );
+
+    s.console->info( "" );
+    s.console->info( "" );
+    s.console->info( "InitializeSeachLocations" );
+
+    UpdateSearchLocations( s );
+
+    const auto& embedFilePatterns = s.options[ "embed-file" ].as< std::vector< std::string > >( );
+    for ( auto& embedFilePattern : embedFilePatterns ) {
+        std::regex embedFilePatternRegex( embedFilePattern );
+        for ( auto& searchLocationFilePath : s.searchLocationFilePaths ) {
+            if ( std::regex_match( searchLocationFilePath, embedFilePatternRegex ) ) {
+                s.EmbedFile( searchLocationFilePath );
             }
         }
     }
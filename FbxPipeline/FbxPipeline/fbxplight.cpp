@@ -1,8 +1,7 @@
 #include <fbxppch.h>
 #include <fbxpstate.h>
 
-void ExportLight(FbxNode* pNode, apemode::Node& n) {
-    auto& s = apemode::State::Get( );
+void ExportLight( apemode::State& s, FbxNode* pNode, apemode::Node& n ) {
     if ( auto pLight = pNode->GetLight( ) ) {
         switch ( pLight->LightType.Get( ) ) {
             case FbxLight::eVolume:
@@ -0,0 +1,17 @@
+// stb_image_sources (decoding only)
+#define STBI_NO_STDIO
+#define STBI_FAILURE_USERMSG
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+// stb_image_write_sources (packed textures)
+#define STBI_WRITE_NO_STDIO
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+
+// rgbcx_sources (BC1, BC3, BC4, BC5)
+#define RGBCX_IMPLEMENTATION
+#include "rgbcx.h"
+
+// bc7enc_sources (BC7)
+#include "bc7enc.cpp"
@@ -2,9 +2,24 @@
 #include <fbxpstate.h>
 #include <scene_generated.h>
 
+#include <map>
+#include <set>
+
 std::string FindFile( const char* filepath );
 std::string GetFileName( const char* filePath );
 std::string ReplaceExtension( const char* path, const char* extension );
+bool        ReadBinFile( const char* srcPath, std::vector< uint8_t >& fileBuffer, bool findFile );
+uint64_t    HashFileContent( const void* data, size_t dataSize );
+bool        PackTextureChannels( const std::vector< uint8_t >* const ( &images )[ 3 ],
+                                 const uint32_t ( &imageChannels )[ 3 ],
+                                 std::vector< uint8_t >& packedImage,
+                                 std::string&            errorMessage );
+void        BuildTextureAtlases( const std::vector< const std::vector< uint8_t >* >& images,
+                                 uint32_t                                            maxImageSize,
+                                 uint32_t                                            atlasSize,
+                                 uint32_t                                            gutter,
+                                 std::vector< std::vector< uint8_t > >&              atlasImages,
+                                 std::vector< apemode::TextureAtlasTile >&           tiles );
 
 template < typename TPropertyCallbackFn, typename TObjectCallbackFn >
 void ScanConnectedSrc( FbxObject*          pPropObj,
@@ -31,9 +46,20 @@ void ScanConnectedSrc( FbxObject*          pPropObj,
     }
 }
 
+/* Guesses how the texture is sampled from the material property name (NormalMap, DiffuseColor, Maya|TEX_normal_map, ...). */
+apemode::ETextureUsage GetTextureUsage( const char* propertyName ) {
+    std::string name = propertyName;
+    std::transform( name.begin( ), name.end( ), name.begin( ), ::tolower );
+
+    if ( name.find( "normal" ) != std::string::npos )
+        return apemode::eTextureUsage_Normal;
+    if ( name.find( "color" ) != std::string::npos )
+        return apemode::eTextureUsage_Color;
+    return apemode::eTextureUsage_Data;
+}
 
-void ExportMaterials( FbxScene* pScene ) {
-    auto& s = apemode::State::Get( );
+void ExportMaterials( apemode::State& s, FbxScene* pScene ) {
+    FBXP_PROFILE_SCOPE( "ExportMaterials" );
 
     s.console->info( "" );
     s.console->info( "" );
@@ -56,8 +82,8 @@ void ExportMaterials( FbxScene* pScene ) {
             assert( s.materialDict.find( materialId ) == s.materialDict.end( ) );
             s.materialDict[ materialId ] = id;
 
-            s.console->info( "" );
-            s.console->info( "Material: \"{}\" ({})", material->GetName( ), materialId );
+            s.console->debug( "" );
+            s.console->debug( "Material: \"{}\" ({})", material->GetName( ), materialId );
 
             /*
             https://help.sketchfab.com/hc/en-us/articles/202600873-Materials-and-Textures
@@ -195,17 +221,18 @@ void ExportMaterials( FbxScene* pScene ) {
                             fileUrl = pTexture->GetName( );
                         }
 
-                        s.console->info( "Bound texture: \"{}\" <= \"{}\" <= \"{}\"",
-                                         GetFileName( fileUrl.c_str( ) ),
-                                         pSrcObj->GetName( ),
-                                         srcProperty.GetNameAsCStr( ) );
+                        s.console->debug( "Bound texture: \"{}\" <= \"{}\" <= \"{}\"",
+                                          GetFileName( fileUrl.c_str( ) ),
+                                          pSrcObj->GetName( ),
+                                          srcProperty.GetNameAsCStr( ) );
 
                         uint32_t fileId = std::numeric_limits< uint32_t >::max( );
+                        const auto textureUsage = GetTextureUsage( srcProperty.GetNameAsCStr( ) );
 
                         auto fullFilePath = FindFile( fileUrl.c_str( ) );
                         if ( false == fullFilePath.empty( ) ) {
-                            s.console->info( "Full path (default): \"{}\"", fullFilePath );
-                            fileId = s.EmbedFile( fullFilePath );
+                            s.console->debug( "Full path (default): \"{}\"", fullFilePath );
+                            fileId = s.EmbedFile( fullFilePath, textureUsage );
                         } else {
                             // https://help.sketchfab.com/hc/en-us/articles/202600873-Materials-and-Textures
                             // Anything that is not .JPG or .PNG is converted to .PNG.
@@ -213,14 +240,14 @@ void ExportMaterials( FbxScene* pScene ) {
                             /* Sketchfab case */
                             fullFilePath = FindFile( ( fileUrl + ".png" ).c_str( ) );
                             if ( false == fullFilePath.empty( ) ) {
-                                s.console->info( "Full path (sketchfab): \"{}\"", fullFilePath );
-                                fileId = s.EmbedFile( fullFilePath );
+                                s.console->debug( "Full path (sketchfab): \"{}\"", fullFilePath );
+                                fileId = s.EmbedFile( fullFilePath, textureUsage );
                             } else {
 
                                 fullFilePath = FindFile( ReplaceExtension( fileUrl.c_str( ), ".png" ).c_str( ) );
                                 if ( false == fullFilePath.empty( ) ) {
-                                    s.console->info( "Full path (sketchfab): \"{}\"", fullFilePath );
-                                    fileId = s.EmbedFile( fullFilePath );
+                                    s.console->debug( "Full path (sketchfab): \"{}\"", fullFilePath );
+                                    fileId = s.EmbedFile( fullFilePath, textureUsage );
                                 }
                             }
                         }
@@ -257,10 +284,10 @@ void ExportMaterials( FbxScene* pScene ) {
 
                             m.textureProperties.emplace_back( s.PushValue( srcProperty.GetNameAsCStr( ) ), textureId );
 
-                            s.console->info( "Found texture \"{}\" (\"{}\") (\"{}\")",
-                                             pTexture->GetName( ),
-                                             GetFileName( fullFilePath.c_str( ) ).c_str( ),
-                                             srcProperty.GetName( ).Buffer( ) );
+                            s.console->debug( "Found texture \"{}\" (\"{}\") (\"{}\")",
+                                              pTexture->GetName( ),
+                                              GetFileName( fullFilePath.c_str( ) ).c_str( ),
+                                              srcProperty.GetName( ).Buffer( ) );
                         }
                     }
                 } );
@@ -268,8 +295,7 @@ void ExportMaterials( FbxScene* pScene ) {
     }
 }
 
-void ExportMaterials( FbxNode* node, apemode::Node& n ) {
-    auto& s = apemode::State::Get( );
+void ExportMaterials( apemode::State& s, FbxNode* node, apemode::Node& n ) {
     if ( const auto c = node->GetMaterialCount( ) ) {
         n.materialIds.reserve( c );
         for ( auto i = 0; i < c; ++i ) {
@@ -278,7 +304,336 @@ void ExportMaterials( FbxNode* node, apemode::Node& n ) {
             assert( s.materialDict.find( materialId ) != s.materialDict.end( ) );
             n.materialIds.push_back( s.materialDict[ materialId ] );
 
-            s.console->info( "Node \"{}\" += Material \"{}\" ({})", node->GetName( ), material->GetName( ), materialId );
+            s.console->debug( "Node \"{}\" += Material \"{}\" ({})", node->GetName( ), material->GetName( ), materialId );
+        }
+    }
+}
+
+/**
+ * Channels of the ORM texture (R - occlusion, G - roughness, B - metalness) the material texture property provides,
+ * the glTF metallicRoughnessTexture is already packed in G and B. Returns 0 for the other properties.
+ **/
+uint32_t GetOrmChannelMask( const std::string& propertyName ) {
+    const uint32_t kOcclusion = 1 << 0;
+    const uint32_t kRoughness = 1 << 1;
+    const uint32_t kMetalness = 1 << 2;
+
+    std::string name = propertyName;
+    std::transform( name.begin( ), name.end( ), name.begin( ), ::tolower );
+
+    const bool metal = name.find( "metal" ) != std::string::npos;
+    const bool rough = name.find( "rough" ) != std::string::npos;
+    if ( metal && rough )
+        return kRoughness | kMetalness;
+    if ( metal )
+        return kMetalness;
+    if ( rough )
+        return kRoughness;
+    if ( name.find( "occlusion" ) != std::string::npos || name == "ao" || name.find( "_ao" ) != std::string::npos )
+        return kOcclusion;
+    return 0;
+}
+
+/**
+ * Takes the source image from the prefetcher (the textures are not transcoded on the prefetching threads while packing),
+ * or reads it if it was not prefetched.
+ **/
+bool AcquireSourceFile( apemode::State& s, uint32_t fileId, std::vector< uint8_t >& fileBuffer ) {
+    uint64_t contentHash = 0;
+    size_t   contentSize = 0;
+    return s.filePrefetcher.Acquire( fileId, fileBuffer, contentHash, contentSize ) ||
+           ReadBinFile( s.embeddedFiles[ fileId ].fullPath.c_str( ), fileBuffer, false );
+}
+
+/* Puts the source image back to the prefetcher, the file is not read again if it is written. */
+void RestoreSourceFile( apemode::State& s, uint32_t fileId, std::vector< uint8_t >& fileBuffer ) {
+    const uint64_t contentHash = HashFileContent( fileBuffer.data( ), fileBuffer.size( ) );
+    const size_t   contentSize = fileBuffer.size( );
+    s.filePrefetcher.Restore( fileId, fileBuffer, contentHash, contentSize );
+}
+
+/**
+ * Merges the occlusion, roughness and metalness maps referenced by the same material into a single texture
+ * and replaces their texture properties with "occlusionRoughnessMetallicTexture" (--pack-orm).
+ * The textures and the files that are not referenced by any material after packing are not written.
+ **/
+void PackMaterialTextures( apemode::State& s ) {
+    FBXP_PROFILE_SCOPE( "PackMaterialTextures" );
+
+    const auto getString = [&]( const uint32_t valueId ) {
+        const apemode::ValueId id( valueId );
+        return id.valueType == apemodefb::EValueTypeFb_String && id.valueIndex < s.stringValues.size( ) ? s.stringValues[ id.valueIndex ] : std::string( );
+    };
+
+    std::set< uint32_t > packedFileIds;
+    std::set< uint32_t > replacedTextureIds;
+    for ( auto& m : s.materials ) {
+        size_t   propIndices[ 3 ] = {size_t( -1 ), size_t( -1 ), size_t( -1 )};
+        uint32_t fileIds[ 3 ]     = {uint32_t( -1 ), uint32_t( -1 ), uint32_t( -1 )};
+        uint32_t channels[ 3 ]    = {0, 0, 0};
+        uint32_t mask             = 0;
+        uint32_t sourceCount      = 0;
+
+        for ( size_t i = 0; i < m.textureProperties.size( ); ++i ) {
+            const auto&    textureProp = m.textureProperties[ i ];
+            const uint32_t propMask    = GetOrmChannelMask( getString( textureProp.name_id( ) ) );
+            if ( 0 == propMask || ( mask & propMask ) || textureProp.value_id( ) >= s.textures.size( ) )
+                continue;
+
+            const uint32_t fileId = s.textures[ textureProp.value_id( ) ].file_id( );
+            if ( fileId >= s.embeddedFiles.size( ) || s.embeddedFiles[ fileId ].fullPath.empty( ) )
+                continue;
+
+            /* The single maps are grayscale and provide their red channel, the packed ones provide the channels as is. */
+            for ( uint32_t c = 0; c < 3; ++c ) {
+                if ( propMask & ( 1 << c ) ) {
+                    propIndices[ c ] = i;
+                    fileIds[ c ]     = fileId;
+                    channels[ c ]    = propMask == ( 1u << c ) ? 0 : c;
+                }
+            }
+
+            mask |= propMask;
+            ++sourceCount;
+        }
+
+        /* Nothing to merge, or the maps are the same (already packed) texture. */
+        std::set< uint32_t > sourceFileIds( std::begin( fileIds ), std::end( fileIds ) );
+        sourceFileIds.erase( uint32_t( -1 ) );
+        if ( sourceFileIds.size( ) < 2 )
+            continue;
+
+        const std::string materialName = getString( m.nameId );
+
+        std::vector< uint8_t >        fileBuffers[ 3 ];
+        const std::vector< uint8_t >* images[ 3 ] = {nullptr, nullptr, nullptr};
+
+        bool readFiles = true;
+        for ( uint32_t c = 0; c < 3 && readFiles; ++c ) {
+            if ( fileIds[ c ] == uint32_t( -1 ) )
+                continue;
+
+            /* The files shared by the channels are read once. */
+            uint32_t sharedChannel = 0;
+            while ( sharedChannel < c && fileIds[ sharedChannel ] != fileIds[ c ] )
+                ++sharedChannel;
+
+            if ( sharedChannel == c )
+                readFiles = AcquireSourceFile( s, fileIds[ c ], fileBuffers[ c ] );
+
+            images[ c ] = &fileBuffers[ sharedChannel ];
+        }
+
+        std::vector< uint8_t > packedImage;
+        std::string            errorMessage = "failed to read the files";
+        const bool packedMaps = readFiles && PackTextureChannels( images, channels, packedImage, errorMessage );
+
+        /* The maps can still be written (not packed, or referenced by the other materials). */
+        for ( uint32_t c = 0; c < 3; ++c ) {
+            if ( false == fileBuffers[ c ].empty( ) )
+                RestoreSourceFile( s, fileIds[ c ], fileBuffers[ c ] );
+        }
+
+        if ( false == packedMaps ) {
+            s.console->warn( "Material \"{}\": ORM maps are not packed ({})", materialName, errorMessage );
+            continue;
+        }
+
+        /* The packed texture inherits the sampling parameters from the first map. */
+        const size_t firstPropIndex = *std::min_element( std::begin( propIndices ), std::end( propIndices ) );
+        const std::string packedFileName = materialName + "_orm.png";
+
+        apemodefb::TextureFb packedTexture = s.textures[ m.textureProperties[ firstPropIndex ].value_id( ) ];
+        packedTexture.mutate_name_id( s.PushValue( packedFileName ) );
+        packedTexture.mutate_file_id( s.EmbedGeneratedFile( packedFileName, std::move( packedImage ), apemode::eTextureUsage_Data ) );
+        const uint32_t packedTextureId = s.PushValue( packedTexture );
+
+        packedFileIds.insert( sourceFileIds.begin( ), sourceFileIds.end( ) );
+
+        std::vector< apemodefb::MaterialPropFb > textureProperties;
+        for ( size_t i = 0; i < m.textureProperties.size( ); ++i ) {
+            if ( std::find( std::begin( propIndices ), std::end( propIndices ), i ) == std::end( propIndices ) )
+                textureProperties.push_back( m.textureProperties[ i ] );
+            else
+                replacedTextureIds.insert( m.textureProperties[ i ].value_id( ) );
+        }
+
+        textureProperties.emplace_back( s.PushValue( "occlusionRoughnessMetallicTexture" ), packedTextureId );
+        m.textureProperties.swap( textureProperties );
+
+        s.console->info( "Material \"{}\": packed {} maps into \"{}\"", materialName, sourceCount, packedFileName );
+    }
+
+    /* The maps can still be referenced by the other materials. */
+    for ( const auto& m : s.materials ) {
+        for ( const auto& textureProp : m.textureProperties ) {
+            replacedTextureIds.erase( textureProp.value_id( ) );
         }
     }
-}
\ No newline at end of file
+
+    /* The replaced textures are dropped, the ids of the others are compacted. */
+    if ( false == replacedTextureIds.empty( ) ) {
+        std::vector< uint32_t >             textureIds( s.textures.size( ), uint32_t( -1 ) );
+        std::vector< apemodefb::TextureFb > textures;
+        textures.reserve( s.textures.size( ) );
+
+        for ( uint32_t i = 0; i < s.textures.size( ); ++i ) {
+            if ( replacedTextureIds.find( i ) == replacedTextureIds.end( ) ) {
+                textureIds[ i ] = uint32_t( textures.size( ) );
+                textures.push_back( s.textures[ i ] );
+                textures.back( ).mutate_id( textureIds[ i ] );
+            }
+        }
+
+        for ( auto& m : s.materials ) {
+            for ( auto& textureProp : m.textureProperties ) {
+                if ( textureProp.value_id( ) < textureIds.size( ) )
+                    textureProp.mutate_value_id( textureIds[ textureProp.value_id( ) ] );
+            }
+        }
+
+        s.textures.swap( textures );
+        s.textureHashDict.clear( );
+    }
+
+    for ( const auto& texture : s.textures ) {
+        packedFileIds.erase( texture.file_id( ) );
+    }
+
+    for ( const uint32_t fileId : packedFileIds ) {
+        s.embeddedFiles[ fileId ].packed = true;
+    }
+}
+
+/**
+ * Packs the small material textures into the shared atlases (--atlas-max-size, --atlas-size).
+ * The meshes are not modified, the textures are redirected to the atlas tiles with their offset and scale
+ * (atlas uv = uv * scale + offset, v = 0 is the first row of the image) and clamped.
+ * Only the textures with the UV mapping and no transform, that are either clamped or sampled within [0, 1], are packed.
+ **/
+void PackTextureAtlases( apemode::State& s ) {
+    FBXP_PROFILE_SCOPE( "PackTextureAtlases" );
+
+    const uint32_t kAtlasGutter     = 8;
+    const float    kTexcoordEpsilon = 0.001f;
+
+    /* The materials of the meshes with the texcoords outside [0, 1] repeat their textures. */
+    std::set< uint32_t > repeatedMaterialIds;
+    for ( const auto& node : s.nodes ) {
+        if ( node.meshId >= s.meshes.size( ) || false == s.meshes[ node.meshId ].hasTexcoords )
+            continue;
+
+        const auto& mesh = s.meshes[ node.meshId ];
+        if ( mesh.texcoordMin.x( ) < -kTexcoordEpsilon || mesh.texcoordMin.y( ) < -kTexcoordEpsilon ||
+             mesh.texcoordMax.x( ) > 1 + kTexcoordEpsilon || mesh.texcoordMax.y( ) > 1 + kTexcoordEpsilon ) {
+            repeatedMaterialIds.insert( node.materialIds.begin( ), node.materialIds.end( ) );
+        }
+    }
+
+    /* The file is packed if all the textures referencing it can be redirected to the tile. */
+    std::map< uint32_t, std::set< uint32_t > > fileTextureIds;
+    std::set< uint32_t >                       rejectedFileIds;
+    for ( const auto& m : s.materials ) {
+        const bool repeated = repeatedMaterialIds.find( m.id ) != repeatedMaterialIds.end( );
+        for ( const auto& textureProp : m.textureProperties ) {
+            if ( textureProp.value_id( ) >= s.textures.size( ) )
+                continue;
+
+            const auto&    texture = s.textures[ textureProp.value_id( ) ];
+            const uint32_t fileId  = texture.file_id( );
+            if ( fileId >= s.embeddedFiles.size( ) )
+                continue;
+
+            const bool clamped = texture.wrap_mode_u( ) == apemodefb::EWrapModeFb_Clamp && texture.wrap_mode_v( ) == apemodefb::EWrapModeFb_Clamp;
+            const bool identity = texture.offset_u( ) == 0 && texture.offset_v( ) == 0 && texture.scale_u( ) == 1 && texture.scale_v( ) == 1 &&
+                                  texture.rotation_u( ) == 0 && texture.rotation_v( ) == 0 && texture.rotation_w( ) == 0 &&
+                                  false == texture.swap_uv( ) && texture.cropping_left( ) == 0 && texture.cropping_right( ) == 0 &&
+                                  texture.cropping_top( ) == 0 && texture.cropping_bottom( ) == 0;
+
+            if ( s.embeddedFiles[ fileId ].packed || texture.mapping_type( ) != apemodefb::EMappingTypeFb_UV || false == identity ||
+                 ( repeated && false == clamped ) ) {
+                rejectedFileIds.insert( fileId );
+            }
+
+            fileTextureIds[ fileId ].insert( textureProp.value_id( ) );
+        }
+    }
+
+    /* The atlases are built per usage, since the textures of the different usages are transcoded differently. */
+    std::map< apemode::ETextureUsage, std::vector< uint32_t > > usageFileIds;
+    for ( const auto& fileTextures : fileTextureIds ) {
+        if ( rejectedFileIds.find( fileTextures.first ) == rejectedFileIds.end( ) )
+            usageFileIds[ s.embeddedFiles[ fileTextures.first ].usage ].push_back( fileTextures.first );
+    }
+
+    const char* const kUsageNames[] = {"none", "color", "data", "normal"};
+
+    bool packedFiles = false;
+    for ( const auto& usageFiles : usageFileIds ) {
+        const auto& fileIds = usageFiles.second;
+        if ( fileIds.size( ) < 2 )
+            continue;
+
+        std::vector< std::vector< uint8_t > >        fileBuffers( fileIds.size( ) );
+        std::vector< const std::vector< uint8_t >* > images( fileIds.size( ) );
+        for ( size_t i = 0; i < fileIds.size( ); ++i ) {
+            const auto& file = s.embeddedFiles[ fileIds[ i ] ];
+            if ( file.fullPath.empty( ) ) {
+                images[ i ] = &file.generatedBuffer;
+            } else {
+                AcquireSourceFile( s, fileIds[ i ], fileBuffers[ i ] );
+                images[ i ] = &fileBuffers[ i ];
+            }
+        }
+
+        std::vector< std::vector< uint8_t > >    atlasImages;
+        std::vector< apemode::TextureAtlasTile > tiles;
+        BuildTextureAtlases( images, s.atlasMaxSize, s.atlasSize, kAtlasGutter, atlasImages, tiles );
+
+        std::vector< uint32_t >    atlasFileIds;
+        std::vector< std::string > atlasFileNames;
+        for ( size_t i = 0; i < atlasImages.size( ); ++i ) {
+            atlasFileNames.push_back( std::string( "atlas_" ) + kUsageNames[ usageFiles.first ] + "_" + std::to_string( i ) + ".png" );
+            atlasFileIds.push_back( s.EmbedGeneratedFile( atlasFileNames.back( ), std::move( atlasImages[ i ] ), usageFiles.first ) );
+        }
+
+        std::vector< uint32_t > atlasTileCounts( atlasFileIds.size( ), 0 );
+        for ( size_t i = 0; i < fileIds.size( ); ++i ) {
+            const auto& tile = tiles[ i ];
+            if ( tile.atlasIndex >= atlasFileIds.size( ) )
+                continue;
+
+            for ( const uint32_t textureId : fileTextureIds[ fileIds[ i ] ] ) {
+                auto& texture = s.textures[ textureId ];
+                texture.mutate_file_id( atlasFileIds[ tile.atlasIndex ] );
+                texture.mutate_offset_u( float( tile.x ) / float( tile.atlasWidth ) );
+                texture.mutate_offset_v( float( tile.y ) / float( tile.atlasHeight ) );
+                texture.mutate_scale_u( float( tile.width ) / float( tile.atlasWidth ) );
+                texture.mutate_scale_v( float( tile.height ) / float( tile.atlasHeight ) );
+                texture.mutate_wrap_mode_u( apemodefb::EWrapModeFb_Clamp );
+                texture.mutate_wrap_mode_v( apemodefb::EWrapModeFb_Clamp );
+            }
+
+            s.embeddedFiles[ fileIds[ i ] ].packed = true;
+            ++atlasTileCounts[ tile.atlasIndex ];
+            packedFiles = true;
+        }
+
+        /* The textures that did not fit are written as is, their files are not read again. */
+        for ( size_t i = 0; i < fileIds.size( ); ++i ) {
+            if ( false == s.embeddedFiles[ fileIds[ i ] ].packed && false == fileBuffers[ i ].empty( ) )
+                RestoreSourceFile( s, fileIds[ i ], fileBuffers[ i ] );
+        }
+
+        fileBuffers.clear( );
+
+        for ( size_t i = 0; i < atlasFileIds.size( ); ++i ) {
+            s.console->info( "Texture atlas \"{}\": packed {} textures", atlasFileNames[ i ], atlasTileCounts[ i ] );
+        }
+    }
+
+    /* The textures were modified, their lookup is rebuilt on the next push. */
+    if ( packedFiles ) {
+        s.textureHashDict.clear( );
+    }
+}
@@ -15,6 +15,7 @@
 #include <draco/mesh/triangle_soup_mesh_builder.h>
 #include <draco/compression/encode.h>
 #include <draco/compression/expert_encode.h>
+#include <draco/compression/decode.h>
 
 // #include <zstd.h>
 
@@ -259,10 +260,9 @@ void CalculateFaceNormals( StaticVertex* vertices, size_t vertexCount ) {
  * @param subsetPolies A mapping of material indices to polygon ranges (useful for knowing the basic structure).
  * @return True on success.
  **/
-bool GetSubsets( FbxMesh* pMeshFb, std::vector< apemodefb::SubsetFb >& subsetsFb ) {
+bool GetSubsets( apemode::State& s, FbxMesh* pMeshFb, std::vector< apemodefb::SubsetFb >& subsetsFb ) {
 
-    auto& s = apemode::State::Get( );
-    s.console->info("Mesh \"{}\" has {} material(s) assigned.", pMeshFb->GetNode( )->GetName( ), pMeshFb->GetNode( )->GetMaterialCount( ) );
+    s.console->debug("Mesh \"{}\" has {} material(s) assigned.", pMeshFb->GetNode( )->GetName( ), pMeshFb->GetNode( )->GetMaterialCount( ) );
 
     subsetsFb.clear( );
 
@@ -279,7 +279,7 @@ bool GetSubsets( FbxMesh* pMeshFb, std::vector< apemodefb::SubsetFb >& subsetsFb
 
     /* Print materials attached to a node. */
     for ( int k = 0; k < pMeshFb->GetNode( )->GetMaterialCount( ); ++k ) {
-        s.console->info( "\tMaterial #{} - \"{}\".", k, pMeshFb->GetNode( )->GetMaterial( k )->GetName( ) );
+        s.console->debug( "\tMaterial #{} - \"{}\".", k, pMeshFb->GetNode( )->GetMaterial( k )->GetName( ) );
     }
 
     struct MaterialMappingItem {
@@ -292,7 +292,7 @@ bool GetSubsets( FbxMesh* pMeshFb, std::vector< apemodefb::SubsetFb >& subsetsFb
 
     /* Go though all the material elements and map them. */
     if ( const uint32_t mc = (uint32_t) pMeshFb->GetElementMaterialCount( ) ) {
-        s.console->info( "Mesh \"{}\" has {} material elements.", pMeshFb->GetNode( )->GetName( ), mc );
+        s.console->debug( "Mesh \"{}\" has {} material elements.", pMeshFb->GetNode( )->GetName( ), mc );
 
         for ( uint32_t m = 0; m < mc; ++m ) {
             if ( const auto materialElement = pMeshFb->GetElementMaterial( m ) ) {
@@ -556,11 +556,11 @@ bool GetSubsets( FbxMesh* pMeshFb, std::vector< apemodefb::SubsetFb >& subsetsFb
         const apemodefb::SubsetFb subsetFb( range.materialIndex, range.polygonIndex * 3, polygonCount * 3 );
         subsetsFb.push_back( subsetFb );
 
-        s.console->info( "\t+ subset: material #{} -> base index {}, last index {} (index count {})",
-                         subsetFb.material_id( ),
-                         subsetFb.base_index( ),
-                         subsetFb.base_index( ) + subsetFb.index_count( ) - 1,
-                         subsetFb.index_count( ) );
+        s.console->debug( "\t+ subset: material #{} -> base index {}, last index {} (index count {})",
+                          subsetFb.material_id( ),
+                          subsetFb.base_index( ),
+                          subsetFb.base_index( ) + subsetFb.index_count( ) - 1,
+                          subsetFb.index_count( ) );
     }
 
     return true;
@@ -835,7 +835,7 @@ struct TControlPointSkinInfo {
     }
 
     template < EBoneCountPerControlPoint TBoneCount >
-    std::array< float, TBoneCount > Compile( ) {
+    std::array< float, TBoneCount > Compile( ) const {
         float totalWeight = float( 0 );
         for ( uint32_t i = 0; i < TBoneCount; ++i ) {
             AssertValidFloat( weights[ i ].weight );
@@ -899,16 +899,14 @@ struct VertexInitializationResult {
  * Initialize vertices with very basic properties like 'position', 'normal', 'tangent', 'texCoords'.
  * Calculate mesh position and texcoord min max values.
  **/
-VertexInitializationResult InitializeVertices( FbxMesh* mesh, apemode::Mesh& m, StaticVertex* vertices, size_t vertexCount ) {
-    auto& s = apemode::State::Get( );
-
+VertexInitializationResult InitializeVertices( apemode::State& s, FbxMesh* mesh, apemode::Mesh& m, StaticVertex* vertices, size_t vertexCount ) {
     VertexInitializationResult result;
 
     const uint32_t cc = (uint32_t) mesh->GetControlPointsCount( );
     const uint32_t pc = (uint32_t) mesh->GetPolygonCount( );
 
-    s.console->info( "Mesh \"{}\" has {} control points.", mesh->GetNode( )->GetName( ), cc );
-    s.console->info( "Mesh \"{}\" has {} polygons.", mesh->GetNode( )->GetName( ), pc );
+    s.console->debug( "Mesh \"{}\" has {} control points.", mesh->GetNode( )->GetName( ), cc );
+    s.console->debug( "Mesh \"{}\" has {} polygons.", mesh->GetNode( )->GetName( ), pc );
 
     mathfu::vec3 positionMin;
     mathfu::vec3 positionMax;
@@ -924,8 +922,8 @@ VertexInitializationResult InitializeVertices( FbxMesh* mesh, apemode::Mesh& m,
 
     texcoordMin.x = std::numeric_limits< float >::max( );
     texcoordMin.y = std::numeric_limits< float >::max( );
-    texcoordMax.x = std::numeric_limits< float >::min( );
-    texcoordMax.y = std::numeric_limits< float >::min( );
+    texcoordMax.x = std::numeric_limits< float >::lowest( );
+    texcoordMax.y = std::numeric_limits< float >::lowest( );
 
     const auto uve = VerifyElementLayer( mesh->GetElementUV( ) );
     auto       ne  = VerifyElementLayer( mesh->GetElementNormal( ) );
@@ -1016,6 +1014,7 @@ VertexInitializationResult InitializeVertices( FbxMesh* mesh, apemode::Mesh& m,
     m.positionMax = apemodefb::Vec3Fb( positionMax.x, positionMax.y, positionMax.z );
     m.texcoordMin = apemodefb::Vec2Fb( texcoordMin.x, texcoordMin.y );
     m.texcoordMax = apemodefb::Vec2Fb( texcoordMax.x, texcoordMax.y );
+    m.hasTexcoords = nullptr != uve && vi > 0;
 
     if ( nullptr == uve ) {
         s.console->error( "Mesh \"{}\" does not have texcoords geometry layer.",
@@ -1037,12 +1036,14 @@ VertexInitializationResult InitializeVertices( FbxMesh* mesh, apemode::Mesh& m,
                          mesh->GetNode( )->GetName( ) );
 
         // Calculate tangents ourselves if UVs are available.
+        FBXP_PROFILE_SCOPE( "CalculateTangents" );
         result.bValidTangents = CalculateTangents( vertices, vertexCount );
     } else if ( !te && !uve ) {
         s.console->warn( "Mesh \"{}\" does not have tangent and texcoords geometry layers.",
                          mesh->GetNode( )->GetName( ) );
 
         // Calculate tangents ourselves if UVs are available.
+        FBXP_PROFILE_SCOPE( "CalculateTangentsNoUVs" );
         result.bValidTangents = CalculateTangentsNoUVs( vertices, vertexCount );
     }
 
@@ -1196,6 +1197,18 @@ struct EncodingProfile {
     int jointWeightsQuantizationBits = 16;
 };
 
+/**
+ * The key of the Draco stage in the build cache.
+ * The encoder input is the unindexed decompressed vertex buffer (triangle soup).
+ **/
+uint64_t GetDracoStageKey( const apemode::Mesh& m, apemodefb::EVertexFormatFb eVertexFmt, const EncodingProfile& encodingProfile ) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    HashCombine( hash, &eVertexFmt, sizeof( eVertexFmt ) );
+    HashCombine( hash, &encodingProfile, sizeof( encodingProfile ) );
+    HashCombine( hash, m.vertices.data( ), m.vertices.size( ) );
+    return hash;
+}
+
 void ConfigureEncoder( draco::ExpertEncoder& encoder, EncodingVertexLayout a, EncodingProfile encodingProfile ) {
     encoder.SetAttributeQuantization( a.positionAttributeIndex, encodingProfile.positionQuantizationBits );
     encoder.SetAttributeQuantization( a.uvAttributeIndex, encodingProfile.uvQuantizationBits );
@@ -1237,185 +1250,57 @@ void ConfigureEncoder( draco::ExpertEncoder& encoder, EncodingVertexLayout a, En
 //     elapsedTime = sw.ElapsedSeconds();
 // }
 
-enum class EVertexOrder { CW, CCW };
-
-template < typename TIndex, EVertexOrder TOrder = EVertexOrder::CCW >
-void ExportMesh( FbxNode*       pNode,
-                 FbxMesh*       pMesh,
-                 apemode::Node& n,
-                 apemode::Mesh& m,
-                 uint32_t       vertexCount,
-                 bool           pack,
-                 FbxSkin*       pSkin,
-                 bool           optimize ) {
-    /* Packing is disabled for now. */
-    pack = false;
-
-    auto& s = apemode::State::Get( );
-
-    /* Fill indices. */
-
-    m.indices.resize( vertexCount * sizeof( TIndex ) );
-    TIndex* indices = (TIndex*) m.indices.data( );
+uint32_t EncodeMeshopt( const std::vector< uint8_t >&             vertices,
+                        const std::vector< uint8_t >&             indices,
+                        apemodefb::EIndexTypeFb                   indexType,
+                        const std::vector< apemodefb::SubsetFb >& subsets,
+                        uint32_t                                  vertexCount,
+                        size_t                                    stride,
+                        std::vector< uint8_t >&                   encodedVertices,
+                        std::vector< uint8_t >&                   encodedIndices );
+bool     DecodeMeshopt( void*                   vertices,
+                        uint32_t                vertexCount,
+                        size_t                  stride,
+                        const void*             encodedVertices,
+                        size_t                  encodedVerticesSize,
+                        void*                   indices,
+                        uint32_t                indexCount,
+                        apemodefb::EIndexTypeFb indexType,
+                        const void*             encodedIndices,
+                        size_t                  encodedIndicesSize );
+
+int  GetDefaultBlockCompressionLevel( apemodefb::ECompressionTypeFb compressionType );
+bool CompressBlock( apemodefb::ECompressionTypeFb compressionType, int level, const void* src, size_t srcSize, std::vector< uint8_t >& dst );
+bool DecompressBlock( apemodefb::ECompressionTypeFb compressionType, const void* src, size_t srcSize, void* dst, size_t dstSize );
 
-    if ( TOrder == EVertexOrder::CW ) {
-        for ( TIndex i = 0; i < vertexCount; i += 3 ) {
-            indices[ i + 0 ] = i + 0;
-            indices[ i + 1 ] = i + 2;
-            indices[ i + 2 ] = i + 1;
-        }
-    }
-    else {
-        for ( TIndex i = 0; i < vertexCount; i += 3 ) {
-            indices[ i + 0 ] = i + 0;
-            indices[ i + 1 ] = i + 1;
-            indices[ i + 2 ] = i + 2;
-        }
-    }
-
-    static_assert(std::is_same< TIndex, uint16_t >::value ||
-                  std::is_same< TIndex, uint32_t >::value,
-                  "Should be either uint16 or uint32");
-
-    // TODO: constexpr
-    if ( std::is_same< TIndex, uint16_t >::value ) {
-        m.indexType = apemodefb::EIndexTypeFb_UInt16;
-    } else {
-        const bool isUint32 = std::is_same< TIndex, uint32_t >::value;
-        assert( isUint32 && "Caught unexpected index type." );
-        m.indexType = apemodefb::EIndexTypeFb_UInt32;
-        (void)isUint32;
-    }
-
-    /* Fill subsets. */
-
-    GetSubsets( pMesh, m.subsets );
-    if ( m.subsets.empty( ) ) {
-        /* Independently from GetSubsets implementation make sure there is at least one subset. */
-        const uint32_t materialId = pMesh->GetNode( )->GetMaterialCount( ) > 0 ? 0 : uint32_t( -1 );
-        m.subsets.push_back( apemodefb::SubsetFb( materialId, 0, vertexCount ) );
-    }
-
-    std::vector< StaticVertex > vertices;
-    vertices.resize( vertexCount );
-    auto initResult = InitializeVertices( pMesh, m, vertices.data( ), vertexCount );
-    (void)initResult;
-
-    std::vector< mathfu::dquat > qtangents;
-    qtangents.resize( vertexCount );
-    for ( uint32_t i = 0; i < vertexCount; ++i ) {
-        mathfu::dvec3 n( vertices[ i ].normal );
-        mathfu::dvec3 t( vertices[ i ].tangent.xyz( ) );
-
-        if ( n.Length( ) < std::numeric_limits< float >::epsilon( ) ||
-             t.Length( ) < std::numeric_limits< float >::epsilon( ) ) {
-            qtangents[ i ] = mathfu::dquat::identity;
-            continue;
-        }
-
-        n.Normalize( );
-        t.Normalize( );
-
-        qtangents[ i ] = GetQTangent( n, t, vertices[ i ].tangent.w );
-    }
-
-    using ControlPointSkinInfo = TControlPointSkinInfo<>;
-
-    EBoneCountPerControlPoint           boneCount = EBoneCountPerControlPoint( 0 );
-    std::vector< ControlPointSkinInfo > skinInfos;
-
-    if ( pSkin ) {
-        /* Allocate skin info for each control point. */
-        /* Populate skin info for each control point. */
-
-        skinInfos.resize( pMesh->GetControlPointsCount( ) );
-
-        m.skinId = uint32_t( s.skins.size( ) );
-
-        s.skins.emplace_back( );
-        auto& skin  = s.skins.back( );
-        skin.nameId = s.PushValue( pSkin->GetName( ) );
-
-        const int clusterCount = pSkin->GetClusterCount( );
-        s.console->info( "\t Skin has {} clusters", clusterCount );
-
-        skin.linkIds.reserve( clusterCount );
-        for ( int i = 0; i < clusterCount; ++i ) {
-            assert( i < clusterCount );
-            const auto pCluster = pSkin->GetCluster( i );
-            assert( pCluster );
-
-            if ( const auto indexCount = pCluster->GetControlPointIndicesCount( ) ) {
-                assert( s.nodeDict.find( pCluster->GetLink( )->GetUniqueID( ) ) != s.nodeDict.end( ) );
-                const uint32_t linkNodeId = s.nodeDict[ pCluster->GetLink( )->GetUniqueID( ) ];
-
-                const double* pWeights = pCluster->GetControlPointWeights( );
-                const int* pIndices = pCluster->GetControlPointIndices( );
-
-                s.console->info( "\t Cluster #{} influences {} point(s)", i, indexCount );
-
-                uint32_t boneIndex = (uint32_t) skin.linkIds.size( );
-                skin.linkIds.push_back( linkNodeId );
-
-                for ( int j = 0; j < indexCount; ++j ) {
-                    /* Assign bone (weight + index) for the control point. */
-                    assert( pIndices[ j ] < pMesh->GetControlPointsCount( ) );
-                    skinInfos[ pIndices[ j ] ].AddBone( (float) pWeights[ j ], boneIndex );
-                }
-
-                FbxAMatrix bindPoseMatrix;
-                FbxAMatrix transformMatrix;
-                pCluster->GetTransformLinkMatrix( bindPoseMatrix );
-                pCluster->GetTransformMatrix( transformMatrix );
-                const FbxAMatrix geometricMatrix = GetGeometricTransformation( pMesh->GetNode( ) );
-                const FbxAMatrix invBindPoseMatrix = bindPoseMatrix.Inverse( ) * transformMatrix * geometricMatrix;
-                skin.invBindPoseMatrices.push_back( apemode::Cast( invBindPoseMatrix ) );
-
-                // TODO: Scaling can't be included into dual quaternions.
-                // const FbxVector4 S = invBindPoseMatrix.GetS();
-
-                const FbxQuaternion Q = invBindPoseMatrix.GetQ( );
-                const FbxVector4 T = invBindPoseMatrix.GetT( );
-
-                const FbxDualQuaternion DQ( Q, T );
-                skin.invBindPoseDualQuats.push_back( apemode::Cast( DQ ) );
-            }
-        }
-
-        /* Report about used bone slots. */
-        uint32_t maxBoneCount = 4;
-        boneCount = eBoneCountPerControlPoint_4;
-        {
-            std::map< uint32_t, uint32_t > boneCountToControlPointCountMap;
-            for ( uint32_t i = 0; i < skinInfos.size( ); ++i ) {
-                ++boneCountToControlPointCountMap[ skinInfos[ i ].GetUsedSlotCount( ) ];
-            }
-
-            s.console->info( "Used slots:" );
-            for ( auto& p : boneCountToControlPointCountMap ) {
-                s.console->info( "\t {} slots <- {} points ", p.first, p.second );
-            }
-
-            maxBoneCount = std::max( boneCountToControlPointCountMap.rbegin( )->first, maxBoneCount );
-            s.console->info( "\t max bones <- {}", maxBoneCount );
-        }
-
-
-        if ( maxBoneCount > eBoneCountPerControlPoint_4 ) {
-            boneCount = eBoneCountPerControlPoint_8;
-        }
-
-        /* Normalize bone weights for each control point. */
-        for ( auto& skinInfo : skinInfos ) {
-            skinInfo.NormalizeWeights( maxBoneCount, 0 );
-        }
-    }
-
-    apemodefb::EVertexFormatFb eVertexFmt = apemodefb::EVertexFormatFb(-1);
+enum class EVertexOrder { CW, CCW };
 
-    apemodefb::ECompressionTypeFb eCompressionType = apemodefb::ECompressionTypeFb_None;
-    const std::string& meshCompression = s.options[ "mesh-compression" ].as< std::string >( );
-    if ( m.subsets.size( ) == 1 && s.options[ "mesh-compression" ].count() && meshCompression != "none" ) {
+/**
+ * Fills the vertex buffer in the format of the mesh compression method (none, draco, meshopt) and encodes it.
+ * The indices are expected to be filled, Draco drops them, meshopt reorders and encodes them.
+ **/
+template < typename TIndex >
+void EncodeMesh( apemode::State&                                s,
+                 FbxNode*                                       pNode,
+                 apemode::Mesh&                                 m,
+                 apemode::MeshReport&                           meshReport,
+                 const std::string&                             meshCompression,
+                 const EncodingProfile&                         encodingProfile,
+                 uint32_t                                       vertexCount,
+                 const std::vector< StaticVertex >&             vertices,
+                 const std::vector< mathfu::dquat >&            qtangents,
+                 const std::vector< TControlPointSkinInfo< > >& skinInfos,
+                 EBoneCountPerControlPoint                      boneCount,
+                 apemodefb::EVertexFormatFb&                    eVertexFmt,
+                 apemodefb::ECompressionTypeFb&                 eCompressionType,
+                 uint32_t&                                      submeshVertexCount,
+                 uint32_t&                                      submeshIndexCount ) {
+    eVertexFmt         = apemodefb::EVertexFormatFb( -1 );
+    eCompressionType   = apemodefb::ECompressionTypeFb_None;
+    submeshVertexCount = vertexCount;
+    submeshIndexCount  = 0;
+
+    if ( m.subsets.size( ) == 1 && meshCompression != "none" && meshCompression != "meshopt" ) {
         size_t stride = 0;
         size_t strideUnskinned = 0;
 
@@ -1558,195 +1443,211 @@ void ExportMesh( FbxNode*       pNode,
             }
         }
 
-        draco::TriangleSoupMeshBuilder builder;
-        assert( vertexCount % 3 == 0 );
-        builder.Start( vertexCount / 3 );
+        /* Reuse the encoded buffer if the same vertices were encoded with the same format and quantization. */
+        const uint64_t dracoStageKey = s.cache.StagesEnabled( ) ? GetDracoStageKey( m, eVertexFmt, encodingProfile ) : 0;
+        const size_t   originalSize  = m.vertices.size( ) + m.indices.size( );
+
+        if ( s.cache.LoadStage( "draco", dracoStageKey, m.vertices ) ) {
+            s.console->debug( "Draco: Cache hit ({} -> {})", ToPrettySizeString( originalSize ), ToPrettySizeString( m.vertices.size( ) ) );
+
+            meshReport.uncompressedSize = originalSize;
+            eCompressionType = apemodefb::ECompressionTypeFb_GoogleDraco3D;
+            decltype( m.indices )( ).swap( m.indices );
+        } else {
+            draco::TriangleSoupMeshBuilder builder;
+            assert( vertexCount % 3 == 0 );
+            builder.Start( vertexCount / 3 );
         
-        EncodingVertexLayout mapping;
-
-        mapping.positionAttributeIndex = builder.AddAttribute( draco::GeometryAttribute::Type::POSITION, 3, draco::DataType::DT_FLOAT32 );
-        mapping.uvAttributeIndex = builder.AddAttribute( draco::GeometryAttribute::Type::TEX_COORD, 2, draco::DataType::DT_FLOAT32 );
-        mapping.normalAttributeIndex = builder.AddAttribute( draco::GeometryAttribute::Type::NORMAL, 3, draco::DataType::DT_FLOAT32 );
-        mapping.tangentAttributeIndex = builder.AddAttribute( draco::GeometryAttribute::Type::NORMAL, 3, draco::DataType::DT_FLOAT32 );
-        mapping.colorAttributeIndex = builder.AddAttribute( draco::GeometryAttribute::Type::COLOR, 4, draco::DataType::DT_FLOAT32 );
-        mapping.reflectionAttributeIndex = builder.AddAttribute( draco::GeometryAttribute::Type::GENERIC, 1, draco::DataType::DT_UINT8 );
+            EncodingVertexLayout mapping;
+
+            mapping.positionAttributeIndex = builder.AddAttribute( draco::GeometryAttribute::Type::POSITION, 3, draco::DataType::DT_FLOAT32 );
+            mapping.uvAttributeIndex = builder.AddAttribute( draco::GeometryAttribute::Type::TEX_COORD, 2, draco::DataType::DT_FLOAT32 );
+            mapping.normalAttributeIndex = builder.AddAttribute( draco::GeometryAttribute::Type::NORMAL, 3, draco::DataType::DT_FLOAT32 );
+            mapping.tangentAttributeIndex = builder.AddAttribute( draco::GeometryAttribute::Type::NORMAL, 3, draco::DataType::DT_FLOAT32 );
+            mapping.colorAttributeIndex = builder.AddAttribute( draco::GeometryAttribute::Type::COLOR, 4, draco::DataType::DT_FLOAT32 );
+            mapping.reflectionAttributeIndex = builder.AddAttribute( draco::GeometryAttribute::Type::GENERIC, 1, draco::DataType::DT_UINT8 );
         
-        auto jointIndicesType = draco::GeometryAttribute::Type::GENERIC;
-        auto jointIndicesComponentCount = 4;
-        auto jointIndicesDataType = draco::DT_UINT8;
+            auto jointIndicesType = draco::GeometryAttribute::Type::GENERIC;
+            auto jointIndicesComponentCount = 4;
+            auto jointIndicesDataType = draco::DT_UINT8;
 
-        auto jointWeightsType = draco::GeometryAttribute::Type::COLOR;
-        auto jointWeightsComponentCount = 4;
-        auto jointWeightsDataType = draco::DT_FLOAT32;
+            auto jointWeightsType = draco::GeometryAttribute::Type::COLOR;
+            auto jointWeightsComponentCount = 4;
+            auto jointWeightsDataType = draco::DT_FLOAT32;
         
-        EncodingProfile encodingProfile{};
-
-        switch ( eVertexFmt ) {
-        case apemodefb::EVertexFormatFb_Decompressed:
-            break;
-        case apemodefb::EVertexFormatFb_DecompressedSkinned:
-            mapping.jointIndicesAttributeIndex = builder.AddAttribute( jointIndicesType, jointIndicesComponentCount, jointIndicesDataType );
-            mapping.jointWeightsAttributeIndex = builder.AddAttribute( jointWeightsType, jointWeightsComponentCount, jointWeightsDataType );
-            break;
-        case apemodefb::EVertexFormatFb_DecompressedFatSkinned:
-            mapping.jointIndicesAttributeIndex = builder.AddAttribute( jointIndicesType, jointIndicesComponentCount, jointIndicesDataType );
-            mapping.jointWeightsAttributeIndex = builder.AddAttribute( jointWeightsType, jointWeightsComponentCount, jointWeightsDataType );
-            mapping.extraJointIndicesAttributeIndex = builder.AddAttribute( jointIndicesType, jointIndicesComponentCount, jointIndicesDataType );
-            mapping.extraJointWeightsAttributeIndex = builder.AddAttribute( jointWeightsType, jointWeightsComponentCount, jointWeightsDataType );
-            break;
-        default:
-            assert(false);
-            break;
-        }
-
-        for ( uint32_t i = 0; i < vertexCount; i += 3 ) {
-            const draco::FaceIndex faceIndex = draco::FaceIndex( i / 3 );
-            apemodefb::DecompressedVertexFb* dst[3] = { reinterpret_cast< apemodefb::DecompressedVertexFb* >( m.vertices.data( ) + stride * ( i + 0 ) )
-                                                      , reinterpret_cast< apemodefb::DecompressedVertexFb* >( m.vertices.data( ) + stride * ( i + 1 ) )
-                                                      , reinterpret_cast< apemodefb::DecompressedVertexFb* >( m.vertices.data( ) + stride * ( i + 2 ) ) };
-
-
-            builder.SetAttributeValuesForFace( mapping.positionAttributeIndex,
-                                               faceIndex,
-                                               reinterpret_cast< const float* >( &dst[ 0 ]->position( ) ),
-                                               reinterpret_cast< const float* >( &dst[ 1 ]->position( ) ),
-                                               reinterpret_cast< const float* >( &dst[ 2 ]->position( ) ) );
-            builder.SetAttributeValuesForFace( mapping.uvAttributeIndex,
-                                               faceIndex,
-                                               reinterpret_cast< const float* >( &dst[ 0 ]->uv( ) ),
-                                               reinterpret_cast< const float* >( &dst[ 1 ]->uv( ) ),
-                                               reinterpret_cast< const float* >( &dst[ 2 ]->uv( ) ) );
-            
-            builder.SetAttributeValuesForFace( mapping.normalAttributeIndex,
-                                               faceIndex,
-                                               reinterpret_cast< const float* >( &dst[ 0 ]->normal( ) ),
-                                               reinterpret_cast< const float* >( &dst[ 1 ]->normal( ) ),
-                                               reinterpret_cast< const float* >( &dst[ 2 ]->normal( ) ) );
-            builder.SetAttributeValuesForFace( mapping.tangentAttributeIndex,
-                                               faceIndex,
-                                               reinterpret_cast< const float* >( &dst[ 0 ]->tangent( ) ),
-                                               reinterpret_cast< const float* >( &dst[ 1 ]->tangent( ) ),
-                                               reinterpret_cast< const float* >( &dst[ 2 ]->tangent( ) ) );
-            
-            builder.SetAttributeValuesForFace( mapping.colorAttributeIndex,
-                                               faceIndex,
-                                               reinterpret_cast< const float* >( &dst[ 0 ]->color( ) ),
-                                               reinterpret_cast< const float* >( &dst[ 1 ]->color( ) ),
-                                               reinterpret_cast< const float* >( &dst[ 2 ]->color( ) ) );
-
-            const uint8_t r0 = uint8_t( dst[ 0 ]->reflection_index_packed( ) );
-            const uint8_t r1 = uint8_t( dst[ 1 ]->reflection_index_packed( ) );
-            const uint8_t r2 = uint8_t( dst[ 2 ]->reflection_index_packed( ) );
-            builder.SetAttributeValuesForFace( mapping.reflectionAttributeIndex,
-                                               faceIndex,
-                                               reinterpret_cast< const float* >( &r0 ),
-                                               reinterpret_cast< const float* >( &r1 ),
-                                               reinterpret_cast< const float* >( &r2 ) );
-
             switch ( eVertexFmt ) {
             case apemodefb::EVertexFormatFb_Decompressed:
                 break;
-            case apemodefb::EVertexFormatFb_DecompressedSkinned: {
-                apemodefb::DecompressedSkinnedVertexFb* skinnedDst[3] =
-                { reinterpret_cast< apemodefb::DecompressedSkinnedVertexFb* >( dst[ 0 ] ),
-                  reinterpret_cast< apemodefb::DecompressedSkinnedVertexFb* >( dst[ 1 ] ),
-                  reinterpret_cast< apemodefb::DecompressedSkinnedVertexFb* >( dst[ 2 ] ) };
+            case apemodefb::EVertexFormatFb_DecompressedSkinned:
+                mapping.jointIndicesAttributeIndex = builder.AddAttribute( jointIndicesType, jointIndicesComponentCount, jointIndicesDataType );
+                mapping.jointWeightsAttributeIndex = builder.AddAttribute( jointWeightsType, jointWeightsComponentCount, jointWeightsDataType );
+                break;
+            case apemodefb::EVertexFormatFb_DecompressedFatSkinned:
+                mapping.jointIndicesAttributeIndex = builder.AddAttribute( jointIndicesType, jointIndicesComponentCount, jointIndicesDataType );
+                mapping.jointWeightsAttributeIndex = builder.AddAttribute( jointWeightsType, jointWeightsComponentCount, jointWeightsDataType );
+                mapping.extraJointIndicesAttributeIndex = builder.AddAttribute( jointIndicesType, jointIndicesComponentCount, jointIndicesDataType );
+                mapping.extraJointWeightsAttributeIndex = builder.AddAttribute( jointWeightsType, jointWeightsComponentCount, jointWeightsDataType );
+                break;
+            default:
+                assert(false);
+                break;
+            }
+
+            for ( uint32_t i = 0; i < vertexCount; i += 3 ) {
+                const draco::FaceIndex faceIndex = draco::FaceIndex( i / 3 );
+                apemodefb::DecompressedVertexFb* dst[3] = { reinterpret_cast< apemodefb::DecompressedVertexFb* >( m.vertices.data( ) + stride * ( i + 0 ) )
+                                                          , reinterpret_cast< apemodefb::DecompressedVertexFb* >( m.vertices.data( ) + stride * ( i + 1 ) )
+                                                          , reinterpret_cast< apemodefb::DecompressedVertexFb* >( m.vertices.data( ) + stride * ( i + 2 ) ) };
 
-                const auto j0 = skinnedDst[ 0 ]->joint_indices( );
-                const auto j1 = skinnedDst[ 1 ]->joint_indices( );
-                const auto j2 = skinnedDst[ 2 ]->joint_indices( );
 
-                builder.SetAttributeValuesForFace( mapping.jointIndicesAttributeIndex,
+                builder.SetAttributeValuesForFace( mapping.positionAttributeIndex,
                                                    faceIndex,
-                                                   reinterpret_cast< const float* >( &j0 ),
-                                                   reinterpret_cast< const float* >( &j1 ),
-                                                   reinterpret_cast< const float* >( &j2 ) );
-                builder.SetAttributeValuesForFace( mapping.jointWeightsAttributeIndex,
+                                                   reinterpret_cast< const float* >( &dst[ 0 ]->position( ) ),
+                                                   reinterpret_cast< const float* >( &dst[ 1 ]->position( ) ),
+                                                   reinterpret_cast< const float* >( &dst[ 2 ]->position( ) ) );
+                builder.SetAttributeValuesForFace( mapping.uvAttributeIndex,
                                                    faceIndex,
-                                                   reinterpret_cast< const float* >( &skinnedDst[ 0 ]->joint_weights( ) ),
-                                                   reinterpret_cast< const float* >( &skinnedDst[ 1 ]->joint_weights( ) ),
-                                                   reinterpret_cast< const float* >( &skinnedDst[ 2 ]->joint_weights( ) ) );
-            } break;
-            case apemodefb::EVertexFormatFb_DecompressedFatSkinned: {
-                apemodefb::DecompressedFatSkinnedVertexFb* skinnedDst[3] =
-                { reinterpret_cast< apemodefb::DecompressedFatSkinnedVertexFb* >( dst[ 0 ] ),
-                  reinterpret_cast< apemodefb::DecompressedFatSkinnedVertexFb* >( dst[ 1 ] ),
-                  reinterpret_cast< apemodefb::DecompressedFatSkinnedVertexFb* >( dst[ 2 ] ) };
-
-                const auto j0 = skinnedDst[ 0 ]->decompressed_skinned( ).joint_indices( );
-                const auto j1 = skinnedDst[ 1 ]->decompressed_skinned( ).joint_indices( );
-                const auto j2 = skinnedDst[ 2 ]->decompressed_skinned( ).joint_indices( );
-
-                builder.SetAttributeValuesForFace( mapping.jointIndicesAttributeIndex,
+                                                   reinterpret_cast< const float* >( &dst[ 0 ]->uv( ) ),
+                                                   reinterpret_cast< const float* >( &dst[ 1 ]->uv( ) ),
+                                                   reinterpret_cast< const float* >( &dst[ 2 ]->uv( ) ) );
+            
+                builder.SetAttributeValuesForFace( mapping.normalAttributeIndex,
                                                    faceIndex,
-                                                   reinterpret_cast< const float* >( &j0 ),
-                                                   reinterpret_cast< const float* >( &j1 ),
-                                                   reinterpret_cast< const float* >( &j2 ) );
-
-                builder.SetAttributeValuesForFace( mapping.jointWeightsAttributeIndex,
+                                                   reinterpret_cast< const float* >( &dst[ 0 ]->normal( ) ),
+                                                   reinterpret_cast< const float* >( &dst[ 1 ]->normal( ) ),
+                                                   reinterpret_cast< const float* >( &dst[ 2 ]->normal( ) ) );
+                builder.SetAttributeValuesForFace( mapping.tangentAttributeIndex,
                                                    faceIndex,
-                                                   reinterpret_cast< const float* >( &skinnedDst[ 0 ]->decompressed_skinned( ).joint_weights( ) ),
-                                                   reinterpret_cast< const float* >( &skinnedDst[ 1 ]->decompressed_skinned( ).joint_weights( ) ),
-                                                   reinterpret_cast< const float* >( &skinnedDst[ 2 ]->decompressed_skinned( ).joint_weights( ) ) );
-
-                const auto ej0 = skinnedDst[ 0 ]->extra_joint_indices( );
-                const auto ej1 = skinnedDst[ 1 ]->extra_joint_indices( );
-                const auto ej2 = skinnedDst[ 2 ]->extra_joint_indices( );
-
-                builder.SetAttributeValuesForFace( mapping.extraJointIndicesAttributeIndex,
+                                                   reinterpret_cast< const float* >( &dst[ 0 ]->tangent( ) ),
+                                                   reinterpret_cast< const float* >( &dst[ 1 ]->tangent( ) ),
+                                                   reinterpret_cast< const float* >( &dst[ 2 ]->tangent( ) ) );
+            
+                builder.SetAttributeValuesForFace( mapping.colorAttributeIndex,
                                                    faceIndex,
-                                                   reinterpret_cast< const float* >( &ej0 ),
-                                                   reinterpret_cast< const float* >( &ej1 ),
-                                                   reinterpret_cast< const float* >( &ej2 ) );
-                builder.SetAttributeValuesForFace( mapping.extraJointWeightsAttributeIndex,
+                                                   reinterpret_cast< const float* >( &dst[ 0 ]->color( ) ),
+                                                   reinterpret_cast< const float* >( &dst[ 1 ]->color( ) ),
+                                                   reinterpret_cast< const float* >( &dst[ 2 ]->color( ) ) );
+
+                const uint8_t r0 = uint8_t( dst[ 0 ]->reflection_index_packed( ) );
+                const uint8_t r1 = uint8_t( dst[ 1 ]->reflection_index_packed( ) );
+                const uint8_t r2 = uint8_t( dst[ 2 ]->reflection_index_packed( ) );
+                builder.SetAttributeValuesForFace( mapping.reflectionAttributeIndex,
                                                    faceIndex,
-                                                   reinterpret_cast< const float* >( &skinnedDst[ 0 ]->extra_joint_weights( ) ),
-                                                   reinterpret_cast< const float* >( &skinnedDst[ 1 ]->extra_joint_weights( ) ),
-                                                   reinterpret_cast< const float* >( &skinnedDst[ 2 ]->extra_joint_weights( ) ) );
-            } break;
-            default:
-                assert(false);
-                break;
+                                                   reinterpret_cast< const float* >( &r0 ),
+                                                   reinterpret_cast< const float* >( &r1 ),
+                                                   reinterpret_cast< const float* >( &r2 ) );
+
+                switch ( eVertexFmt ) {
+                case apemodefb::EVertexFormatFb_Decompressed:
+                    break;
+                case apemodefb::EVertexFormatFb_DecompressedSkinned: {
+                    apemodefb::DecompressedSkinnedVertexFb* skinnedDst[3] =
+                    { reinterpret_cast< apemodefb::DecompressedSkinnedVertexFb* >( dst[ 0 ] ),
+                      reinterpret_cast< apemodefb::DecompressedSkinnedVertexFb* >( dst[ 1 ] ),
+                      reinterpret_cast< apemodefb::DecompressedSkinnedVertexFb* >( dst[ 2 ] ) };
+
+                    const auto j0 = skinnedDst[ 0 ]->joint_indices( );
+                    const auto j1 = skinnedDst[ 1 ]->joint_indices( );
+                    const auto j2 = skinnedDst[ 2 ]->joint_indices( );
+
+                    builder.SetAttributeValuesForFace( mapping.jointIndicesAttributeIndex,
+                                                       faceIndex,
+                                                       reinterpret_cast< const float* >( &j0 ),
+                                                       reinterpret_cast< const float* >( &j1 ),
+                                                       reinterpret_cast< const float* >( &j2 ) );
+                    builder.SetAttributeValuesForFace( mapping.jointWeightsAttributeIndex,
+                                                       faceIndex,
+                                                       reinterpret_cast< const float* >( &skinnedDst[ 0 ]->joint_weights( ) ),
+                                                       reinterpret_cast< const float* >( &skinnedDst[ 1 ]->joint_weights( ) ),
+                                                       reinterpret_cast< const float* >( &skinnedDst[ 2 ]->joint_weights( ) ) );
+                } break;
+                case apemodefb::EVertexFormatFb_DecompressedFatSkinned: {
+                    apemodefb::DecompressedFatSkinnedVertexFb* skinnedDst[3] =
+                    { reinterpret_cast< apemodefb::DecompressedFatSkinnedVertexFb* >( dst[ 0 ] ),
+                      reinterpret_cast< apemodefb::DecompressedFatSkinnedVertexFb* >( dst[ 1 ] ),
+                      reinterpret_cast< apemodefb::DecompressedFatSkinnedVertexFb* >( dst[ 2 ] ) };
+
+                    const auto j0 = skinnedDst[ 0 ]->decompressed_skinned( ).joint_indices( );
+                    const auto j1 = skinnedDst[ 1 ]->decompressed_skinned( ).joint_indices( );
+                    const auto j2 = skinnedDst[ 2 ]->decompressed_skinned( ).joint_indices( );
+
+                    builder.SetAttributeValuesForFace( mapping.jointIndicesAttributeIndex,
+                                                       faceIndex,
+                                                       reinterpret_cast< const float* >( &j0 ),
+                                                       reinterpret_cast< const float* >( &j1 ),
+                                                       reinterpret_cast< const float* >( &j2 ) );
+
+                    builder.SetAttributeValuesForFace( mapping.jointWeightsAttributeIndex,
+                                                       faceIndex,
+                                                       reinterpret_cast< const float* >( &skinnedDst[ 0 ]->decompressed_skinned( ).joint_weights( ) ),
+                                                       reinterpret_cast< const float* >( &skinnedDst[ 1 ]->decompressed_skinned( ).joint_weights( ) ),
+                                                       reinterpret_cast< const float* >( &skinnedDst[ 2 ]->decompressed_skinned( ).joint_weights( ) ) );
+
+                    const auto ej0 = skinnedDst[ 0 ]->extra_joint_indices( );
+                    const auto ej1 = skinnedDst[ 1 ]->extra_joint_indices( );
+                    const auto ej2 = skinnedDst[ 2 ]->extra_joint_indices( );
+
+                    builder.SetAttributeValuesForFace( mapping.extraJointIndicesAttributeIndex,
+                                                       faceIndex,
+                                                       reinterpret_cast< const float* >( &ej0 ),
+                                                       reinterpret_cast< const float* >( &ej1 ),
+                                                       reinterpret_cast< const float* >( &ej2 ) );
+                    builder.SetAttributeValuesForFace( mapping.extraJointWeightsAttributeIndex,
+                                                       faceIndex,
+                                                       reinterpret_cast< const float* >( &skinnedDst[ 0 ]->extra_joint_weights( ) ),
+                                                       reinterpret_cast< const float* >( &skinnedDst[ 1 ]->extra_joint_weights( ) ),
+                                                       reinterpret_cast< const float* >( &skinnedDst[ 2 ]->extra_joint_weights( ) ) );
+                } break;
+                default:
+                    assert(false);
+                    break;
+                }
             }
-        }
 
-        s.console->info( "Starting draco mesh finalization ..." );
-        if ( auto finalizedMesh = builder.Finalize( ) ) {
-            s.console->info( "Draco mesh finalization succeeded." );
-            s.console->info( "Starting draco encoding ..." );
+            FBXP_PROFILE_SCOPE( "Draco" );
 
-            const size_t originalSize = m.vertices.size( ) + m.indices.size( );
+            s.console->debug( "Starting draco mesh finalization ..." );
+            if ( auto finalizedMesh = builder.Finalize( ) ) {
+                s.console->debug( "Draco mesh finalization succeeded." );
+                s.console->debug( "Starting draco encoding ..." );
+
+                apemode::Stopwatch encoderStopwatch;
 
-            draco::EncoderBuffer encoderBuffer{};
-            draco::Status        encoderStatus;
+                draco::EncoderBuffer encoderBuffer{};
+                draco::Status        encoderStatus;
 
-            draco::ExpertEncoder encoder( *finalizedMesh.get( ) );
-            encoder.Reset( draco::ExpertEncoder::OptionsType::CreateDefaultOptions( ) );
-            encoder.SetEncodingMethod( draco::MESH_EDGEBREAKER_ENCODING );
-            encoder.SetSpeedOptions( -1, -1 );
+                draco::ExpertEncoder encoder( *finalizedMesh.get( ) );
+                encoder.Reset( draco::ExpertEncoder::OptionsType::CreateDefaultOptions( ) );
+                encoder.SetEncodingMethod( draco::MESH_EDGEBREAKER_ENCODING );
+                encoder.SetSpeedOptions( -1, -1 );
 
-            ConfigureEncoder( encoder, mapping, encodingProfile );
+                ConfigureEncoder( encoder, mapping, encodingProfile );
             
-            encoderStatus = encoder.EncodeToBuffer( &encoderBuffer );
-            if ( encoderStatus.code( ) == draco::Status::OK ) {
-                const size_t edgebreakerSize = encoderBuffer.size();
-
-                s.console->info( "Edgebreaker: ({} -> {}), compression: {}x, vertices: {}, format: {}",
-                                 ToPrettySizeString( originalSize ),
-                                 ToPrettySizeString( edgebreakerSize ),
-                                 1.0f * originalSize / edgebreakerSize,
-                                 vertexCount,
-                                 apemodefb::EnumNameEVertexFormatFb( eVertexFmt ) );
-
-                eCompressionType = apemodefb::ECompressionTypeFb_GoogleDraco3D;
-                m.vertices.resize( encoderBuffer.size( ) );
-                memcpy( m.vertices.data( ), encoderBuffer.data( ), encoderBuffer.size( ) );
-                decltype( m.indices )( ).swap( m.indices );
+                encoderStatus = encoder.EncodeToBuffer( &encoderBuffer );
+                if ( encoderStatus.code( ) == draco::Status::OK ) {
+                    const size_t edgebreakerSize = encoderBuffer.size();
+
+                    meshReport.uncompressedSize = originalSize;
+                    meshReport.encodeSeconds    = encoderStopwatch.ElapsedSeconds( );
+
+                    s.console->debug( "Edgebreaker: ({} -> {}), compression: {}x, vertices: {}, format: {}",
+                                      ToPrettySizeString( originalSize ),
+                                      ToPrettySizeString( edgebreakerSize ),
+                                      1.0f * originalSize / edgebreakerSize,
+                                      vertexCount,
+                                      apemodefb::EnumNameEVertexFormatFb( eVertexFmt ) );
+
+                    eCompressionType = apemodefb::ECompressionTypeFb_GoogleDraco3D;
+                    m.vertices.resize( encoderBuffer.size( ) );
+                    memcpy( m.vertices.data( ), encoderBuffer.data( ), encoderBuffer.size( ) );
+                    decltype( m.indices )( ).swap( m.indices );
+                    s.cache.StoreStage( "draco", dracoStageKey, m.vertices );
                 
-            } else {
-                s.console->info( "Failed: code = {}, error = {}", int( encoderStatus.code( ) ), encoderStatus.error_msg( ) );
-                assert( false );
-                exit( -1 );
+                } else {
+                    s.console->info( "Failed: code = {}, error = {}", int( encoderStatus.code( ) ), encoderStatus.error_msg( ) );
+                    assert( false );
+                    exit( -1 );
+                }
             }
         }
     } else {
@@ -1845,6 +1746,521 @@ void ExportMesh( FbxNode*       pNode,
                 }
             }
         }
+
+        if ( meshCompression == "meshopt" ) {
+            FBXP_PROFILE_SCOPE( "Meshopt" );
+
+            apemode::Stopwatch encoderStopwatch;
+            const size_t originalSize = m.vertices.size( ) + m.indices.size( );
+
+            std::vector< uint8_t > encodedVertices;
+            std::vector< uint8_t > encodedIndices;
+            if ( const uint32_t encodedVertexCount = EncodeMeshopt( m.vertices, m.indices, m.indexType, m.subsets, vertexCount, stride, encodedVertices, encodedIndices ) ) {
+                const double encodeSeconds = encoderStopwatch.ElapsedSeconds( );
+
+                /* Decode the streams right away to validate them and to report the decoding speed. */
+                std::vector< uint8_t > decodedVertices( encodedVertexCount * stride );
+                std::vector< uint8_t > decodedIndices( vertexCount * sizeof( TIndex ) );
+
+                apemode::Stopwatch decoderStopwatch;
+                if ( DecodeMeshopt( decodedVertices.data( ), encodedVertexCount, stride, encodedVertices.data( ), encodedVertices.size( ),
+                                    decodedIndices.data( ), vertexCount, m.indexType, encodedIndices.data( ), encodedIndices.size( ) ) ) {
+                    meshReport.uncompressedSize = originalSize;
+                    meshReport.encodeSeconds    = encodeSeconds;
+                    meshReport.decodeSeconds    = decoderStopwatch.ElapsedSeconds( );
+
+                    const size_t encodedSize = encodedVertices.size( ) + encodedIndices.size( );
+                    const size_t decodedSize = decodedVertices.size( ) + decodedIndices.size( );
+                    s.console->debug( "Meshopt: ({} -> {}), compression: {}x, vertices: {} -> {}, decoding: {} MB/s",
+                                      ToPrettySizeString( originalSize ),
+                                      ToPrettySizeString( encodedSize ),
+                                      1.0f * originalSize / encodedSize,
+                                      vertexCount,
+                                      encodedVertexCount,
+                                      meshReport.decodeSeconds > 0 ? decodedSize / ( meshReport.decodeSeconds * 1024 * 1024 ) : 0.0 );
+
+                    m.vertices.swap( encodedVertices );
+                    m.indices.swap( encodedIndices );
+
+                    /* The decoder needs the index count, the vertex count is the welded one. */
+                    eCompressionType   = apemodefb::ECompressionTypeFb_Meshopt;
+                    submeshVertexCount = encodedVertexCount;
+                    submeshIndexCount  = vertexCount;
+
+                    m.hasBlockCompression   = true;
+                    m.blockCompressionType  = s.meshoptBlockCompressionType;
+                    m.blockCompressionLevel = s.meshoptBlockCompressionLevel;
+                } else {
+                    s.console->warn( "Mesh \"{}\" meshopt streams failed to decode, stored uncompressed.", pNode->GetName( ) );
+                }
+            } else {
+                s.console->warn( "Mesh \"{}\" cannot be encoded with meshopt (stride {}), stored uncompressed.", pNode->GetName( ), stride );
+            }
+        }
+    }
+}
+
+/* Decoding is timed on the build machine, the fastest run is taken to filter out the noise. */
+template < typename TFunc >
+double MeasureFastestRun( TFunc func ) {
+    const int kRunCount = 3;
+
+    double fastestSeconds = std::numeric_limits< double >::max( );
+    for ( int i = 0; i < kRunCount; ++i ) {
+        apemode::Stopwatch stopwatch;
+        func( );
+        fastestSeconds = std::min( fastestSeconds, stopwatch.ElapsedSeconds( ) );
+    }
+
+    return fastestSeconds;
+}
+
+size_t GetVertexStride( apemodefb::EVertexFormatFb eVertexFmt ) {
+    switch ( eVertexFmt ) {
+        case apemodefb::EVertexFormatFb_Decompressed:           return sizeof( apemodefb::DecompressedVertexFb );
+        case apemodefb::EVertexFormatFb_DecompressedSkinned:    return sizeof( apemodefb::DecompressedSkinnedVertexFb );
+        case apemodefb::EVertexFormatFb_DecompressedFatSkinned: return sizeof( apemodefb::DecompressedFatSkinnedVertexFb );
+        case apemodefb::EVertexFormatFb_Default:                return sizeof( apemodefb::DefaultVertexFb );
+        case apemodefb::EVertexFormatFb_Skinned:                return sizeof( apemodefb::SkinnedVertexFb );
+        case apemodefb::EVertexFormatFb_FatSkinned:             return sizeof( apemodefb::FatSkinnedVertexFb );
+        default:                                                return 0;
+    }
+}
+
+/**
+ * Decoding speed per core in MB/s of the decoded data (--mesh-decode-budget).
+ * The selection relies on the estimates rather than the timings, so the output does not depend on the build machine and its load.
+ **/
+double GetDecodingSpeed( apemodefb::ECompressionTypeFb eCompressionType ) {
+    switch ( eCompressionType ) {
+        case apemodefb::ECompressionTypeFb_GoogleDraco3D: return 50.0;
+        case apemodefb::ECompressionTypeFb_Meshopt:       return 1000.0;
+        case apemodefb::ECompressionTypeFb_LZ4:           return 3000.0;
+        case apemodefb::ECompressionTypeFb_Zstd:          return 800.0;
+        default:                                          return 0.0;
+    }
+}
+
+double EstimateDecodingSeconds( apemodefb::ECompressionTypeFb eCompressionType, size_t decodedSize ) {
+    const double decodingSpeed = GetDecodingSpeed( eCompressionType );
+    return decodingSpeed > 0 ? decodedSize / ( decodingSpeed * 1024 * 1024 ) : 0.0;
+}
+
+/* Returns the fastest decoding time of the encoded mesh buffers, or a negative value if they failed to decode. */
+double MeasureMeshDecoding( const apemode::Mesh&          m,
+                            apemodefb::EVertexFormatFb    eVertexFmt,
+                            apemodefb::ECompressionTypeFb eCompressionType,
+                            uint32_t                      vertexCount,
+                            uint32_t                      indexCount ) {
+    bool   decoded       = true;
+    double decodeSeconds = 0;
+
+    switch ( eCompressionType ) {
+        case apemodefb::ECompressionTypeFb_GoogleDraco3D:
+            decodeSeconds = MeasureFastestRun( [&] {
+                draco::DecoderBuffer decoderBuffer;
+                decoderBuffer.Init( reinterpret_cast< const char* >( m.vertices.data( ) ), m.vertices.size( ) );
+
+                draco::Decoder decoder;
+                decoded = decoder.DecodeMeshFromBuffer( &decoderBuffer ).ok( ) && decoded;
+            } );
+            break;
+
+        case apemodefb::ECompressionTypeFb_Meshopt: {
+            const size_t stride = GetVertexStride( eVertexFmt );
+            std::vector< uint8_t > decodedVertices( vertexCount * stride );
+            std::vector< uint8_t > decodedIndices( indexCount * ( m.indexType == apemodefb::EIndexTypeFb_UInt16 ? sizeof( uint16_t ) : sizeof( uint32_t ) ) );
+
+            decodeSeconds = MeasureFastestRun( [&] {
+                decoded = DecodeMeshopt( decodedVertices.data( ), vertexCount, stride, m.vertices.data( ), m.vertices.size( ),
+                                         decodedIndices.data( ), indexCount, m.indexType, m.indices.data( ), m.indices.size( ) ) && decoded;
+            } );
+        } break;
+
+        default:
+            break;
+    }
+
+    return decoded ? decodeSeconds : -1.0;
+}
+
+/**
+ * Picks the mesh encoding (--mesh-compression auto).
+ * The raw, meshopt and Draco encodings (several quantization levels, single subset meshes only) are combined with
+ * the block codecs (none, lz4, zstd), the smallest one that decodes fast enough (--mesh-decode-budget) and does not
+ * move the positions further than allowed (--mesh-error-tolerance) is kept, the raw buffers always qualify.
+ * The decoding speed is estimated with the fixed speeds of the codecs (see GetDecodingSpeed), the timings go to the report.
+ * Small meshes often get larger or slower with Draco, so the choice is made per mesh.
+ **/
+template < typename TIndex >
+void SelectMeshEncoding( apemode::State&                                s,
+                         FbxNode*                                       pNode,
+                         apemode::Mesh&                                 m,
+                         apemode::MeshReport&                           meshReport,
+                         uint32_t                                       vertexCount,
+                         const std::vector< StaticVertex >&             vertices,
+                         const std::vector< mathfu::dquat >&            qtangents,
+                         const std::vector< TControlPointSkinInfo< > >& skinInfos,
+                         EBoneCountPerControlPoint                      boneCount,
+                         apemodefb::EVertexFormatFb&                    eVertexFmt,
+                         apemodefb::ECompressionTypeFb&                 eCompressionType,
+                         uint32_t&                                      submeshVertexCount,
+                         uint32_t&                                      submeshIndexCount ) {
+    FBXP_PROFILE_SCOPE( "SelectMeshEncoding", pNode->GetName( ) );
+
+    struct MeshCodec {
+        std::string     name;
+        std::string     label;
+        EncodingProfile encodingProfile;
+    };
+
+    std::vector< MeshCodec > meshCodecs;
+    meshCodecs.push_back( MeshCodec{"none", "none", EncodingProfile( )} );
+    meshCodecs.push_back( MeshCodec{"meshopt", "meshopt", EncodingProfile( )} );
+
+    if ( m.subsets.size( ) == 1 ) {
+        for ( const int positionQuantizationBits : {16, 14, 12, 10} ) {
+            EncodingProfile encodingProfile;
+            encodingProfile.positionQuantizationBits = positionQuantizationBits;
+            encodingProfile.uvQuantizationBits       = std::max( positionQuantizationBits, 12 );
+            meshCodecs.push_back( MeshCodec{"draco", "draco " + std::to_string( positionQuantizationBits ) + " bits", encodingProfile} );
+        }
+    }
+
+    const apemodefb::ECompressionTypeFb blockCompressionTypes[] = {apemodefb::ECompressionTypeFb_None,
+                                                                   apemodefb::ECompressionTypeFb_LZ4,
+                                                                   apemodefb::ECompressionTypeFb_Zstd};
+
+    const float decodeBudget   = s.options[ "mesh-decode-budget" ].count( ) ? s.options[ "mesh-decode-budget" ].as< float >( ) : 0.0f;
+    const float errorTolerance = s.options[ "mesh-error-tolerance" ].count( ) ? s.options[ "mesh-error-tolerance" ].as< float >( ) : 0.0001f;
+
+    /* Draco quantizes the positions on the largest extent of the bounding box, the error is relative to its diagonal. */
+    const mathfu::dvec3 extent( m.positionMax.x( ) - m.positionMin.x( ), m.positionMax.y( ) - m.positionMin.y( ), m.positionMax.z( ) - m.positionMin.z( ) );
+    const double        maxExtent = std::max( extent.x, std::max( extent.y, extent.z ) );
+    const double        diagonal  = extent.Length( );
+
+    const std::vector< uint8_t > indices = m.indices;
+    size_t                       rawSize = 0;
+
+    bool                          hasSelection                  = false;
+    size_t                        selectedSize                  = 0;
+    std::string                   selectedName;
+    std::vector< uint8_t >        selectedVertices;
+    std::vector< uint8_t >        selectedIndices;
+    apemode::MeshReport           selectedReport;
+    apemodefb::ECompressionTypeFb selectedBlockCompressionType  = apemodefb::ECompressionTypeFb_None;
+    int                           selectedBlockCompressionLevel = 0;
+
+    for ( const MeshCodec& meshCodec : meshCodecs ) {
+        if ( meshCodec.name == "draco" && diagonal > 0 ) {
+            const double step  = maxExtent / double( ( 1 << meshCodec.encodingProfile.positionQuantizationBits ) - 1 );
+            const double error = 0.5 * step * std::sqrt( 3.0 ) / diagonal;
+            if ( error > errorTolerance ) {
+                s.console->debug( "Mesh \"{}\": {} skipped, position error {} > {}", pNode->GetName( ), meshCodec.label, error, errorTolerance );
+                continue;
+            }
+        }
+
+        m.indices = indices;
+
+        apemode::MeshReport           codecReport;
+        apemodefb::EVertexFormatFb    codecVertexFmt;
+        apemodefb::ECompressionTypeFb codecCompressionType;
+        uint32_t                      codecVertexCount;
+        uint32_t                      codecIndexCount;
+
+        EncodeMesh< TIndex >( s, pNode, m, codecReport, meshCodec.name, meshCodec.encodingProfile, vertexCount, vertices, qtangents, skinInfos, boneCount,
+                              codecVertexFmt, codecCompressionType, codecVertexCount, codecIndexCount );
+
+        /* The codecs that could not encode the mesh leave the raw buffers, those are covered already. */
+        if ( meshCodec.name != "none" && codecCompressionType == apemodefb::ECompressionTypeFb_None )
+            continue;
+
+        if ( meshCodec.name == "none" )
+            rawSize = m.vertices.size( ) + m.indices.size( );
+
+        const double codecDecodeSeconds = MeasureMeshDecoding( m, codecVertexFmt, codecCompressionType, codecVertexCount, codecIndexCount );
+        if ( codecDecodeSeconds < 0 ) {
+            s.console->warn( "Mesh \"{}\": {} buffers failed to decode, skipped.", pNode->GetName( ), meshCodec.label );
+            continue;
+        }
+
+        for ( const apemodefb::ECompressionTypeFb blockCompressionType : blockCompressionTypes ) {
+            const int blockCompressionLevel = blockCompressionType == s.blockCompressionType
+                                            ? s.blockCompressionLevel
+                                            : GetDefaultBlockCompressionLevel( blockCompressionType );
+
+            /* Same as State::CompressBuffer, the buffers that do not shrink are stored as is. */
+            size_t encodedSize                 = 0;
+            double blockDecodeSeconds          = 0;
+            double estimatedBlockDecodeSeconds = 0;
+            for ( const std::vector< uint8_t >* pBuffer : {&m.vertices, &m.indices} ) {
+                std::vector< uint8_t > compressedBuffer;
+                if ( blockCompressionType == apemodefb::ECompressionTypeFb_None || pBuffer->empty( ) ||
+                     false == CompressBlock( blockCompressionType, blockCompressionLevel, pBuffer->data( ), pBuffer->size( ), compressedBuffer ) ||
+                     compressedBuffer.size( ) >= pBuffer->size( ) ) {
+                    encodedSize += pBuffer->size( );
+                    continue;
+                }
+
+                std::vector< uint8_t > decompressedBuffer( pBuffer->size( ) );
+                blockDecodeSeconds += MeasureFastestRun( [&] {
+                    DecompressBlock( blockCompressionType, compressedBuffer.data( ), compressedBuffer.size( ), decompressedBuffer.data( ), decompressedBuffer.size( ) );
+                } );
+
+                estimatedBlockDecodeSeconds += EstimateDecodingSeconds( blockCompressionType, pBuffer->size( ) );
+
+                encodedSize += compressedBuffer.size( );
+            }
+
+            const double decodeSeconds          = codecDecodeSeconds + blockDecodeSeconds;
+            const double estimatedDecodeSeconds = EstimateDecodingSeconds( codecCompressionType, rawSize ) + estimatedBlockDecodeSeconds;
+            const double decodeSpeed = estimatedDecodeSeconds > 0 ? rawSize / ( estimatedDecodeSeconds * 1024 * 1024 ) : std::numeric_limits< double >::max( );
+
+            s.console->debug( "Mesh \"{}\": {} + {}: {} -> {}, decoding {} MB/s (estimated), {} MB/s (measured)",
+                              pNode->GetName( ),
+                              meshCodec.label,
+                              apemodefb::EnumNameECompressionTypeFb( blockCompressionType ),
+                              ToPrettySizeString( rawSize ),
+                              ToPrettySizeString( encodedSize ),
+                              decodeSpeed,
+                              decodeSeconds > 0 ? rawSize / ( decodeSeconds * 1024 * 1024 ) : 0.0 );
+
+            /* The raw buffers always qualify, there is nothing to decode. */
+            const bool isRaw = meshCodec.name == "none" && blockCompressionType == apemodefb::ECompressionTypeFb_None;
+            if ( false == isRaw && decodeBudget > 0 && decodeSpeed < decodeBudget )
+                continue;
+
+            if ( hasSelection && encodedSize >= selectedSize )
+                continue;
+
+            hasSelection                  = true;
+            selectedSize                  = encodedSize;
+            selectedName                  = meshCodec.label;
+            selectedVertices              = m.vertices;
+            selectedIndices               = m.indices;
+            selectedBlockCompressionType  = blockCompressionType;
+            selectedBlockCompressionLevel = blockCompressionLevel;
+            eVertexFmt                    = codecVertexFmt;
+            eCompressionType              = codecCompressionType;
+            submeshVertexCount            = codecVertexCount;
+            submeshIndexCount             = codecIndexCount;
+
+            selectedReport               = codecReport;
+            selectedReport.decodeSeconds = decodeSeconds;
+        }
+    }
+
+    assert( hasSelection );
+    m.vertices.swap( selectedVertices );
+    m.indices.swap( selectedIndices );
+    m.hasBlockCompression   = true;
+    m.blockCompressionType  = selectedBlockCompressionType;
+    m.blockCompressionLevel = selectedBlockCompressionLevel;
+
+    meshReport.uncompressedSize = rawSize;
+    meshReport.encodeSeconds    = selectedReport.encodeSeconds;
+    meshReport.decodeSeconds    = selectedReport.decodeSeconds;
+
+    s.console->info( "Mesh \"{}\": {} + {} ({} -> {})",
+                     pNode->GetName( ),
+                     selectedName,
+                     apemodefb::EnumNameECompressionTypeFb( selectedBlockCompressionType ),
+                     ToPrettySizeString( rawSize ),
+                     ToPrettySizeString( selectedSize ) );
+}
+
+template < typename TIndex, EVertexOrder TOrder = EVertexOrder::CCW >
+void ExportMesh( apemode::State& s,
+                 FbxNode*        pNode,
+                 FbxMesh*        pMesh,
+                 apemode::Node&  n,
+                 apemode::Mesh&  m,
+                 uint32_t        vertexCount,
+                 bool            pack,
+                 FbxSkin*        pSkin,
+                 bool            optimize ) {
+    /* Packing is disabled for now. */
+    pack = false;
+
+    /* Fill indices. */
+
+    m.indices.resize( vertexCount * sizeof( TIndex ) );
+    TIndex* indices = (TIndex*) m.indices.data( );
+
+    if ( TOrder == EVertexOrder::CW ) {
+        for ( TIndex i = 0; i < vertexCount; i += 3 ) {
+            indices[ i + 0 ] = i + 0;
+            indices[ i + 1 ] = i + 2;
+            indices[ i + 2 ] = i + 1;
+        }
+    }
+    else {
+        for ( TIndex i = 0; i < vertexCount; i += 3 ) {
+            indices[ i + 0 ] = i + 0;
+            indices[ i + 1 ] = i + 1;
+            indices[ i + 2 ] = i + 2;
+        }
+    }
+
+    static_assert(std::is_same< TIndex, uint16_t >::value ||
+                  std::is_same< TIndex, uint32_t >::value,
+                  "Should be either uint16 or uint32");
+
+    // TODO: constexpr
+    if ( std::is_same< TIndex, uint16_t >::value ) {
+        m.indexType = apemodefb::EIndexTypeFb_UInt16;
+    } else {
+        const bool isUint32 = std::is_same< TIndex, uint32_t >::value;
+        assert( isUint32 && "Caught unexpected index type." );
+        m.indexType = apemodefb::EIndexTypeFb_UInt32;
+        (void)isUint32;
+    }
+
+    /* Fill subsets. */
+
+    GetSubsets( s, pMesh, m.subsets );
+    if ( m.subsets.empty( ) ) {
+        /* Independently from GetSubsets implementation make sure there is at least one subset. */
+        const uint32_t materialId = pMesh->GetNode( )->GetMaterialCount( ) > 0 ? 0 : uint32_t( -1 );
+        m.subsets.push_back( apemodefb::SubsetFb( materialId, 0, vertexCount ) );
+    }
+
+    std::vector< StaticVertex > vertices;
+    vertices.resize( vertexCount );
+
+    apemode::ProfileScope initScope( "InitializeVertices" );
+    auto initResult = InitializeVertices( s, pMesh, m, vertices.data( ), vertexCount );
+    (void)initResult;
+    initScope.End( );
+
+    apemode::ProfileScope qtangentsScope( "QTangents" );
+    std::vector< mathfu::dquat > qtangents;
+    qtangents.resize( vertexCount );
+    for ( uint32_t i = 0; i < vertexCount; ++i ) {
+        mathfu::dvec3 n( vertices[ i ].normal );
+        mathfu::dvec3 t( vertices[ i ].tangent.xyz( ) );
+
+        if ( n.Length( ) < std::numeric_limits< float >::epsilon( ) ||
+             t.Length( ) < std::numeric_limits< float >::epsilon( ) ) {
+            qtangents[ i ] = mathfu::dquat::identity;
+            continue;
+        }
+
+        n.Normalize( );
+        t.Normalize( );
+
+        qtangents[ i ] = GetQTangent( n, t, vertices[ i ].tangent.w );
+    }
+
+    qtangentsScope.End( );
+
+    using ControlPointSkinInfo = TControlPointSkinInfo<>;
+
+    EBoneCountPerControlPoint           boneCount = EBoneCountPerControlPoint( 0 );
+    std::vector< ControlPointSkinInfo > skinInfos;
+
+    if ( pSkin ) {
+        FBXP_PROFILE_SCOPE( "Skin" );
+
+        /* Allocate skin info for each control point. */
+        /* Populate skin info for each control point. */
+
+        skinInfos.resize( pMesh->GetControlPointsCount( ) );
+
+        m.skinId = uint32_t( s.skins.size( ) );
+
+        s.skins.emplace_back( );
+        auto& skin  = s.skins.back( );
+        skin.nameId = s.PushValue( pSkin->GetName( ) );
+
+        const int clusterCount = pSkin->GetClusterCount( );
+        s.console->debug( "\t Skin has {} clusters", clusterCount );
+
+        skin.linkIds.reserve( clusterCount );
+        for ( int i = 0; i < clusterCount; ++i ) {
+            assert( i < clusterCount );
+            const auto pCluster = pSkin->GetCluster( i );
+            assert( pCluster );
+
+            if ( const auto indexCount = pCluster->GetControlPointIndicesCount( ) ) {
+                assert( s.nodeDict.find( pCluster->GetLink( )->GetUniqueID( ) ) != s.nodeDict.end( ) );
+                const uint32_t linkNodeId = s.nodeDict[ pCluster->GetLink( )->GetUniqueID( ) ];
+
+                const double* pWeights = pCluster->GetControlPointWeights( );
+                const int* pIndices = pCluster->GetControlPointIndices( );
+
+                s.console->debug( "\t Cluster #{} influences {} point(s)", i, indexCount );
+
+                uint32_t boneIndex = (uint32_t) skin.linkIds.size( );
+                skin.linkIds.push_back( linkNodeId );
+
+                for ( int j = 0; j < indexCount; ++j ) {
+                    /* Assign bone (weight + index) for the control point. */
+                    assert( pIndices[ j ] < pMesh->GetControlPointsCount( ) );
+                    skinInfos[ pIndices[ j ] ].AddBone( (float) pWeights[ j ], boneIndex );
+                }
+
+                FbxAMatrix bindPoseMatrix;
+                FbxAMatrix transformMatrix;
+                pCluster->GetTransformLinkMatrix( bindPoseMatrix );
+                pCluster->GetTransformMatrix( transformMatrix );
+                const FbxAMatrix geometricMatrix = GetGeometricTransformation( pMesh->GetNode( ) );
+                const FbxAMatrix invBindPoseMatrix = bindPoseMatrix.Inverse( ) * transformMatrix * geometricMatrix;
+                skin.invBindPoseMatrices.push_back( apemode::Cast( invBindPoseMatrix ) );
+
+                // TODO: Scaling can't be included into dual quaternions.
+                // const FbxVector4 S = invBindPoseMatrix.GetS();
+
+                const FbxQuaternion Q = invBindPoseMatrix.GetQ( );
+                const FbxVector4 T = invBindPoseMatrix.GetT( );
+
+                const FbxDualQuaternion DQ( Q, T );
+                skin.invBindPoseDualQuats.push_back( apemode::Cast( DQ ) );
+            }
+        }
+
+        /* Report about used bone slots. */
+        uint32_t maxBoneCount = 4;
+        boneCount = eBoneCountPerControlPoint_4;
+        {
+            std::map< uint32_t, uint32_t > boneCountToControlPointCountMap;
+            for ( uint32_t i = 0; i < skinInfos.size( ); ++i ) {
+                ++boneCountToControlPointCountMap[ skinInfos[ i ].GetUsedSlotCount( ) ];
+            }
+
+            s.console->debug( "Used slots:" );
+            for ( auto& p : boneCountToControlPointCountMap ) {
+                s.console->debug( "\t {} slots <- {} points ", p.first, p.second );
+            }
+
+            maxBoneCount = std::max( boneCountToControlPointCountMap.rbegin( )->first, maxBoneCount );
+            s.console->debug( "\t max bones <- {}", maxBoneCount );
+        }
+
+
+        if ( maxBoneCount > eBoneCountPerControlPoint_4 ) {
+            boneCount = eBoneCountPerControlPoint_8;
+        }
+
+        /* Normalize bone weights for each control point. */
+        for ( auto& skinInfo : skinInfos ) {
+            skinInfo.NormalizeWeights( maxBoneCount, 0 );
+        }
+    }
+
+    apemodefb::EVertexFormatFb    eVertexFmt         = apemodefb::EVertexFormatFb( -1 );
+    apemodefb::ECompressionTypeFb eCompressionType   = apemodefb::ECompressionTypeFb_None;
+    uint32_t                      submeshVertexCount = vertexCount;
+    uint32_t                      submeshIndexCount  = 0;
+
+    const std::string meshCompression = s.options[ "mesh-compression" ].count( ) ? s.options[ "mesh-compression" ].as< std::string >( ) : "none";
+    if ( meshCompression == "auto" ) {
+        SelectMeshEncoding< TIndex >( s, pNode, m, s.report.meshes[ n.meshId ], vertexCount, vertices, qtangents, skinInfos, boneCount,
+                                      eVertexFmt, eCompressionType, submeshVertexCount, submeshIndexCount );
+    } else {
+        EncodeMesh< TIndex >( s, pNode, m, s.report.meshes[ n.meshId ], meshCompression, EncodingProfile( ), vertexCount, vertices, qtangents, skinInfos, boneCount,
+                              eVertexFmt, eCompressionType, submeshVertexCount, submeshIndexCount );
     }
 
     assert( eVertexFmt != apemodefb::EVertexFormatFb( -1 ) );
@@ -1854,9 +2270,9 @@ void ExportMesh( FbxNode*       pNode,
     m.submeshes.emplace_back( bboxMin,                               // bbox min
                               bboxMax,                               // bbox max
                               0,                                     // base vertex
-                              vertexCount,                           // vertex count
+                              submeshVertexCount,                    // vertex count
                               0,                                     // base index
-                              0,                                     // index count
+                              submeshIndexCount,                     // index count
                               0,                                     // base subset
                               (uint32_t) m.subsets.size( ),          // subset count
                               eVertexFmt,                            // vertex format
@@ -1864,11 +2280,11 @@ void ExportMesh( FbxNode*       pNode,
     );
 }
 
-void ExportMesh( FbxNode* node, apemode::Node& n, bool pack, bool optimize ) {
-    auto& s = apemode::State::Get( );
+void ExportMesh( apemode::State& s, FbxNode* node, apemode::Node& n, bool pack, bool optimize ) {
     if ( auto mesh = node->GetMesh( ) ) {
+        FBXP_PROFILE_SCOPE( "ExportMesh", node->GetName( ) );
 
-        s.console->info( "Node \"{}\" has mesh.", node->GetName( ) );
+        s.console->debug( "Node \"{}\" has mesh.", node->GetName( ) );
         if ( !mesh->IsTriangleMesh( ) ) {
 
             s.console->warn( "Mesh \"{}\" is not triangular, processing...", node->GetName( ) );
@@ -1899,14 +2315,36 @@ void ExportMesh( FbxNode* node, apemode::Node& n, bool pack, bool optimize ) {
                 s.meshes.emplace_back( );
                 apemode::Mesh& m = s.meshes.back( );
 
+                s.report.meshes.emplace_back( );
+                apemode::MeshReport& meshReport = s.report.meshes.back( );
+                meshReport.name                 = node->GetName( );
+                meshReport.controlPointCount    = (uint32_t) mesh->GetControlPointsCount( );
+                meshReport.polygonCount         = (uint32_t) mesh->GetPolygonCount( );
+
                 FbxSkin* pSkin = 0 != mesh->GetDeformerCount( FbxDeformer::eSkin )
                                      ? FbxCast< FbxSkin >( mesh->GetDeformer( 0, FbxDeformer::eSkin ) )
                                      : nullptr;
 
                 if ( vertexCount < std::numeric_limits< uint16_t >::max( ) )
-                    ExportMesh< uint16_t >( node, mesh, n, m, vertexCount, pack, pSkin, optimize );
+                    ExportMesh< uint16_t >( s, node, mesh, n, m, vertexCount, pack, pSkin, optimize );
                 else
-                    ExportMesh< uint32_t >( node, mesh, n, m, vertexCount, pack, pSkin, optimize );
+                    ExportMesh< uint32_t >( s, node, mesh, n, m, vertexCount, pack, pSkin, optimize );
+
+                s.SerializeMeshBuffers( m );
+                s.SerializePrefetchedFiles( );
+
+                const apemodefb::SubmeshFb& submesh = m.submeshes[ 0 ];
+                meshReport.vertexCount     = submesh.vertex_count( );
+                meshReport.indexCount      = submesh.index_count( ) ? submesh.index_count( ) : uint32_t( m.indicesCompression.uncompressed_size( ) / ( m.indexType == apemodefb::EIndexTypeFb_UInt16 ? 2 : 4 ) );
+                meshReport.subsetCount     = (uint32_t) m.subsets.size( );
+                meshReport.vertexFormat    = apemodefb::EnumNameEVertexFormatFb( submesh.vertex_format( ) );
+                meshReport.indexType       = apemodefb::EnumNameEIndexTypeFb( m.indexType );
+                meshReport.compressionType = apemodefb::EnumNameECompressionTypeFb( submesh.compression_type( ) );
+                meshReport.verticesSize    = m.verticesSize;
+                meshReport.indicesSize     = m.indicesSize;
+                meshReport.blockCompressionType = apemodefb::EnumNameECompressionTypeFb( m.verticesCompression.compression_type( ) );
+                if ( 0 == meshReport.uncompressedSize )
+                    meshReport.uncompressedSize = m.verticesCompression.uncompressed_size( ) + m.indicesCompression.uncompressed_size( );
 
             } else {
                 s.console->error( "Mesh \"{}\" has no vertices (skipped).", node->GetName( ) );
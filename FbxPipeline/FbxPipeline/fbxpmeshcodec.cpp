@@ -0,0 +1,105 @@
+#include <fbxppch.h>
+#include <scene_generated.h>
+
+#include <meshoptimizer.h>
+
+/**
+ * Meshopt codec (--mesh-compression meshopt).
+ * The vertex stream is transposed into byte planes and each plane is delta coded against the previous vertex,
+ * the index stream is coded per triangle against the recently seen edges and vertices.
+ * The output stays byte-oriented and is meant to be followed by the block codec (--block-compression),
+ * unlike Draco the vertex format is kept as is and both streams decode at memory speed.
+ **/
+
+namespace {
+    /* The vertex codec works with 4-byte aligned vertices of up to 256 bytes. */
+    bool IsMeshoptVertexStride( size_t stride ) {
+        return stride > 0 && stride <= 256 && stride % 4 == 0;
+    }
+
+    template < typename TIndex >
+    uint32_t EncodeMeshoptStreams( std::vector< uint8_t >&                   vertices,
+                                   std::vector< uint8_t >&                   indices,
+                                   const std::vector< apemodefb::SubsetFb >& subsets,
+                                   uint32_t                                  vertexCount,
+                                   size_t                                    stride ) {
+        TIndex*      pIndices   = reinterpret_cast< TIndex* >( indices.data( ) );
+        const size_t indexCount = indices.size( ) / sizeof( TIndex );
+
+        /* Weld the identical vertices, the exported vertices are unique for each triangle corner. */
+        std::vector< uint32_t > remap( vertexCount );
+        const size_t uniqueVertexCount = meshopt_generateVertexRemap( remap.data( ), pIndices, indexCount, vertices.data( ), vertexCount, stride );
+
+        meshopt_remapIndexBuffer( pIndices, pIndices, indexCount, remap.data( ) );
+        meshopt_remapVertexBuffer( vertices.data( ), vertices.data( ), vertexCount, stride, remap.data( ) );
+        vertices.resize( uniqueVertexCount * stride );
+
+        /* Reorder the triangles within the subsets (they are index ranges), then the vertices in the order of the first use. */
+        for ( const auto& subset : subsets ) {
+            assert( subset.base_index( ) + subset.index_count( ) <= indexCount );
+            TIndex* pSubsetIndices = pIndices + subset.base_index( );
+            meshopt_optimizeVertexCache( pSubsetIndices, pSubsetIndices, subset.index_count( ), uniqueVertexCount );
+        }
+
+        meshopt_optimizeVertexFetch( vertices.data( ), pIndices, indexCount, vertices.data( ), uniqueVertexCount, stride );
+
+        std::vector< uint8_t > encodedVertices( meshopt_encodeVertexBufferBound( uniqueVertexCount, stride ) );
+        encodedVertices.resize( meshopt_encodeVertexBuffer( encodedVertices.data( ), encodedVertices.size( ), vertices.data( ), uniqueVertexCount, stride ) );
+
+        std::vector< uint8_t > encodedIndices( meshopt_encodeIndexBufferBound( indexCount, uniqueVertexCount ) );
+        encodedIndices.resize( meshopt_encodeIndexBuffer( encodedIndices.data( ), encodedIndices.size( ), pIndices, indexCount ) );
+
+        if ( encodedVertices.empty( ) || encodedIndices.empty( ) )
+            return 0;
+
+        vertices.swap( encodedVertices );
+        indices.swap( encodedIndices );
+        return uint32_t( uniqueVertexCount );
+    }
+} // namespace
+
+/**
+ * Welds, reorders and encodes the vertices and indices into the encoded buffers, the source buffers are kept for the fallback.
+ * Returns the vertex count after welding, or 0 if the buffers cannot be encoded.
+ **/
+uint32_t EncodeMeshopt( const std::vector< uint8_t >&             vertices,
+                        const std::vector< uint8_t >&             indices,
+                        apemodefb::EIndexTypeFb                   indexType,
+                        const std::vector< apemodefb::SubsetFb >& subsets,
+                        uint32_t                                  vertexCount,
+                        size_t                                    stride,
+                        std::vector< uint8_t >&                   encodedVertices,
+                        std::vector< uint8_t >&                   encodedIndices ) {
+    if ( false == IsMeshoptVertexStride( stride ) || vertices.size( ) != vertexCount * stride )
+        return 0;
+
+    const size_t indexSize = indexType == apemodefb::EIndexTypeFb_UInt16 ? sizeof( uint16_t ) : sizeof( uint32_t );
+    if ( indices.empty( ) || ( indices.size( ) / indexSize ) % 3 != 0 )
+        return 0;
+
+    encodedVertices = vertices;
+    encodedIndices  = indices;
+
+    return indexType == apemodefb::EIndexTypeFb_UInt16
+        ? EncodeMeshoptStreams< uint16_t >( encodedVertices, encodedIndices, subsets, vertexCount, stride )
+        : EncodeMeshoptStreams< uint32_t >( encodedVertices, encodedIndices, subsets, vertexCount, stride );
+}
+
+/* The destination buffers must fit vertexCount * stride and indexCount * indexSize bytes. */
+bool DecodeMeshopt( void*                   vertices,
+                    uint32_t                vertexCount,
+                    size_t                  stride,
+                    const void*             encodedVertices,
+                    size_t                  encodedVerticesSize,
+                    void*                   indices,
+                    uint32_t                indexCount,
+                    apemodefb::EIndexTypeFb indexType,
+                    const void*             encodedIndices,
+                    size_t                  encodedIndicesSize ) {
+    if ( false == IsMeshoptVertexStride( stride ) || indexCount % 3 != 0 )
+        return false;
+
+    const size_t indexSize = indexType == apemodefb::EIndexTypeFb_UInt16 ? sizeof( uint16_t ) : sizeof( uint32_t );
+    return 0 == meshopt_decodeVertexBuffer( vertices, vertexCount, stride, (const unsigned char*) encodedVertices, encodedVerticesSize ) &&
+           0 == meshopt_decodeIndexBuffer( indices, indexCount, indexSize, (const unsigned char*) encodedIndices, encodedIndicesSize );
+}
@@ -23,27 +23,26 @@ const char* GetSkeletonTypeString( FbxSkeleton::EType eType ) {
     }
 }
 
-void InitializeSeachLocations( );
-void ExportMesh( FbxNode* node, apemode::Node& n, bool pack, bool optimize );
-void ExportMaterials( FbxScene* scene );
-void ExportMaterials( FbxNode* node, apemode::Node& n );
-void ExportTransform( FbxNode* node, apemode::Node& n );
-void ExportAnimation( FbxNode* node, apemode::Node& n );
-void ExportCamera( FbxNode* node, apemode::Node& n );
-void ExportLight( FbxNode* node, apemode::Node& n );
-
-
-void ExportSkeleton( FbxNode* node, apemode::Node& n ) {
+void InitializeSeachLocations( apemode::State& s );
+bool GetBinFileSize( const char* srcPath, size_t& fileSize );
+std::string ToPrettySizeString( size_t size );
+void ExportMesh( apemode::State& s, FbxNode* node, apemode::Node& n, bool pack, bool optimize );
+void ExportMaterials( apemode::State& s, FbxScene* scene );
+void ExportMaterials( apemode::State& s, FbxNode* node, apemode::Node& n );
+void ExportTransform( apemode::State& s, FbxNode* node, apemode::Node& n );
+void ExportAnimation( apemode::State& s, FbxNode* node, apemode::Node& n );
+void ExportCamera( apemode::State& s, FbxNode* node, apemode::Node& n );
+void ExportLight( apemode::State& s, FbxNode* node, apemode::Node& n );
+
+
+void ExportSkeleton( apemode::State& s, FbxNode* node, apemode::Node& n ) {
     if ( auto pSkeleton = node->GetSkeleton( ) ) {
-        auto& s = apemode::State::Get( );
-        s.console->info( "\tSkeleton: {} -> {}", node->GetName( ), GetSkeletonTypeString( pSkeleton->GetSkeletonType( ) ) );
+        s.console->debug( "\tSkeleton: {} -> {}", node->GetName( ), GetSkeletonTypeString( pSkeleton->GetSkeletonType( ) ) );
         n.skeletonType = apemodefb::ESkeletonTypeFb( pSkeleton->GetSkeletonType( ) );
     }
 }
 
-void ExportNodeAttributes( FbxNode* node, apemode::Node& n ) {
-    auto& s = apemode::State::Get( );
-
+void ExportNodeAttributes( apemode::State& s, FbxNode* node, apemode::Node& n ) {
     n.cullingType = (apemodefb::ECullingTypeFb) node->mCullingType;
     node->GetTransformationInheritType( (FbxTransform::EInheritType&) n.inheritType );
     node->GetRotationOrder( FbxNode::eSourcePivot, (FbxEuler::EOrder&) n.rotationOrder );
@@ -53,25 +52,23 @@ void ExportNodeAttributes( FbxNode* node, apemode::Node& n ) {
     node->GetPivotState( FbxNode::EPivotSet::eDestinationPivot, dstPivotState );
     node->GetPivotState( FbxNode::EPivotSet::eSourcePivot, srcPivotState );
 
-    s.console->info( "\tCulling: {}", apemodefb::EnumNameECullingTypeFb( n.cullingType ) );
-    s.console->info( "\tInherit type: {}", apemodefb::EnumNameEInheritTypeFb( n.inheritType ) );
-    s.console->info( "\tRotation order: {}", apemodefb::EnumNameERotationOrderFb( n.rotationOrder ) );
-    s.console->info( "\tSrc pivot state: {}", GetPivotStateString( srcPivotState ) );
-    s.console->info( "\tDst pivot state: {}", GetPivotStateString( dstPivotState ) );
-
-    ExportTransform( node, n );
-    ExportAnimation( node, n );
-    ExportMaterials( node, n );
-    ExportCamera( node, n );
-    ExportLight( node, n );
+    s.console->debug( "\tCulling: {}", apemodefb::EnumNameECullingTypeFb( n.cullingType ) );
+    s.console->debug( "\tInherit type: {}", apemodefb::EnumNameEInheritTypeFb( n.inheritType ) );
+    s.console->debug( "\tRotation order: {}", apemodefb::EnumNameERotationOrderFb( n.rotationOrder ) );
+    s.console->debug( "\tSrc pivot state: {}", GetPivotStateString( srcPivotState ) );
+    s.console->debug( "\tDst pivot state: {}", GetPivotStateString( dstPivotState ) );
+
+    ExportTransform( s, node, n );
+    ExportAnimation( s, node, n );
+    ExportMaterials( s, node, n );
+    ExportCamera( s, node, n );
+    ExportLight( s, node, n );
 }
 
-uint32_t ExportNode( FbxNode* node ) {
-    auto& s = apemode::State::Get( );
-
-    s.console->info( "" );
-    s.console->info( "" );
-    s.console->info( "ExportNode: {}", node->GetName( ) );
+uint32_t ExportNode( apemode::State& s, FbxNode* node ) {
+    s.console->debug( "" );
+    s.console->debug( "" );
+    s.console->debug( "ExportNode: {}", node->GetName( ) );
 
     if ( false == node->GetObjectFlags( FbxObject::EObjectFlag::eHidden ) ) {
         const uint32_t nodeId = static_cast< uint32_t >( s.nodes.size( ) );
@@ -84,11 +81,11 @@ uint32_t ExportNode( FbxNode* node ) {
 
         s.nodeDict[ n.fbxId ] = nodeId;
 
-        ExportNodeAttributes( node, n );
+        ExportNodeAttributes( s, node, n );
         if ( auto c = node->GetChildCount( ) ) {
             n.childIds.reserve( c );
             for ( auto i = 0; i < c; ++i ) {
-                const auto childId = ExportNode( node->GetChild( i ) );
+                const auto childId = ExportNode( s, node->GetChild( i ) );
                 if ( childId != -1 )
                     s.nodes[ nodeId ].childIds.push_back( childId );
             }
@@ -97,44 +94,152 @@ uint32_t ExportNode( FbxNode* node ) {
         return nodeId;
     }
 
-    s.console->info( "Node {} is hidden", node->GetName( ) );
+    s.console->debug( "Node {} is hidden", node->GetName( ) );
     return uint32_t( -1 );
 }
 
-void ExportMeshes( FbxNode* pFbxNode ) {
-    auto& s = apemode::State::Get( );
+/**
+ * Orders the nodes breadth-first, so that the parents precede their children, and splits the order into the depth levels.
+ * The parent index points into the order, the roots (the nodes that are not children) have -1.
+ * The child ids can be changed by the scripts, the ones out of range and the ones that are already ordered
+ * (cycles, several parents) are skipped, the nodes of the cycles that no root reaches become roots.
+ **/
+void BuildNodeOrder( apemode::State&                        s,
+                     std::vector< apemodefb::NodeOrderFb >& nodeOrder,
+                     std::vector< apemodefb::NodeLevelFb >& nodeLevels ) {
+    const std::vector< apemode::Node >& nodes = s.nodes;
+
+    nodeOrder.clear( );
+    nodeLevels.clear( );
+    nodeOrder.reserve( nodes.size( ) );
+
+    std::vector< bool > isChild( nodes.size( ), false );
+    for ( auto& node : nodes ) {
+        for ( auto childId : node.childIds ) {
+            if ( childId < nodes.size( ) )
+                isChild[ childId ] = true;
+        }
+    }
+
+    std::vector< uint32_t > rootIds;
+    for ( uint32_t i = 0; i < nodes.size( ); ++i ) {
+        if ( false == isChild[ i ] )
+            rootIds.push_back( i );
+    }
+
+    /* Marks the nodes in the subtree of the root (depth-first, the order does not matter here). */
+    std::vector< bool >     isReached( nodes.size( ), false );
+    std::vector< uint32_t > reachedIds;
+    auto reachSubtree = [&]( uint32_t rootId ) {
+        isReached[ rootId ] = true;
+        reachedIds.assign( 1, rootId );
+        while ( false == reachedIds.empty( ) ) {
+            const uint32_t nodeId = reachedIds.back( );
+            reachedIds.pop_back( );
+
+            for ( auto childId : nodes[ nodeId ].childIds ) {
+                if ( childId < nodes.size( ) && false == isReached[ childId ] ) {
+                    isReached[ childId ] = true;
+                    reachedIds.push_back( childId );
+                }
+            }
+        }
+    };
+
+    for ( auto rootId : rootIds )
+        reachSubtree( rootId );
+
+    /* The nodes that no root reaches are in the cycles, the first one of each cycle becomes a root. */
+    for ( uint32_t i = 0; i < nodes.size( ); ++i ) {
+        if ( false == isReached[ i ] ) {
+            s.console->warn( "Node {} is in a cycle of the child ids, ordered as a root", i );
+            rootIds.push_back( i );
+            reachSubtree( i );
+        }
+    }
+
+    std::vector< bool > isOrdered( nodes.size( ), false );
+    for ( auto rootId : rootIds ) {
+        isOrdered[ rootId ] = true;
+        nodeOrder.emplace_back( rootId, uint32_t( -1 ) );
+    }
+
+    uint32_t levelFirstIndex = 0;
+    while ( levelFirstIndex < nodeOrder.size( ) ) {
+        const uint32_t levelEndIndex = static_cast< uint32_t >( nodeOrder.size( ) );
+        nodeLevels.emplace_back( levelFirstIndex, levelEndIndex - levelFirstIndex );
+
+        for ( uint32_t i = levelFirstIndex; i < levelEndIndex; ++i ) {
+            const uint32_t nodeId = nodeOrder[ i ].node_id( );
+            for ( auto childId : nodes[ nodeId ].childIds ) {
+                if ( childId >= nodes.size( ) || isOrdered[ childId ] ) {
+                    s.console->warn( "Node {} has {} child id {}, skipped", nodeId, childId >= nodes.size( ) ? "invalid" : "repeated", childId );
+                    continue;
+                }
+
+                isOrdered[ childId ] = true;
+                nodeOrder.emplace_back( childId, i );
+            }
+        }
+
+        levelFirstIndex = levelEndIndex;
+    }
+
+    assert( nodeOrder.size( ) == nodes.size( ) );
+}
 
+void ExportMeshes( apemode::State& s, FbxNode* pFbxNode ) {
     uint32_t nodeId = s.nodeDict[ pFbxNode->GetUniqueID( ) ];
     apemode::Node& node = s.nodes[ nodeId ];
     assert( node.fbxId == pFbxNode->GetUniqueID( ) );
 
-    ExportMesh( pFbxNode, node, s.options[ "p" ].as< bool >( ), s.options[ "t" ].as< bool >( ) );
+    ExportMesh( s, pFbxNode, node, s.options[ "p" ].as< bool >( ), s.options[ "t" ].as< bool >( ) );
     if ( auto c = pFbxNode->GetChildCount( ) ) {
         for ( auto i = 0; i < c; ++i ) {
-            ExportMeshes( pFbxNode->GetChild( i ) );
+            ExportMeshes( s, pFbxNode->GetChild( i ) );
         }
     }
 }
 
-void ExportSkeletons( FbxNode* pFbxNode ) {
-    auto& s = apemode::State::Get( );
+/**
+ * Estimates the size of the heaviest parts of the output (mesh and file buffers)
+ * to reserve the builder memory at once.
+ **/
+size_t EstimateOutputSize( apemode::State& s, FbxScene* pScene ) {
+    size_t estimatedSize = 0;
+    for ( int i = 0; i < pScene->GetSrcObjectCount< FbxMesh >( ); ++i ) {
+        if ( auto pMesh = pScene->GetSrcObject< FbxMesh >( i ) ) {
+            const size_t vertexCount = size_t( pMesh->GetPolygonCount( ) ) * 3;
+            estimatedSize += vertexCount * ( sizeof( apemodefb::DefaultVertexFb ) + sizeof( uint32_t ) );
+        }
+    }
+
+    for ( auto& embeddedFile : s.embeddedFiles ) {
+        size_t fileSize = 0;
+        if ( GetBinFileSize( embeddedFile.fullPath.c_str( ), fileSize ) ) {
+            estimatedSize += fileSize;
+        }
+    }
+
+    return estimatedSize;
+}
 
+void ExportSkeletons( apemode::State& s, FbxNode* pFbxNode ) {
     uint32_t nodeId = s.nodeDict[ pFbxNode->GetUniqueID( ) ];
     apemode::Node& node = s.nodes[ nodeId ];
     assert( node.fbxId == pFbxNode->GetUniqueID( ) );
 
-    ExportSkeleton( pFbxNode, node );
+    ExportSkeleton( s, pFbxNode, node );
     if ( auto c = pFbxNode->GetChildCount( ) ) {
         for ( auto i = 0; i < c; ++i ) {
-            ExportSkeletons( pFbxNode->GetChild( i ) );
+            ExportSkeletons( s, pFbxNode->GetChild( i ) );
         }
     }
 }
 
-void ExportSkeletons( FbxScene* pScene ) {
-    auto& s = apemode::State::Get( );
+void ExportSkeletons( apemode::State& s, FbxScene* pScene ) {
     s.console->info( "Skeleton: " );
-    ExportSkeletons( pScene->GetRootNode( ) );
+    ExportSkeletons( s, pScene->GetRootNode( ) );
 }
 
 /**
@@ -143,9 +248,7 @@ void ExportSkeletons( FbxScene* pScene ) {
  *                      > Triangulate
  *                      > Split meshes per material
  **/
-void PreprocessMeshes( FbxScene* scene ) {
-    auto& s = apemode::State::Get( );
-
+void PreprocessMeshes( apemode::State& s, FbxScene* scene ) {
     FbxGeometryConverter geometryConverter( s.manager );
 
 #if FBXSDK_VERSION_MAJOR > 2015
@@ -181,8 +284,7 @@ void PreprocessMeshes( FbxScene* scene ) {
     }
 }
 
-void PreprocessAnimation( FbxScene* pScene ) {
-    auto& s = apemode::State::Get( );
+void PreprocessAnimation( apemode::State& s, FbxScene* pScene ) {
     assert(pScene);
 
     int animStackCount = pScene->GetSrcObjectCount< FbxAnimStack >( );
@@ -209,7 +311,7 @@ void PreprocessAnimation( FbxScene* pScene ) {
         s.animStacks.back( ).id = animStackId;
 
         const int animLayerCount = pAnimStack->GetMemberCount< FbxAnimLayer >( );
-        s.console->info( "\t> Animation Stack #{} \"{}\" has {} layers ", i, pAnimStack->GetName( ), animLayerCount );
+        s.console->debug( "\t> Animation Stack #{} \"{}\" has {} layers ", i, pAnimStack->GetName( ), animLayerCount );
 
         for ( int j = 0; j < animLayerCount; j++ ) {
             FbxAnimLayer* pAnimLayer = pAnimStack->GetMember< FbxAnimLayer >( j );
@@ -239,7 +341,7 @@ void PreprocessAnimation( FbxScene* pScene ) {
             s.animLayers.back( ).animStackIdx = uint32_t( j );
             s.animLayers.back( ).nameId       = s.PushValue( pAnimLayer->GetName( ) );
 
-            s.console->info( "\t\t> Animation Layer #{} \"{}\"", j, pAnimLayer->GetName( ) );
+            s.console->debug( "\t\t> Animation Layer #{} \"{}\"", j, pAnimLayer->GetName( ) );
         }
     }
 }
@@ -257,10 +359,9 @@ struct AxisSystem {
     AxisDef mCoorSystem{eXAxis, -1};
 };
 
-void PrintAxisSystem( const AxisSystem& axisSystem ) {
+void PrintAxisSystem( apemode::State& s, const AxisSystem& axisSystem ) {
     const char* sz[] = {"X", "Y", "Z"};
 
-    auto& s = apemode::State::Get( );
     s.console->error( "\t\tFront={}{} Up={}{} CoordSystem={}{} ",
                       axisSystem.mFrontVector.mSign >= 0 ? "+" : "-",
                       sz[ axisSystem.mFrontVector.mAxis ],
@@ -270,28 +371,27 @@ void PrintAxisSystem( const AxisSystem& axisSystem ) {
                       sz[ axisSystem.mCoorSystem.mAxis ] );
 }
 
-void PrintAxisSystem( const FbxAxisSystem& axisSystem ) {
-    PrintAxisSystem( reinterpret_cast< const AxisSystem& >( axisSystem ) );
+void PrintAxisSystem( apemode::State& s, const FbxAxisSystem& axisSystem ) {
+    PrintAxisSystem( s, reinterpret_cast< const AxisSystem& >( axisSystem ) );
 }
 
-void ExportAxisSystem( FbxScene* pScene ) {
-    auto& s = apemode::State::Get( );
+void ExportAxisSystem( apemode::State& s, FbxScene* pScene ) {
     s.console->info( "\tCurrent axis system:" );
-    PrintAxisSystem( pScene->GetGlobalSettings( ).GetAxisSystem( ) );
+    PrintAxisSystem( s, pScene->GetGlobalSettings( ).GetAxisSystem( ) );
     s.console->info( "\tDirectX axis system:" );
-    PrintAxisSystem( FbxAxisSystem::DirectX );
+    PrintAxisSystem( s, FbxAxisSystem::DirectX );
     s.console->info( "\tOpenGL axis system:" );
-    PrintAxisSystem( FbxAxisSystem::OpenGL );
+    PrintAxisSystem( s, FbxAxisSystem::OpenGL );
     s.console->info( "\tMayaYUp axis system:" );
-    PrintAxisSystem( FbxAxisSystem::MayaYUp );
+    PrintAxisSystem( s, FbxAxisSystem::MayaYUp );
     s.console->info( "\tMayaZUp axis system:" );
-    PrintAxisSystem( FbxAxisSystem::MayaZUp );
+    PrintAxisSystem( s, FbxAxisSystem::MayaZUp );
     s.console->info( "\tLightwave axis system:" );
-    PrintAxisSystem( FbxAxisSystem::Lightwave );
+    PrintAxisSystem( s, FbxAxisSystem::Lightwave );
     s.console->info( "\tMax axis system:" );
-    PrintAxisSystem( FbxAxisSystem::Max );
+    PrintAxisSystem( s, FbxAxisSystem::Max );
     s.console->info( "\tMotionBuilder axis system:" );
-    PrintAxisSystem( FbxAxisSystem::Motionbuilder );
+    PrintAxisSystem( s, FbxAxisSystem::Motionbuilder );
 
     s.console->error( "\tConverting to viewer axis system ..." );
     // TODO: Check for the current axis system, and switch to Viewer's.
@@ -301,8 +401,7 @@ void ExportAxisSystem( FbxScene* pScene ) {
     s.console->error( "\tDone" );
 }
 
-void ExportBoundingBox( FbxScene* pScene ) {
-    auto&      s = apemode::State::Get( );
+void ExportBoundingBox( apemode::State& s, FbxScene* pScene ) {
     FbxVector4 bboxMin, bboxMax, bboxCenter;
     s.console->error( "\tCalculating the bounding box (bind pose) ..." );
     if ( pScene->ComputeBoundingBoxMinMaxCenter( bboxMin, bboxMax, bboxCenter ) ) {
@@ -325,27 +424,56 @@ void ExportBoundingBox( FbxScene* pScene ) {
     }
 }
 
-FBXPIPELINE_API void ExportScene( FbxScene* pScene ) {
-    auto& s = apemode::State::Get( );
-    InitializeSeachLocations( );
+FBXPIPELINE_API void ExportScene( apemode::State& s, FbxScene* pScene ) {
+    FBXP_PROFILE_SCOPE( "ExportScene" );
+    InitializeSeachLocations( s );
 
     // Pre-allocate nodes and attributes.
     s.nodes.reserve( (size_t) pScene->GetNodeCount( ) );
     s.meshes.reserve( (size_t) pScene->GetNodeCount( ) );
 
-    ExportAxisSystem( pScene );
-    ExportBoundingBox( pScene );
+    ExportAxisSystem( s, pScene );
+    ExportBoundingBox( s, pScene );
 
     // We want shared materials, so export all the scene material first
     // and reference them from the node scope by their indices.
-    ExportMaterials( pScene );
+    ExportMaterials( s, pScene );
 
     // Export nodes recursively.
-    PreprocessAnimation( pScene );
-    ExportNode( pScene->GetRootNode( ) );
-    ExportSkeletons( pScene->GetRootNode( ) );
+    {
+        FBXP_PROFILE_SCOPE( "PreprocessAnimation" );
+        PreprocessAnimation( s, pScene );
+    }
+    {
+        FBXP_PROFILE_SCOPE( "ExportNode" );
+        ExportNode( s, pScene->GetRootNode( ) );
+    }
+    {
+        FBXP_PROFILE_SCOPE( "ExportSkeletons" );
+        ExportSkeletons( s, pScene->GetRootNode( ) );
+    }
 
     // Export meshes.
-    PreprocessMeshes( pScene );
-    ExportMeshes( pScene->GetRootNode( ) );
+    {
+        FBXP_PROFILE_SCOPE( "PreprocessMeshes" );
+        PreprocessMeshes( s, pScene );
+    }
+
+    const size_t estimatedOutputSize = EstimateOutputSize( s, pScene );
+    s.console->info( "Estimated output size: {}", ToPrettySizeString( estimatedOutputSize ) );
+    s.builder.Reserve( s.builder.GetSize( ) + estimatedOutputSize );
+
+    {
+        FBXP_PROFILE_SCOPE( "ExportMeshes" );
+        ExportMeshes( s, pScene->GetRootNode( ) );
+    }
+
+    s.summary->info( "Exported nodes: {}, meshes: {}, skins: {}, materials: {}, textures: {}, curves: {}, files: {}",
+                     s.nodes.size( ),
+                     s.meshes.size( ),
+                     s.skins.size( ),
+                     s.materials.size( ),
+                     s.textures.size( ),
+                     s.animCurves.size( ),
+                     s.embeddedFiles.size( ) );
 }
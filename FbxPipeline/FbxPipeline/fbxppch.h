@@ -18,8 +18,14 @@
 // STL
 //
 
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 //
 // ThirdParty
@@ -27,6 +33,7 @@
 
 #include <flatbuffers/flatbuffers.h>
 #include <spdlog/spdlog.h>
+#include <spdlog/async_logger.h>
 #include <cxxopts.hpp>
 
 //
@@ -0,0 +1,125 @@
+#include <fbxppch.h>
+#include <fbxpstate.h>
+
+#include <fstream>
+
+bool MakeDirectory( const char* directory );
+void SplitFilename( const std::string& filePath, std::string* parentFolderName, std::string* fileName );
+
+void WriteJsonString( std::ostream& os, const std::string& value ) {
+    os << '"';
+    for ( const char c : value ) {
+        switch ( c ) {
+            case '"':  os << "\\\""; break;
+            case '\\': os << "\\\\"; break;
+            case '\n': os << "\\n"; break;
+            case '\r': os << "\\r"; break;
+            case '\t': os << "\\t"; break;
+            default:
+                if ( static_cast< unsigned char >( c ) < 0x20 ) {
+                    os << "\\u00" << "0123456789abcdef"[ ( c >> 4 ) & 0xf ] << "0123456789abcdef"[ c & 0xf ];
+                } else {
+                    os << c;
+                }
+                break;
+        }
+    }
+    os << '"';
+}
+
+apemode::Profiler& apemode::Profiler::Get( ) {
+    static Profiler profiler;
+    return profiler;
+}
+
+void apemode::Profiler::Enable( ) {
+    std::lock_guard< std::mutex > lock( mutex );
+    enabled   = true;
+    startTime = Clock::now( );
+    events.clear( );
+}
+
+uint32_t apemode::Profiler::GetThreadId( ) {
+    /* Called under the lock, the ids are small and stable for the viewer. */
+    const auto threadIdIt = threadIds.find( std::this_thread::get_id( ) );
+    if ( threadIdIt != threadIds.end( ) )
+        return threadIdIt->second;
+
+    const uint32_t threadId = static_cast< uint32_t >( threadIds.size( ) );
+    threadIds[ std::this_thread::get_id( ) ] = threadId;
+    return threadId;
+}
+
+void apemode::Profiler::Record( std::string name, std::string detail, Clock::time_point begin, Clock::time_point end ) {
+    ProfileEvent profileEvent;
+    profileEvent.name                 = std::move( name );
+    profileEvent.detail               = std::move( detail );
+    profileEvent.beginMicroseconds    = std::chrono::duration_cast< std::chrono::microseconds >( begin - startTime ).count( );
+    profileEvent.durationMicroseconds = std::chrono::duration_cast< std::chrono::microseconds >( end - begin ).count( );
+
+    std::lock_guard< std::mutex > lock( mutex );
+    profileEvent.threadId = GetThreadId( );
+    events.push_back( std::move( profileEvent ) );
+}
+
+bool apemode::Profiler::Save( const std::string& filePath ) {
+    auto& s = apemode::State::Get( );
+
+    std::string outputFolder;
+    SplitFilename( filePath, &outputFolder, nullptr );
+    if ( false == outputFolder.empty( ) )
+        MakeDirectory( outputFolder.c_str( ) );
+
+    std::ofstream os( filePath, std::ios::out | std::ios::trunc );
+    if ( false == os.good( ) ) {
+        s.console->error( "Failed to write trace to {}", filePath );
+        return false;
+    }
+
+    std::lock_guard< std::mutex > lock( mutex );
+
+    os << "{\"traceEvents\":[\n";
+    for ( size_t i = 0; i < events.size( ); ++i ) {
+        const ProfileEvent& profileEvent = events[ i ];
+
+        os << "{\"name\":";
+        WriteJsonString( os, profileEvent.name );
+        os << ",\"cat\":\"fbxp\",\"ph\":\"X\",\"pid\":0";
+        os << ",\"tid\":" << profileEvent.threadId;
+        os << ",\"ts\":" << profileEvent.beginMicroseconds;
+        os << ",\"dur\":" << profileEvent.durationMicroseconds;
+
+        if ( false == profileEvent.detail.empty( ) ) {
+            os << ",\"args\":{\"detail\":";
+            WriteJsonString( os, profileEvent.detail );
+            os << "}";
+        }
+
+        os << ( i + 1 < events.size( ) ? "},\n" : "}\n" );
+    }
+    os << "],\"displayTimeUnit\":\"ms\"}\n";
+
+    s.summary->info( "Saved trace ({} events) to {}", events.size( ), filePath );
+    return true;
+}
+
+apemode::ProfileScope::ProfileScope( const char* scopeName, const char* scopeDetail ) {
+    auto& p = Profiler::Get( );
+    if ( p.enabled ) {
+        profiler = &p;
+        name     = scopeName;
+        detail   = scopeDetail ? scopeDetail : "";
+        begin    = Profiler::Clock::now( );
+    }
+}
+
+apemode::ProfileScope::~ProfileScope( ) {
+    End( );
+}
+
+void apemode::ProfileScope::End( ) {
+    if ( profiler ) {
+        profiler->Record( name, std::move( detail ), begin, Profiler::Clock::now( ) );
+        profiler = nullptr;
+    }
+}
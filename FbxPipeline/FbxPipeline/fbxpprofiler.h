@@ -0,0 +1,60 @@
+#pragma once
+#include <fbxppch.h>
+
+/**
+ * Scoped profiling utilities.
+ * Scopes are recorded as complete events (begin + duration) per thread,
+ * and can be saved in the Chrome trace format (chrome://tracing, ui.perfetto.dev).
+ * Nested scopes on the same thread are displayed hierarchically.
+ **/
+
+namespace apemode {
+
+    struct FBXPIPELINE_API ProfileEvent {
+        std::string name;
+        std::string detail;
+        uint64_t    beginMicroseconds    = 0;
+        uint64_t    durationMicroseconds = 0;
+        uint32_t    threadId             = 0;
+    };
+
+    struct FBXPIPELINE_API Profiler {
+        typedef std::chrono::high_resolution_clock Clock;
+
+        std::vector< ProfileEvent >                    events;
+        std::unordered_map< std::thread::id, uint32_t > threadIds;
+        std::mutex                                     mutex;
+        Clock::time_point                              startTime = Clock::now( );
+        bool                                           enabled   = false;
+
+        void     Enable( );
+        void     Record( std::string name, std::string detail, Clock::time_point begin, Clock::time_point end );
+        uint32_t GetThreadId( );
+        bool     Save( const std::string& filePath );
+
+        /* Process-wide, the worker states (parallel batch mode) record into the same trace. */
+        static Profiler& Get( );
+    };
+
+    /**
+     * Records the time between its construction and destruction (or End call).
+     * The detail (node name, file path, ...) is shown in the event arguments.
+     * Does nothing when the profiler is disabled (no --trace argument).
+     **/
+    struct FBXPIPELINE_API ProfileScope {
+        Profiler*                   profiler = nullptr;
+        const char*                 name     = nullptr;
+        std::string                 detail;
+        Profiler::Clock::time_point begin;
+
+        ProfileScope( const char* scopeName, const char* scopeDetail = nullptr );
+        ~ProfileScope( );
+
+        void End( );
+    };
+
+} // namespace apemode
+
+#define FBXP_PROFILE_CONCAT_IMPL( a, b ) a##b
+#define FBXP_PROFILE_CONCAT( a, b ) FBXP_PROFILE_CONCAT_IMPL( a, b )
+#define FBXP_PROFILE_SCOPE( ... ) apemode::ProfileScope FBXP_PROFILE_CONCAT( profileScope, __LINE__ )( __VA_ARGS__ )
@@ -0,0 +1,116 @@
+#include <fbxppch.h>
+#include <fbxpstate.h>
+
+#include <fstream>
+
+bool MakeDirectory( const char* directory );
+void SplitFilename( const std::string& filePath, std::string* parentFolderName, std::string* fileName );
+void WriteJsonString( std::ostream& os, const std::string& value );
+
+void apemode::BuildReport::AddSection( const char* name, size_t offset ) {
+    SectionReport section;
+    section.name   = name;
+    section.offset = offset;
+    section.size   = offset - ( sections.empty( ) ? 0 : std::min( offset, sections.back( ).offset ) );
+    sections.push_back( section );
+}
+
+namespace {
+    void WriteJsonField( std::ostream& os, const char* key, const std::string& value, const char* separator ) {
+        os << '"' << key << "\":";
+        WriteJsonString( os, value );
+        os << separator;
+    }
+
+    template < typename T >
+    void WriteJsonField( std::ostream& os, const char* key, const T value, const char* separator ) {
+        os << '"' << key << "\":" << value << separator;
+    }
+
+    void WriteJson( std::ostream& os, const apemode::MeshReport& mesh ) {
+        os << "{";
+        WriteJsonField( os, "name", mesh.name, "," );
+        WriteJsonField( os, "controlPointCount", mesh.controlPointCount, "," );
+        WriteJsonField( os, "polygonCount", mesh.polygonCount, "," );
+        WriteJsonField( os, "vertexCount", mesh.vertexCount, "," );
+        WriteJsonField( os, "indexCount", mesh.indexCount, "," );
+        WriteJsonField( os, "subsetCount", mesh.subsetCount, "," );
+        WriteJsonField( os, "vertexFormat", mesh.vertexFormat, "," );
+        WriteJsonField( os, "indexType", mesh.indexType, "," );
+        WriteJsonField( os, "compressionType", mesh.compressionType, "," );
+        WriteJsonField( os, "blockCompressionType", mesh.blockCompressionType, "," );
+        WriteJsonField( os, "verticesSize", mesh.verticesSize, "," );
+        WriteJsonField( os, "indicesSize", mesh.indicesSize, "," );
+        WriteJsonField( os, "uncompressedSize", mesh.uncompressedSize, "," );
+        WriteJsonField( os, "compressionRatio", mesh.uncompressedSize ? double( mesh.verticesSize + mesh.indicesSize ) / mesh.uncompressedSize : 1.0, "," );
+        WriteJsonField( os, "encodeSeconds", mesh.encodeSeconds, "," );
+        WriteJsonField( os, "decodeSeconds", mesh.decodeSeconds, "" );
+        os << "}";
+    }
+
+    void WriteJson( std::ostream& os, const apemode::AnimCurveReport& curve ) {
+        os << "{";
+        WriteJsonField( os, "name", curve.name, "," );
+        WriteJsonField( os, "property", curve.property, "," );
+        WriteJsonField( os, "channel", curve.channel, "," );
+        WriteJsonField( os, "curveId", int64_t( curve.curveId == uint32_t( -1 ) ? -1 : curve.curveId ), "," );
+        WriteJsonField( os, "sourceKeyCount", curve.sourceKeyCount, "," );
+        WriteJsonField( os, "reducedKeyCount", curve.reducedKeyCount, "," );
+        WriteJsonField( os, "resampledKeyCount", curve.resampledKeyCount, "," );
+        WriteJsonField( os, "keyCount", curve.keyCount, "," );
+        WriteJsonField( os, "keyType", curve.keyType, "," );
+        WriteJsonField( os, "compressionType", curve.compressionType, "," );
+        WriteJsonField( os, "blockCompressionType", curve.blockCompressionType, "," );
+        WriteJsonField( os, "keysSize", curve.keysSize, "," );
+        WriteJsonField( os, "uncompressedSize", curve.uncompressedSize, "," );
+        WriteJsonField( os, "compressionRatio", curve.uncompressedSize ? double( curve.keysSize ) / curve.uncompressedSize : 1.0, "," );
+        WriteJsonField( os, "encodeSeconds", curve.encodeSeconds, "" );
+        os << "}";
+    }
+
+    void WriteJson( std::ostream& os, const apemode::SectionReport& section ) {
+        os << "{";
+        WriteJsonField( os, "name", section.name, "," );
+        WriteJsonField( os, "offset", section.offset, "," );
+        WriteJsonField( os, "size", section.size, "" );
+        os << "}";
+    }
+
+    template < typename T >
+    void WriteJsonArray( std::ostream& os, const char* key, const std::vector< T >& items, const char* separator ) {
+        os << '"' << key << "\":[\n";
+        for ( size_t i = 0; i < items.size( ); ++i ) {
+            WriteJson( os, items[ i ] );
+            os << ( i + 1 < items.size( ) ? ",\n" : "\n" );
+        }
+        os << "]" << separator;
+    }
+}
+
+bool apemode::BuildReport::Save( const std::string& filePath ) const {
+    auto& s = apemode::State::Get( );
+
+    std::string outputFolder;
+    SplitFilename( filePath, &outputFolder, nullptr );
+    if ( false == outputFolder.empty( ) )
+        MakeDirectory( outputFolder.c_str( ) );
+
+    std::ofstream os( filePath, std::ios::out | std::ios::trunc );
+    if ( false == os.good( ) ) {
+        s.console->error( "Failed to write report to {}", filePath );
+        return false;
+    }
+
+    os << "{";
+    WriteJsonField( os, "inputFile", inputFile, ",\n" );
+    WriteJsonField( os, "outputFile", outputFile, ",\n" );
+    WriteJsonField( os, "outputSize", outputSize, ",\n" );
+    WriteJsonField( os, "cached", cached ? "true" : "false", ",\n" );
+    WriteJsonArray( os, "sections", sections, ",\n" );
+    WriteJsonArray( os, "meshes", meshes, ",\n" );
+    WriteJsonArray( os, "animCurves", animCurves, "\n" );
+    os << "}\n";
+
+    s.summary->info( "Saved report ({} meshes, {} curves) to {}", meshes.size( ), animCurves.size( ), filePath );
+    return true;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <fbxppch.h>
+
+/**
+ * Machine-readable summary of the conversion (--report argument).
+ * Collected while exporting the scene and finalizing the buffer, saved as JSON.
+ * Sizes are in bytes, times are in seconds.
+ **/
+
+namespace apemode {
+
+    struct FBXPIPELINE_API MeshReport {
+        std::string name;
+        uint32_t    controlPointCount = 0; /* Source mesh */
+        uint32_t    polygonCount      = 0; /* Source mesh (after triangulation) */
+        uint32_t    vertexCount       = 0; /* Exported mesh */
+        uint32_t    indexCount        = 0; /* Exported mesh */
+        uint32_t    subsetCount       = 0;
+        std::string vertexFormat;
+        std::string indexType;
+        std::string compressionType;
+        std::string blockCompressionType; /* Zstd, LZ4 (--block-compression), applied after Draco or Meshopt */
+        size_t      verticesSize     = 0; /* Stored */
+        size_t      indicesSize      = 0; /* Stored */
+        size_t      uncompressedSize = 0; /* Vertices and indices before the compression */
+        double      encodeSeconds    = 0;
+        double      decodeSeconds    = 0; /* Meshopt and auto, measured on this machine */
+    };
+
+    struct FBXPIPELINE_API AnimCurveReport {
+        std::string name;
+        std::string property;
+        std::string channel;
+        uint32_t    curveId           = (uint32_t) -1; /* -1 for the curves that were not exported */
+        uint32_t    sourceKeyCount    = 0;
+        uint32_t    reducedKeyCount   = 0; /* Same as the source key count when reduction is disabled */
+        uint32_t    resampledKeyCount = 0; /* 0 when resampling is disabled */
+        uint32_t    keyCount          = 0; /* Exported keys */
+        std::string keyType;
+        std::string compressionType;
+        std::string blockCompressionType;
+        size_t      keysSize         = 0; /* Stored */
+        size_t      uncompressedSize = 0;
+        double      encodeSeconds    = 0;
+    };
+
+    /**
+     * The offsets are the builder sizes after the section was written (offset.o in State::Finalize),
+     * the sizes are the differences between the neighbouring offsets.
+     **/
+    struct FBXPIPELINE_API SectionReport {
+        std::string name;
+        size_t      offset = 0;
+        size_t      size   = 0;
+    };
+
+    struct FBXPIPELINE_API BuildReport {
+        std::string                    inputFile;
+        std::string                    outputFile;
+        size_t                         outputSize = 0;
+        bool                           cached     = false; /* Restored from the cache (--cache), no details */
+        std::vector< MeshReport >      meshes;
+        std::vector< AnimCurveReport > animCurves;
+        std::vector< SectionReport >   sections;
+
+        void AddSection( const char* name, size_t offset );
+        bool Save( const std::string& filePath ) const;
+    };
+
+} // namespace apemode
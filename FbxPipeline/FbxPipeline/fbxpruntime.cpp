@@ -0,0 +1,675 @@
+#include <runtime/FbxPipelineRuntime.h>
+
+#include <zstd.h>
+#include <lz4.h>
+#include <meshoptimizer.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Runtime loader (fbxp_runtime library), does not depend on the FBX SDK and the exporter.
+ * The block codecs and the meshopt decoder mirror fbxpblock.cpp and fbxpmeshcodec.cpp.
+ **/
+
+bool DecodeDracoMesh( const uint8_t*             pEncoded,
+                      size_t                     encodedSize,
+                      apemodefb::EVertexFormatFb vertexFormat,
+                      std::vector< uint8_t >&    vertices,
+                      std::vector< uint8_t >&    indices,
+                      apemodefb::EIndexTypeFb&   indexType );
+bool DecodeDracoCurveKeys( const uint8_t*                 pEncoded,
+                           size_t                         encodedSize,
+                           apemodefb::EAnimCurveKeyTypeFb keyType,
+                           std::vector< uint8_t >&        keys );
+
+namespace {
+    template < typename T, typename TVector >
+    apemode::runtime::Span< T > MakeSpan( const TVector* pVector ) {
+        if ( nullptr == pVector || 0 == pVector->size( ) )
+            return apemode::runtime::Span< T >( );
+        return apemode::runtime::Span< T >( reinterpret_cast< const T* >( pVector->Data( ) ), pVector->size( ) );
+    }
+
+    size_t GetIndexSize( apemodefb::EIndexTypeFb indexType ) {
+        return indexType == apemodefb::EIndexTypeFb_UInt16 ? sizeof( uint16_t ) : sizeof( uint32_t );
+    }
+
+    /* The verifier does not check the enums, the index type can be anything in a damaged file. */
+    bool IsIndexType( apemodefb::EIndexTypeFb indexType ) {
+        return indexType == apemodefb::EIndexTypeFb_UInt16 || indexType == apemodefb::EIndexTypeFb_UInt32;
+    }
+
+    /**
+     * The meshopt vertex codec spends at least 2 bits per 16 bytes, the index codec at least a byte per triangle (asserts whole triangles).
+     * The counts of a damaged file are checked against the encoded sizes before the buffers are allocated.
+     **/
+    bool IsMeshoptSizeValid( size_t vertexCount, size_t stride, size_t encodedVerticesSize, size_t indexCount, size_t encodedIndicesSize ) {
+        const uint64_t decodedVerticesSize = uint64_t( vertexCount ) * stride;
+        return decodedVerticesSize <= uint64_t( encodedVerticesSize ) * 64 &&
+               decodedVerticesSize <= std::numeric_limits< size_t >::max( ) &&
+               indexCount % 3 == 0 && indexCount / 3 <= encodedIndicesSize;
+    }
+
+    bool IsBlockCompressed( const apemodefb::BlockCompressionFb* pCompression ) {
+        return pCompression && pCompression->compression_type( ) != apemodefb::ECompressionTypeFb_None;
+    }
+
+    /* The destination size must match the uncompressed size exactly. */
+    bool DecompressBlock( apemodefb::ECompressionTypeFb compressionType, const void* src, size_t srcSize, void* dst, size_t dstSize ) {
+        switch ( compressionType ) {
+            case apemodefb::ECompressionTypeFb_Zstd: {
+                const size_t decompressedSize = ZSTD_decompress( dst, dstSize, src, srcSize );
+                return false == ZSTD_isError( decompressedSize ) && decompressedSize == dstSize;
+            }
+
+            case apemodefb::ECompressionTypeFb_LZ4: {
+                if ( srcSize > LZ4_MAX_INPUT_SIZE || dstSize > LZ4_MAX_INPUT_SIZE )
+                    return false;
+
+                const int decompressedSize = LZ4_decompress_safe( (const char*) src, (char*) dst, int( srcSize ), int( dstSize ) );
+                return decompressedSize >= 0 && size_t( decompressedSize ) == dstSize;
+            }
+
+            default:
+                return false;
+        }
+    }
+
+    /* The uncompressed size comes from the file, LZ4 expands a byte to 255 bytes at most, Zstd frames store the content size. */
+    bool IsUncompressedSizeValid( apemodefb::ECompressionTypeFb compressionType, const void* src, size_t srcSize, size_t dstSize ) {
+        switch ( compressionType ) {
+            case apemodefb::ECompressionTypeFb_Zstd:
+                return ZSTD_getFrameContentSize( src, srcSize ) == dstSize;
+            case apemodefb::ECompressionTypeFb_LZ4:
+                return uint64_t( dstSize ) <= uint64_t( srcSize ) * 255;
+            default:
+                return false;
+        }
+    }
+
+    /* Copies the plain bytes, or decompresses the block compressed ones. */
+    bool DecodeBytes( apemode::runtime::Span< uint8_t >    bytes,
+                      const apemodefb::BlockCompressionFb* pCompression,
+                      std::vector< uint8_t >&              decodedBytes ) {
+        if ( false == IsBlockCompressed( pCompression ) ) {
+            decodedBytes.assign( bytes.begin( ), bytes.end( ) );
+            return true;
+        }
+
+        if ( false == IsUncompressedSizeValid( pCompression->compression_type( ), bytes.data( ), bytes.size( ), pCompression->uncompressed_size( ) ) )
+            return false;
+
+        decodedBytes.resize( pCompression->uncompressed_size( ) );
+        return DecompressBlock( pCompression->compression_type( ), bytes.data( ), bytes.size( ), decodedBytes.data( ), decodedBytes.size( ) );
+    }
+
+    std::string GetFileFolder( const std::string& filePath ) {
+        const size_t separatorPos = filePath.find_last_of( "/\\" );
+        return separatorPos == std::string::npos ? std::string( ) : filePath.substr( 0, separatorPos + 1 );
+    }
+
+    bool IsPackedVertexFormat( apemodefb::EVertexFormatFb vertexFormat ) {
+        return vertexFormat == apemodefb::EVertexFormatFb_Default || vertexFormat == apemodefb::EVertexFormatFb_Skinned ||
+               vertexFormat == apemodefb::EVertexFormatFb_FatSkinned;
+    }
+
+    /* The tangent frame quaternion rotates the X axis to the normal and the Y axis to the tangent. */
+    apemodefb::Vec3Fb RotateAxisX( const apemodefb::QuatFb& q ) {
+        return apemodefb::Vec3Fb( 1 - 2 * ( q.ny( ) * q.ny( ) + q.nz( ) * q.nz( ) ),
+                                  2 * ( q.nx( ) * q.ny( ) + q.s( ) * q.nz( ) ),
+                                  2 * ( q.nx( ) * q.nz( ) - q.s( ) * q.ny( ) ) );
+    }
+
+    apemodefb::Vec3Fb RotateAxisY( const apemodefb::QuatFb& q ) {
+        return apemodefb::Vec3Fb( 2 * ( q.nx( ) * q.ny( ) - q.s( ) * q.nz( ) ),
+                                  1 - 2 * ( q.nx( ) * q.nx( ) + q.nz( ) * q.nz( ) ),
+                                  2 * ( q.ny( ) * q.nz( ) + q.s( ) * q.nx( ) ) );
+    }
+
+    /* The joint index is the integer part and the weight is the fractional part. */
+    void UnpackJoints( const apemodefb::Vec4Fb& packed, uint32_t* pJointIndices, float* pJointWeights ) {
+        const float values[] = {packed.x( ), packed.y( ), packed.z( ), packed.w( )};
+        for ( uint32_t i = 0; i < 4; ++i ) {
+            const float jointIndex = std::floor( values[ i ] );
+            pJointIndices[ i ]     = uint32_t( jointIndex );
+            pJointWeights[ i ]     = values[ i ] - jointIndex;
+        }
+    }
+
+    /* The joint indices are packed into the bytes, the weights are stored as is. */
+    void UnpackJoints( uint32_t packedIndices, const apemodefb::Vec4Fb& weights, uint32_t* pJointIndices, float* pJointWeights ) {
+        const float values[] = {weights.x( ), weights.y( ), weights.z( ), weights.w( )};
+        for ( uint32_t i = 0; i < 4; ++i ) {
+            pJointIndices[ i ] = ( packedIndices >> ( i * 8 ) ) & 0xff;
+            pJointWeights[ i ] = values[ i ];
+        }
+    }
+} // namespace
+
+//
+// MappedFile
+//
+
+apemode::runtime::MappedFile::~MappedFile( ) {
+    Close( );
+}
+
+bool apemode::runtime::MappedFile::Open( const std::string& filePath ) {
+    Close( );
+
+#ifdef _WIN32
+    HANDLE hFileHandle = CreateFileA( filePath.c_str( ), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+    if ( hFileHandle == INVALID_HANDLE_VALUE )
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if ( FALSE == GetFileSizeEx( hFileHandle, &fileSize ) || 0 == fileSize.QuadPart ) {
+        CloseHandle( hFileHandle );
+        return false;
+    }
+
+    HANDLE hMappingHandle = CreateFileMappingA( hFileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    if ( nullptr == hMappingHandle ) {
+        CloseHandle( hFileHandle );
+        return false;
+    }
+
+    const void* pView = MapViewOfFile( hMappingHandle, FILE_MAP_READ, 0, 0, 0 );
+    if ( nullptr == pView ) {
+        CloseHandle( hMappingHandle );
+        CloseHandle( hFileHandle );
+        return false;
+    }
+
+    hFile    = hFileHandle;
+    hMapping = hMappingHandle;
+    pData    = reinterpret_cast< const uint8_t* >( pView );
+    dataSize = size_t( fileSize.QuadPart );
+#else
+    const int fileDescriptor = open( filePath.c_str( ), O_RDONLY );
+    if ( fileDescriptor < 0 )
+        return false;
+
+    struct stat fileStat;
+    if ( fstat( fileDescriptor, &fileStat ) != 0 || 0 == fileStat.st_size ) {
+        close( fileDescriptor );
+        return false;
+    }
+
+    /* The mapping stays valid after the descriptor is closed. */
+    void* pView = mmap( nullptr, size_t( fileStat.st_size ), PROT_READ, MAP_PRIVATE, fileDescriptor, 0 );
+    close( fileDescriptor );
+    if ( pView == MAP_FAILED )
+        return false;
+
+    pData    = reinterpret_cast< const uint8_t* >( pView );
+    dataSize = size_t( fileStat.st_size );
+#endif
+
+    return true;
+}
+
+void apemode::runtime::MappedFile::Close( ) {
+    if ( nullptr == pData )
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile( pData );
+    CloseHandle( hMapping );
+    CloseHandle( hFile );
+    hMapping = nullptr;
+    hFile    = nullptr;
+#else
+    munmap( const_cast< uint8_t* >( pData ), dataSize );
+#endif
+
+    pData    = nullptr;
+    dataSize = 0;
+}
+
+//
+// VertexSpan
+//
+
+size_t apemode::runtime::GetVertexStride( apemodefb::EVertexFormatFb vertexFormat ) {
+    switch ( vertexFormat ) {
+        case apemodefb::EVertexFormatFb_Decompressed:           return sizeof( apemodefb::DecompressedVertexFb );
+        case apemodefb::EVertexFormatFb_DecompressedSkinned:    return sizeof( apemodefb::DecompressedSkinnedVertexFb );
+        case apemodefb::EVertexFormatFb_DecompressedFatSkinned: return sizeof( apemodefb::DecompressedFatSkinnedVertexFb );
+        case apemodefb::EVertexFormatFb_Default:                return sizeof( apemodefb::DefaultVertexFb );
+        case apemodefb::EVertexFormatFb_Skinned:                return sizeof( apemodefb::SkinnedVertexFb );
+        case apemodefb::EVertexFormatFb_FatSkinned:             return sizeof( apemodefb::FatSkinnedVertexFb );
+        default:                                                return 0;
+    }
+}
+
+apemode::runtime::VertexSpan::VertexSpan( apemodefb::EVertexFormatFb vertexFormat, const void* pVertices, size_t vertexCount )
+    : vertexFormat( vertexFormat )
+    , pVertices( reinterpret_cast< const uint8_t* >( pVertices ) )
+    , vertexCount( vertexCount )
+    , stride( GetVertexStride( vertexFormat ) ) {
+}
+
+/* The skinned vertices start with the unskinned ones, the attributes are read through the base structs. */
+
+apemodefb::Vec3Fb apemode::runtime::VertexSpan::GetPosition( size_t vertexIndex ) const {
+    assert( vertexIndex < vertexCount );
+    const uint8_t* pVertex = pVertices + stride * vertexIndex;
+    if ( IsPackedVertexFormat( vertexFormat ) )
+        return reinterpret_cast< const apemodefb::DefaultVertexFb* >( pVertex )->position( );
+    return reinterpret_cast< const apemodefb::DecompressedVertexFb* >( pVertex )->position( );
+}
+
+apemodefb::Vec2Fb apemode::runtime::VertexSpan::GetTexcoord( size_t vertexIndex ) const {
+    assert( vertexIndex < vertexCount );
+    const uint8_t* pVertex = pVertices + stride * vertexIndex;
+    if ( IsPackedVertexFormat( vertexFormat ) )
+        return reinterpret_cast< const apemodefb::DefaultVertexFb* >( pVertex )->uv( );
+    return reinterpret_cast< const apemodefb::DecompressedVertexFb* >( pVertex )->uv( );
+}
+
+apemodefb::Vec3Fb apemode::runtime::VertexSpan::GetNormal( size_t vertexIndex ) const {
+    assert( vertexIndex < vertexCount );
+    const uint8_t* pVertex = pVertices + stride * vertexIndex;
+    if ( IsPackedVertexFormat( vertexFormat ) )
+        return RotateAxisX( reinterpret_cast< const apemodefb::DefaultVertexFb* >( pVertex )->qtangent( ) );
+    return reinterpret_cast< const apemodefb::DecompressedVertexFb* >( pVertex )->normal( );
+}
+
+apemodefb::Vec4Fb apemode::runtime::VertexSpan::GetTangent( size_t vertexIndex ) const {
+    assert( vertexIndex < vertexCount );
+    const uint8_t* pVertex = pVertices + stride * vertexIndex;
+    if ( IsPackedVertexFormat( vertexFormat ) ) {
+        /* The negative quaternion scalar marks the reflected frame. */
+        const apemodefb::QuatFb& q = reinterpret_cast< const apemodefb::DefaultVertexFb* >( pVertex )->qtangent( );
+        const apemodefb::Vec3Fb  t = RotateAxisY( q );
+        return apemodefb::Vec4Fb( t.x( ), t.y( ), t.z( ), q.s( ) < 0 ? -1.0f : 1.0f );
+    }
+
+    /* The lowest bit of the packed value is set for the positive bitangent sign. */
+    const auto& vertex = *reinterpret_cast< const apemodefb::DecompressedVertexFb* >( pVertex );
+    return apemodefb::Vec4Fb( vertex.tangent( ).x( ), vertex.tangent( ).y( ), vertex.tangent( ).z( ), ( vertex.reflection_index_packed( ) & 0x1 ) ? 1.0f : -1.0f );
+}
+
+apemodefb::Vec4Fb apemode::runtime::VertexSpan::GetColor( size_t vertexIndex ) const {
+    assert( vertexIndex < vertexCount );
+    const uint8_t* pVertex = pVertices + stride * vertexIndex;
+    if ( IsPackedVertexFormat( vertexFormat ) ) {
+        /* The bytes are the vertex index within the triangle, then red, green and blue. */
+        const auto&    vertex = *reinterpret_cast< const apemodefb::DefaultVertexFb* >( pVertex );
+        const uint32_t irgb   = vertex.index_color_RGB( );
+        return apemodefb::Vec4Fb( ( ( irgb >> 8 ) & 0xff ) / 255.0f, ( ( irgb >> 16 ) & 0xff ) / 255.0f, ( ( irgb >> 24 ) & 0xff ) / 255.0f, vertex.color_alpha( ) );
+    }
+    return reinterpret_cast< const apemodefb::DecompressedVertexFb* >( pVertex )->color( );
+}
+
+uint32_t apemode::runtime::VertexSpan::GetJoints( size_t vertexIndex, uint32_t ( &jointIndices )[ 8 ], float ( &jointWeights )[ 8 ] ) const {
+    assert( vertexIndex < vertexCount );
+    const uint8_t* pVertex = pVertices + stride * vertexIndex;
+    switch ( vertexFormat ) {
+        case apemodefb::EVertexFormatFb_DecompressedSkinned: {
+            const auto& vertex = *reinterpret_cast< const apemodefb::DecompressedSkinnedVertexFb* >( pVertex );
+            UnpackJoints( vertex.joint_indices( ), vertex.joint_weights( ), jointIndices, jointWeights );
+            return 4;
+        }
+        case apemodefb::EVertexFormatFb_DecompressedFatSkinned: {
+            const auto& vertex = *reinterpret_cast< const apemodefb::DecompressedFatSkinnedVertexFb* >( pVertex );
+            UnpackJoints( vertex.decompressed_skinned( ).joint_indices( ), vertex.decompressed_skinned( ).joint_weights( ), jointIndices, jointWeights );
+            UnpackJoints( vertex.extra_joint_indices( ), vertex.extra_joint_weights( ), jointIndices + 4, jointWeights + 4 );
+            return 8;
+        }
+        case apemodefb::EVertexFormatFb_Skinned: {
+            const auto& vertex = *reinterpret_cast< const apemodefb::SkinnedVertexFb* >( pVertex );
+            UnpackJoints( vertex.joint_indices_weights( ), jointIndices, jointWeights );
+            return 4;
+        }
+        case apemodefb::EVertexFormatFb_FatSkinned: {
+            const auto& vertex = *reinterpret_cast< const apemodefb::FatSkinnedVertexFb* >( pVertex );
+            UnpackJoints( vertex.skinned_vertex( ).joint_indices_weights( ), jointIndices, jointWeights );
+            UnpackJoints( vertex.extra_joint_indices_weights( ), jointIndices + 4, jointWeights + 4 );
+            return 8;
+        }
+        default:
+            return 0;
+    }
+}
+
+//
+// SceneFile
+//
+
+apemode::runtime::SceneFile::~SceneFile( ) {
+    Unload( );
+}
+
+bool apemode::runtime::SceneFile::Load( const std::string& sceneFilePath, EVerification verification ) {
+    Unload( );
+
+    if ( false == mappedFile.Open( sceneFilePath ) )
+        return false;
+
+    /* The identifier is checked in any case, it is cheap and filters out the wrong files. */
+    if ( mappedFile.GetSize( ) < sizeof( flatbuffers::uoffset_t ) + flatbuffers::kFileIdentifierLength ||
+         false == apemodefb::SceneFbBufferHasIdentifier( mappedFile.GetData( ) ) ) {
+        Unload( );
+        return false;
+    }
+
+    filePath          = sceneFilePath;
+    verificationState = verification == eVerification_None ? eVerificationState_Succeeded : eVerificationState_Pending;
+
+    if ( verification == eVerification_OnLoad && false == Verify( ) ) {
+        Unload( );
+        return false;
+    }
+
+    return true;
+}
+
+void apemode::runtime::SceneFile::Unload( ) {
+    std::lock_guard< std::mutex > lock( blobFilesMutex );
+    blobFiles.clear( );
+    mappedFile.Close( );
+    filePath.clear( );
+    verificationState = eVerificationState_Pending;
+}
+
+bool apemode::runtime::SceneFile::Verify( ) {
+    if ( verificationState != eVerificationState_Pending )
+        return verificationState == eVerificationState_Succeeded;
+
+    std::lock_guard< std::mutex > lock( verificationMutex );
+    if ( verificationState == eVerificationState_Pending ) {
+        if ( false == mappedFile.IsOpen( ) )
+            return false;
+
+        /* The scenes can have many tables, the default limit is too low for them. */
+        flatbuffers::Verifier verifier( mappedFile.GetData( ), mappedFile.GetSize( ), 64, std::numeric_limits< flatbuffers::uoffset_t >::max( ) );
+
+        const bool verified = apemodefb::VerifySceneFbBuffer( verifier ) &&
+                              apemodefb::GetSceneFb( mappedFile.GetData( ) )->version( ) == apemodefb::EVersionFb_Value;
+
+        verificationState = verified ? eVerificationState_Succeeded : eVerificationState_Failed;
+    }
+
+    return verificationState == eVerificationState_Succeeded;
+}
+
+const apemodefb::SceneFb* apemode::runtime::SceneFile::GetScene( ) {
+    if ( false == mappedFile.IsOpen( ) || false == Verify( ) )
+        return nullptr;
+    return apemodefb::GetSceneFb( mappedFile.GetData( ) );
+}
+
+const apemodefb::MeshFb* apemode::runtime::SceneFile::GetMesh( uint32_t meshIndex ) {
+    const apemodefb::SceneFb* pScene = GetScene( );
+    if ( nullptr == pScene || nullptr == pScene->meshes( ) || meshIndex >= pScene->meshes( )->size( ) )
+        return nullptr;
+    return pScene->meshes( )->Get( meshIndex );
+}
+
+const apemodefb::AnimCurveFb* apemode::runtime::SceneFile::GetCurve( uint32_t curveIndex ) {
+    const apemodefb::SceneFb* pScene = GetScene( );
+    if ( nullptr == pScene || nullptr == pScene->anim_curves( ) || curveIndex >= pScene->anim_curves( )->size( ) )
+        return nullptr;
+    return pScene->anim_curves( )->Get( curveIndex );
+}
+
+const apemodefb::FileFb* apemode::runtime::SceneFile::GetFile( uint32_t fileIndex ) {
+    const apemodefb::SceneFb* pScene = GetScene( );
+    if ( nullptr == pScene || nullptr == pScene->files( ) || fileIndex >= pScene->files( )->size( ) )
+        return nullptr;
+    return pScene->files( )->Get( fileIndex );
+}
+
+/**
+ * Returns the inlined bytes, or the bytes of the sidecar blob file (--split-blobs).
+ * The blob files are mapped on the first access, the ranges are checked since the verifier does not see them.
+ **/
+apemode::runtime::Span< uint8_t > apemode::runtime::SceneFile::GetBytes( const flatbuffers::Vector< uint8_t >* pInlined,
+                                                                          const apemodefb::BlobRefFb*           pBlob ) {
+    if ( pInlined && pInlined->size( ) )
+        return Span< uint8_t >( pInlined->Data( ), pInlined->size( ) );
+    if ( nullptr == pBlob || 0 == pBlob->size( ) )
+        return Span< uint8_t >( );
+
+    const apemodefb::SceneFb* pScene = GetScene( );
+    if ( nullptr == pScene || nullptr == pScene->blob_files( ) || pBlob->blob_file_id( ) >= pScene->blob_files( )->size( ) )
+        return Span< uint8_t >( );
+
+    std::lock_guard< std::mutex > lock( blobFilesMutex );
+    if ( blobFiles.empty( ) )
+        blobFiles.resize( pScene->blob_files( )->size( ) );
+
+    std::unique_ptr< MappedFile >& blobFile = blobFiles[ pBlob->blob_file_id( ) ];
+    if ( nullptr == blobFile ) {
+        blobFile.reset( new MappedFile( ) );
+        blobFile->Open( GetFileFolder( filePath ) + pScene->blob_files( )->Get( pBlob->blob_file_id( ) )->str( ) );
+    }
+
+    if ( false == blobFile->IsOpen( ) || pBlob->offset( ) > blobFile->GetSize( ) || pBlob->size( ) > blobFile->GetSize( ) - pBlob->offset( ) )
+        return Span< uint8_t >( );
+
+    return Span< uint8_t >( blobFile->GetData( ) + pBlob->offset( ), pBlob->size( ) );
+}
+
+apemode::runtime::Span< apemodefb::SubmeshFb > apemode::runtime::SceneFile::GetSubmeshes( uint32_t meshIndex ) {
+    const apemodefb::MeshFb* pMesh = GetMesh( meshIndex );
+    return pMesh ? MakeSpan< apemodefb::SubmeshFb >( pMesh->submeshes( ) ) : Span< apemodefb::SubmeshFb >( );
+}
+
+apemode::runtime::Span< apemodefb::SubsetFb > apemode::runtime::SceneFile::GetSubsets( uint32_t meshIndex ) {
+    const apemodefb::MeshFb* pMesh = GetMesh( meshIndex );
+    return pMesh ? MakeSpan< apemodefb::SubsetFb >( pMesh->subsets( ) ) : Span< apemodefb::SubsetFb >( );
+}
+
+apemode::runtime::Span< uint8_t > apemode::runtime::SceneFile::GetVertexBytes( uint32_t meshIndex ) {
+    const apemodefb::MeshFb* pMesh = GetMesh( meshIndex );
+    return pMesh ? GetBytes( pMesh->vertices( ), pMesh->vertices_blob( ) ) : Span< uint8_t >( );
+}
+
+apemode::runtime::Span< uint8_t > apemode::runtime::SceneFile::GetIndexBytes( uint32_t meshIndex ) {
+    const apemodefb::MeshFb* pMesh = GetMesh( meshIndex );
+    return pMesh ? GetBytes( pMesh->indices( ), pMesh->indices_blob( ) ) : Span< uint8_t >( );
+}
+
+bool apemode::runtime::SceneFile::IsMeshEncoded( uint32_t meshIndex ) {
+    const apemodefb::MeshFb* pMesh = GetMesh( meshIndex );
+    if ( nullptr == pMesh )
+        return false;
+    if ( IsBlockCompressed( pMesh->vertices_compression( ) ) || IsBlockCompressed( pMesh->indices_compression( ) ) )
+        return true;
+
+    for ( const auto& submesh : GetSubmeshes( meshIndex ) ) {
+        if ( submesh.compression_type( ) != apemodefb::ECompressionTypeFb_None )
+            return true;
+    }
+
+    return false;
+}
+
+apemode::runtime::VertexSpan apemode::runtime::SceneFile::GetVertices( uint32_t meshIndex ) {
+    const Span< apemodefb::SubmeshFb > submeshes = GetSubmeshes( meshIndex );
+    if ( submeshes.empty( ) || IsMeshEncoded( meshIndex ) )
+        return VertexSpan( );
+
+    const apemodefb::EVertexFormatFb vertexFormat = submeshes[ 0 ].vertex_format( );
+    const size_t                     stride       = GetVertexStride( vertexFormat );
+    const Span< uint8_t >            bytes        = GetVertexBytes( meshIndex );
+    return stride ? VertexSpan( vertexFormat, bytes.data( ), bytes.size( ) / stride ) : VertexSpan( );
+}
+
+apemode::runtime::IndexSpan apemode::runtime::SceneFile::GetIndices( uint32_t meshIndex ) {
+    const apemodefb::MeshFb* pMesh = GetMesh( meshIndex );
+    if ( nullptr == pMesh || IsMeshEncoded( meshIndex ) )
+        return IndexSpan( );
+
+    if ( false == IsIndexType( pMesh->index_type( ) ) )
+        return IndexSpan( );
+
+    const Span< uint8_t > bytes = GetIndexBytes( meshIndex );
+    return IndexSpan( pMesh->index_type( ), bytes.data( ), bytes.size( ) / GetIndexSize( pMesh->index_type( ) ) );
+}
+
+apemode::runtime::Span< apemodefb::NodeOrderFb > apemode::runtime::SceneFile::GetNodeOrder( ) {
+    const apemodefb::SceneFb* pScene = GetScene( );
+    return pScene ? MakeSpan< apemodefb::NodeOrderFb >( pScene->node_order( ) ) : Span< apemodefb::NodeOrderFb >( );
+}
+
+apemode::runtime::Span< apemodefb::NodeLevelFb > apemode::runtime::SceneFile::GetNodeLevels( ) {
+    const apemodefb::SceneFb* pScene = GetScene( );
+    return pScene ? MakeSpan< apemodefb::NodeLevelFb >( pScene->node_levels( ) ) : Span< apemodefb::NodeLevelFb >( );
+}
+
+apemode::runtime::Span< uint32_t > apemode::runtime::SceneFile::GetSkinLinks( uint32_t skinIndex ) {
+    const apemodefb::SceneFb* pScene = GetScene( );
+    if ( nullptr == pScene || nullptr == pScene->skins( ) || skinIndex >= pScene->skins( )->size( ) )
+        return Span< uint32_t >( );
+    return MakeSpan< uint32_t >( pScene->skins( )->Get( skinIndex )->links_ids( ) );
+}
+
+apemode::runtime::Span< apemodefb::Mat4Fb > apemode::runtime::SceneFile::GetInvBindPoseMatrices( uint32_t skinIndex ) {
+    const apemodefb::SceneFb* pScene = GetScene( );
+    if ( nullptr == pScene || nullptr == pScene->skins( ) || skinIndex >= pScene->skins( )->size( ) )
+        return Span< apemodefb::Mat4Fb >( );
+    return MakeSpan< apemodefb::Mat4Fb >( pScene->skins( )->Get( skinIndex )->inv_bind_pose_matrices( ) );
+}
+
+apemode::runtime::Span< uint8_t > apemode::runtime::SceneFile::GetCurveKeyBytes( uint32_t curveIndex ) {
+    const apemodefb::AnimCurveFb* pCurve = GetCurve( curveIndex );
+    return pCurve ? GetBytes( pCurve->keys( ), pCurve->keys_blob( ) ) : Span< uint8_t >( );
+}
+
+bool apemode::runtime::SceneFile::IsCurveEncoded( uint32_t curveIndex ) {
+    const apemodefb::AnimCurveFb* pCurve = GetCurve( curveIndex );
+    return pCurve && ( pCurve->compression_type( ) != apemodefb::ECompressionTypeFb_None || IsBlockCompressed( pCurve->keys_compression( ) ) );
+}
+
+apemode::runtime::Span< apemodefb::AnimCurveResampledKeyFb > apemode::runtime::SceneFile::GetResampledKeys( uint32_t curveIndex ) {
+    const apemodefb::AnimCurveFb* pCurve = GetCurve( curveIndex );
+    if ( nullptr == pCurve || pCurve->key_type( ) != apemodefb::EAnimCurveKeyTypeFb_Resampled || IsCurveEncoded( curveIndex ) )
+        return Span< apemodefb::AnimCurveResampledKeyFb >( );
+
+    const Span< uint8_t > bytes = GetCurveKeyBytes( curveIndex );
+    return Span< apemodefb::AnimCurveResampledKeyFb >( reinterpret_cast< const apemodefb::AnimCurveResampledKeyFb* >( bytes.data( ) ),
+                                                       bytes.size( ) / sizeof( apemodefb::AnimCurveResampledKeyFb ) );
+}
+
+apemode::runtime::Span< apemodefb::AnimCurveCubicKeyFb > apemode::runtime::SceneFile::GetCubicKeys( uint32_t curveIndex ) {
+    const apemodefb::AnimCurveFb* pCurve = GetCurve( curveIndex );
+    if ( nullptr == pCurve || pCurve->key_type( ) != apemodefb::EAnimCurveKeyTypeFb_Cubic || IsCurveEncoded( curveIndex ) )
+        return Span< apemodefb::AnimCurveCubicKeyFb >( );
+
+    const Span< uint8_t > bytes = GetCurveKeyBytes( curveIndex );
+    return Span< apemodefb::AnimCurveCubicKeyFb >( reinterpret_cast< const apemodefb::AnimCurveCubicKeyFb* >( bytes.data( ) ),
+                                                   bytes.size( ) / sizeof( apemodefb::AnimCurveCubicKeyFb ) );
+}
+
+apemode::runtime::Span< uint8_t > apemode::runtime::SceneFile::GetFileBytes( uint32_t fileIndex ) {
+    const apemodefb::FileFb* pFile = GetFile( fileIndex );
+    return pFile ? GetBytes( pFile->buffer( ), pFile->buffer_blob( ) ) : Span< uint8_t >( );
+}
+
+bool apemode::runtime::SceneFile::IsFileEncoded( uint32_t fileIndex ) {
+    const apemodefb::FileFb* pFile = GetFile( fileIndex );
+    return pFile && IsBlockCompressed( pFile->buffer_compression( ) );
+}
+
+bool apemode::runtime::SceneFile::DecodeMesh( uint32_t                meshIndex,
+                                              std::vector< uint8_t >& vertices,
+                                              std::vector< uint8_t >& indices,
+                                              VertexSpan&             vertexSpan,
+                                              IndexSpan&              indexSpan ) {
+    const apemodefb::MeshFb*           pMesh     = GetMesh( meshIndex );
+    const Span< apemodefb::SubmeshFb > submeshes = GetSubmeshes( meshIndex );
+    if ( nullptr == pMesh || submeshes.empty( ) )
+        return false;
+
+    const apemodefb::SubmeshFb&      submesh      = submeshes[ 0 ];
+    const apemodefb::EVertexFormatFb vertexFormat = submesh.vertex_format( );
+    const size_t                     stride       = GetVertexStride( vertexFormat );
+    apemodefb::EIndexTypeFb          indexType    = pMesh->index_type( );
+    if ( 0 == stride || false == IsIndexType( indexType ) )
+        return false;
+
+    /* The intermediate buffers are reused by the decoding threads. */
+    thread_local std::vector< uint8_t > vertexBlock;
+    thread_local std::vector< uint8_t > indexBlock;
+    if ( false == DecodeBytes( GetVertexBytes( meshIndex ), pMesh->vertices_compression( ), vertexBlock ) ||
+         false == DecodeBytes( GetIndexBytes( meshIndex ), pMesh->indices_compression( ), indexBlock ) )
+        return false;
+
+    switch ( submesh.compression_type( ) ) {
+        case apemodefb::ECompressionTypeFb_None:
+            vertices.swap( vertexBlock );
+            indices.swap( indexBlock );
+            break;
+
+        /* The submesh vertex count is the welded one, the index count is the original one. */
+        case apemodefb::ECompressionTypeFb_Meshopt:
+            if ( false == IsMeshoptSizeValid( submesh.vertex_count( ), stride, vertexBlock.size( ), submesh.index_count( ), indexBlock.size( ) ) )
+                return false;
+
+            vertices.resize( submesh.vertex_count( ) * stride );
+            indices.resize( submesh.index_count( ) * GetIndexSize( indexType ) );
+            if ( 0 != meshopt_decodeVertexBuffer( vertices.data( ), submesh.vertex_count( ), stride, vertexBlock.data( ), vertexBlock.size( ) ) ||
+                 0 != meshopt_decodeIndexBuffer( indices.data( ), submesh.index_count( ), GetIndexSize( indexType ), indexBlock.data( ), indexBlock.size( ) ) )
+                return false;
+            break;
+
+        /* The vertices buffer holds the Draco mesh, the index type is picked for the decoded vertex count. */
+        case apemodefb::ECompressionTypeFb_GoogleDraco3D:
+            if ( false == DecodeDracoMesh( vertexBlock.data( ), vertexBlock.size( ), vertexFormat, vertices, indices, indexType ) )
+                return false;
+            break;
+
+        default:
+            return false;
+    }
+
+    vertexSpan = VertexSpan( vertexFormat, vertices.data( ), vertices.size( ) / stride );
+    indexSpan  = IndexSpan( indexType, indices.data( ), indices.size( ) / GetIndexSize( indexType ) );
+    return true;
+}
+
+bool apemode::runtime::SceneFile::DecodeCurveKeys( uint32_t curveIndex, std::vector< uint8_t >& keys ) {
+    const apemodefb::AnimCurveFb* pCurve = GetCurve( curveIndex );
+    if ( nullptr == pCurve )
+        return false;
+
+    switch ( pCurve->compression_type( ) ) {
+        case apemodefb::ECompressionTypeFb_None:
+            return DecodeBytes( GetCurveKeyBytes( curveIndex ), pCurve->keys_compression( ), keys );
+
+        case apemodefb::ECompressionTypeFb_GoogleDraco3D: {
+            thread_local std::vector< uint8_t > keyBlock;
+            return DecodeBytes( GetCurveKeyBytes( curveIndex ), pCurve->keys_compression( ), keyBlock ) &&
+                   DecodeDracoCurveKeys( keyBlock.data( ), keyBlock.size( ), pCurve->key_type( ), keys );
+        }
+
+        default:
+            return false;
+    }
+}
+
+bool apemode::runtime::SceneFile::DecodeFile( uint32_t fileIndex, std::vector< uint8_t >& buffer ) {
+    const apemodefb::FileFb* pFile = GetFile( fileIndex );
+    return pFile && DecodeBytes( GetFileBytes( fileIndex ), pFile->buffer_compression( ), buffer );
+}
@@ -0,0 +1,472 @@
+#include <runtime/FbxPipelineRuntime.h>
+
+#include <draco/compression/decode.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+/**
+ * Draco decoders and the decode service of the runtime loader (fbxp_runtime library).
+ * The attribute layouts mirror the encoders in fbxpmesh.cpp and fbxpanimation.cpp.
+ **/
+
+namespace {
+    /* The unique ids of the Draco attributes, the mesh encoder adds them in this order. */
+    enum EDracoMeshAttribute {
+        eDracoMeshAttribute_Position,
+        eDracoMeshAttribute_Texcoord,
+        eDracoMeshAttribute_Normal,
+        eDracoMeshAttribute_Tangent,
+        eDracoMeshAttribute_Color,
+        eDracoMeshAttribute_Reflection,
+        eDracoMeshAttribute_JointIndices,
+        eDracoMeshAttribute_JointWeights,
+        eDracoMeshAttribute_ExtraJointIndices,
+        eDracoMeshAttribute_ExtraJointWeights,
+        eDracoMeshAttribute_Count
+    };
+
+    /* The unique ids of the Draco attributes, the curve encoder adds them in this order. */
+    enum EDracoCurveAttribute {
+        eDracoCurveAttribute_Values,
+        eDracoCurveAttribute_Time,
+        eDracoCurveAttribute_InterpolationMode,
+        eDracoCurveAttribute_Count
+    };
+
+    template < typename T, int TComponentCount >
+    bool ReadAttribute( const draco::PointAttribute* pAttribute, draco::PointIndex pointIndex, T* pValues ) {
+        return pAttribute && pAttribute->ConvertValue< T, TComponentCount >( pAttribute->mapped_index( pointIndex ), pValues );
+    }
+
+    bool ReadJointIndices( const draco::PointAttribute* pAttribute, draco::PointIndex pointIndex, uint32_t& jointIndices ) {
+        uint8_t indices[ 4 ] = {};
+        if ( false == ReadAttribute< uint8_t, 4 >( pAttribute, pointIndex, indices ) )
+            return false;
+
+        jointIndices = uint32_t( indices[ 0 ] ) | ( uint32_t( indices[ 1 ] ) << 8 ) | ( uint32_t( indices[ 2 ] ) << 16 ) |
+                       ( uint32_t( indices[ 3 ] ) << 24 );
+        return true;
+    }
+
+    bool ReadVec4( const draco::PointAttribute* pAttribute, draco::PointIndex pointIndex, apemodefb::Vec4Fb& value ) {
+        float values[ 4 ] = {};
+        if ( false == ReadAttribute< float, 4 >( pAttribute, pointIndex, values ) )
+            return false;
+
+        value = apemodefb::Vec4Fb( values[ 0 ], values[ 1 ], values[ 2 ], values[ 3 ] );
+        return true;
+    }
+
+    bool ReadDecompressedVertex( const draco::PointAttribute* const ( &attributes )[ eDracoMeshAttribute_Count ],
+                                 draco::PointIndex                  pointIndex,
+                                 apemodefb::DecompressedVertexFb&   vertex ) {
+        float   position[ 3 ]  = {};
+        float   uv[ 2 ]        = {};
+        float   normal[ 3 ]    = {};
+        float   tangent[ 3 ]   = {};
+        uint8_t reflection[ 1 ] = {};
+
+        if ( false == ReadAttribute< float, 3 >( attributes[ eDracoMeshAttribute_Position ], pointIndex, position ) ||
+             false == ReadAttribute< float, 2 >( attributes[ eDracoMeshAttribute_Texcoord ], pointIndex, uv ) ||
+             false == ReadAttribute< float, 3 >( attributes[ eDracoMeshAttribute_Normal ], pointIndex, normal ) ||
+             false == ReadAttribute< float, 3 >( attributes[ eDracoMeshAttribute_Tangent ], pointIndex, tangent ) ||
+             false == ReadVec4( attributes[ eDracoMeshAttribute_Color ], pointIndex, vertex.mutable_color( ) ) ||
+             false == ReadAttribute< uint8_t, 1 >( attributes[ eDracoMeshAttribute_Reflection ], pointIndex, reflection ) )
+            return false;
+
+        vertex.mutable_position( ) = apemodefb::Vec3Fb( position[ 0 ], position[ 1 ], position[ 2 ] );
+        vertex.mutable_uv( )       = apemodefb::Vec2Fb( uv[ 0 ], uv[ 1 ] );
+        vertex.mutable_normal( )   = apemodefb::Vec3Fb( normal[ 0 ], normal[ 1 ], normal[ 2 ] );
+        vertex.mutable_tangent( )  = apemodefb::Vec3Fb( tangent[ 0 ], tangent[ 1 ], tangent[ 2 ] );
+        vertex.mutate_reflection_index_packed( reflection[ 0 ] );
+        return true;
+    }
+
+    bool ReadDecompressedSkinnedVertex( const draco::PointAttribute* const ( &attributes )[ eDracoMeshAttribute_Count ],
+                                        draco::PointIndex                       pointIndex,
+                                        apemodefb::DecompressedSkinnedVertexFb& vertex ) {
+        uint32_t jointIndices = 0;
+        if ( false == ReadDecompressedVertex( attributes, pointIndex, vertex.mutable_decompressed( ) ) ||
+             false == ReadJointIndices( attributes[ eDracoMeshAttribute_JointIndices ], pointIndex, jointIndices ) ||
+             false == ReadVec4( attributes[ eDracoMeshAttribute_JointWeights ], pointIndex, vertex.mutable_joint_weights( ) ) )
+            return false;
+
+        vertex.mutate_joint_indices( jointIndices );
+        return true;
+    }
+
+    bool ReadDecompressedFatSkinnedVertex( const draco::PointAttribute* const ( &attributes )[ eDracoMeshAttribute_Count ],
+                                           draco::PointIndex                          pointIndex,
+                                           apemodefb::DecompressedFatSkinnedVertexFb& vertex ) {
+        uint32_t extraJointIndices = 0;
+        if ( false == ReadDecompressedSkinnedVertex( attributes, pointIndex, vertex.mutable_decompressed_skinned( ) ) ||
+             false == ReadJointIndices( attributes[ eDracoMeshAttribute_ExtraJointIndices ], pointIndex, extraJointIndices ) ||
+             false == ReadVec4( attributes[ eDracoMeshAttribute_ExtraJointWeights ], pointIndex, vertex.mutable_extra_joint_weights( ) ) )
+            return false;
+
+        vertex.mutate_extra_joint_indices( extraJointIndices );
+        return true;
+    }
+
+    template < typename TIndex >
+    void WriteIndices( const draco::Mesh& mesh, std::vector< uint8_t >& indices ) {
+        indices.resize( mesh.num_faces( ) * 3 * sizeof( TIndex ) );
+
+        TIndex* pIndices = reinterpret_cast< TIndex* >( indices.data( ) );
+        for ( uint32_t i = 0; i < mesh.num_faces( ); ++i ) {
+            const draco::Mesh::Face& face = mesh.face( draco::FaceIndex( i ) );
+            *pIndices++ = TIndex( face[ 0 ].value( ) );
+            *pIndices++ = TIndex( face[ 1 ].value( ) );
+            *pIndices++ = TIndex( face[ 2 ].value( ) );
+        }
+    }
+
+    struct DecodedCurveKey {
+        float   time;
+        float   values[ 3 ];
+        uint8_t interpolationMode;
+    };
+} // namespace
+
+bool DecodeDracoMesh( const uint8_t*             pEncoded,
+                      size_t                     encodedSize,
+                      apemodefb::EVertexFormatFb vertexFormat,
+                      std::vector< uint8_t >&    vertices,
+                      std::vector< uint8_t >&    indices,
+                      apemodefb::EIndexTypeFb&   indexType ) {
+    const size_t stride = apemode::runtime::GetVertexStride( vertexFormat );
+    if ( nullptr == pEncoded || 0 == encodedSize || 0 == stride )
+        return false;
+
+    draco::DecoderBuffer decoderBuffer;
+    decoderBuffer.Init( reinterpret_cast< const char* >( pEncoded ), encodedSize );
+
+    draco::Decoder decoder;
+    auto statusOrMesh = decoder.DecodeMeshFromBuffer( &decoderBuffer );
+    if ( false == statusOrMesh.ok( ) )
+        return false;
+
+    std::unique_ptr< draco::Mesh > pMesh = std::move( statusOrMesh ).value( );
+    if ( nullptr == pMesh )
+        return false;
+
+    const draco::PointAttribute* attributes[ eDracoMeshAttribute_Count ] = {};
+    for ( uint32_t i = 0; i < eDracoMeshAttribute_Count; ++i ) {
+        attributes[ i ] = pMesh->GetAttributeByUniqueId( i );
+    }
+
+    const uint32_t pointCount = pMesh->num_points( );
+    vertices.resize( pointCount * stride );
+
+    for ( uint32_t i = 0; i < pointCount; ++i ) {
+        const draco::PointIndex pointIndex( i );
+        uint8_t*                pVertex = vertices.data( ) + i * stride;
+
+        bool vertexRead = false;
+        switch ( vertexFormat ) {
+            case apemodefb::EVertexFormatFb_Decompressed:
+                vertexRead = ReadDecompressedVertex( attributes, pointIndex, *reinterpret_cast< apemodefb::DecompressedVertexFb* >( pVertex ) );
+                break;
+            case apemodefb::EVertexFormatFb_DecompressedSkinned:
+                vertexRead = ReadDecompressedSkinnedVertex( attributes, pointIndex, *reinterpret_cast< apemodefb::DecompressedSkinnedVertexFb* >( pVertex ) );
+                break;
+            case apemodefb::EVertexFormatFb_DecompressedFatSkinned:
+                vertexRead = ReadDecompressedFatSkinnedVertex( attributes, pointIndex, *reinterpret_cast< apemodefb::DecompressedFatSkinnedVertexFb* >( pVertex ) );
+                break;
+            default:
+                break;
+        }
+
+        if ( false == vertexRead )
+            return false;
+    }
+
+    /* Draco does not keep the original index type, the smallest one is picked. */
+    if ( pointCount <= std::numeric_limits< uint16_t >::max( ) + 1u ) {
+        indexType = apemodefb::EIndexTypeFb_UInt16;
+        WriteIndices< uint16_t >( *pMesh, indices );
+    } else {
+        indexType = apemodefb::EIndexTypeFb_UInt32;
+        WriteIndices< uint32_t >( *pMesh, indices );
+    }
+
+    return true;
+}
+
+bool DecodeDracoCurveKeys( const uint8_t*                 pEncoded,
+                           size_t                         encodedSize,
+                           apemodefb::EAnimCurveKeyTypeFb keyType,
+                           std::vector< uint8_t >&        keys ) {
+    if ( nullptr == pEncoded || 0 == encodedSize )
+        return false;
+
+    draco::DecoderBuffer decoderBuffer;
+    decoderBuffer.Init( reinterpret_cast< const char* >( pEncoded ), encodedSize );
+
+    draco::Decoder decoder;
+    auto statusOrPointCloud = decoder.DecodePointCloudFromBuffer( &decoderBuffer );
+    if ( false == statusOrPointCloud.ok( ) )
+        return false;
+
+    std::unique_ptr< draco::PointCloud > pPointCloud = std::move( statusOrPointCloud ).value( );
+    if ( nullptr == pPointCloud )
+        return false;
+
+    const draco::PointAttribute* pValues            = pPointCloud->GetAttributeByUniqueId( eDracoCurveAttribute_Values );
+    const draco::PointAttribute* pTime              = pPointCloud->GetAttributeByUniqueId( eDracoCurveAttribute_Time );
+    const draco::PointAttribute* pInterpolationMode = pPointCloud->GetAttributeByUniqueId( eDracoCurveAttribute_InterpolationMode );
+
+    const uint32_t keyCount = pPointCloud->num_points( );
+
+    thread_local std::vector< DecodedCurveKey > decodedKeys;
+    decodedKeys.resize( keyCount );
+
+    for ( uint32_t i = 0; i < keyCount; ++i ) {
+        const draco::PointIndex pointIndex( i );
+        if ( false == ReadAttribute< float, 1 >( pTime, pointIndex, &decodedKeys[ i ].time ) ||
+             false == ReadAttribute< float, 3 >( pValues, pointIndex, decodedKeys[ i ].values ) ||
+             false == ReadAttribute< uint8_t, 1 >( pInterpolationMode, pointIndex, &decodedKeys[ i ].interpolationMode ) )
+            return false;
+    }
+
+    /* The KD-tree encoding reorders the points. */
+    std::stable_sort( decodedKeys.begin( ), decodedKeys.end( ), []( const DecodedCurveKey& a, const DecodedCurveKey& b ) {
+        return a.time < b.time;
+    } );
+
+    switch ( keyType ) {
+        case apemodefb::EAnimCurveKeyTypeFb_Cubic: {
+            keys.resize( keyCount * sizeof( apemodefb::AnimCurveCubicKeyFb ) );
+            auto pKeys = reinterpret_cast< apemodefb::AnimCurveCubicKeyFb* >( keys.data( ) );
+            for ( uint32_t i = 0; i < keyCount; ++i ) {
+                const DecodedCurveKey& key = decodedKeys[ i ];
+                pKeys[ i ] = apemodefb::AnimCurveCubicKeyFb( key.time,
+                                                             key.values[ 0 ],
+                                                             key.values[ 1 ],
+                                                             key.values[ 2 ],
+                                                             apemodefb::EInterpolationModeFb( key.interpolationMode ) );
+            }
+        } break;
+
+        case apemodefb::EAnimCurveKeyTypeFb_Resampled: {
+            keys.resize( keyCount * sizeof( apemodefb::AnimCurveResampledKeyFb ) );
+            auto pKeys = reinterpret_cast< apemodefb::AnimCurveResampledKeyFb* >( keys.data( ) );
+            for ( uint32_t i = 0; i < keyCount; ++i ) {
+                pKeys[ i ] = apemodefb::AnimCurveResampledKeyFb( decodedKeys[ i ].time, decodedKeys[ i ].values[ 0 ] );
+            }
+        } break;
+
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+apemode::runtime::DecodeService::DecodeService( uint32_t threadCount ) {
+    if ( 0 == threadCount )
+        threadCount = std::max( 1u, std::thread::hardware_concurrency( ) );
+
+    threads.reserve( threadCount );
+    for ( uint32_t i = 0; i < threadCount; ++i ) {
+        threads.emplace_back( &DecodeService::Run, this );
+    }
+}
+
+apemode::runtime::DecodeService::~DecodeService( ) {
+    {
+        std::lock_guard< std::mutex > lock( tasksMutex );
+        stopping = true;
+    }
+
+    tasksCondition.notify_all( );
+    for ( std::thread& thread : threads ) {
+        thread.join( );
+    }
+}
+
+void apemode::runtime::DecodeService::Run( ) {
+    for ( ;; ) {
+        std::function< void( ) > task;
+        {
+            std::unique_lock< std::mutex > lock( tasksMutex );
+            tasksCondition.wait( lock, [this] { return stopping || false == tasks.empty( ); } );
+
+            /* The queued tasks are finished before stopping, so that no future is left unresolved. */
+            if ( tasks.empty( ) )
+                return;
+
+            task = std::move( tasks.front( ) );
+            tasks.pop_front( );
+        }
+
+        task( );
+    }
+}
+
+void apemode::runtime::DecodeService::Enqueue( std::vector< std::function< void( ) > >& newTasks ) {
+    {
+        std::lock_guard< std::mutex > lock( tasksMutex );
+        for ( std::function< void( ) >& task : newTasks ) {
+            tasks.push_back( std::move( task ) );
+        }
+    }
+
+    newTasks.clear( );
+    tasksCondition.notify_all( );
+}
+
+std::future< bool > apemode::runtime::DecodeService::DecodeMesh( SceneFile& sceneFile, uint32_t meshIndex, DecodedMesh& decodedMesh ) {
+    auto pTask = std::make_shared< std::packaged_task< bool( ) > >( [&sceneFile, meshIndex, &decodedMesh] {
+        decodedMesh.meshIndex = meshIndex;
+        decodedMesh.decoded   = sceneFile.DecodeMesh(
+            meshIndex, decodedMesh.vertices, decodedMesh.indices, decodedMesh.vertexSpan, decodedMesh.indexSpan );
+        return decodedMesh.decoded;
+    } );
+
+    std::future< bool > future = pTask->get_future( );
+    std::vector< std::function< void( ) > > newTasks{[pTask] { ( *pTask )( ); }};
+    Enqueue( newTasks );
+    return future;
+}
+
+std::future< bool > apemode::runtime::DecodeService::DecodeCurve( SceneFile& sceneFile, uint32_t curveIndex, DecodedCurve& decodedCurve ) {
+    auto pTask = std::make_shared< std::packaged_task< bool( ) > >( [&sceneFile, curveIndex, &decodedCurve] {
+        decodedCurve.curveIndex = curveIndex;
+        decodedCurve.decoded    = sceneFile.DecodeCurveKeys( curveIndex, decodedCurve.keys );
+        return decodedCurve.decoded;
+    } );
+
+    std::future< bool > future = pTask->get_future( );
+    std::vector< std::function< void( ) > > newTasks{[pTask] { ( *pTask )( ); }};
+    Enqueue( newTasks );
+    return future;
+}
+
+std::future< bool > apemode::runtime::DecodeService::DecodeScene( SceneFile&                   sceneFile,
+                                                                  std::vector< DecodedMesh >&  decodedMeshes,
+                                                                  std::vector< DecodedCurve >& decodedCurves,
+                                                                  CompletionCallback           onCompleted ) {
+    struct SceneDecoding {
+        std::atomic< uint32_t > remainingCount{0};
+        std::atomic< bool >     succeeded{true};
+        std::promise< bool >    promise;
+        CompletionCallback      onCompleted;
+
+        void Complete( bool itemSucceeded ) {
+            if ( false == itemSucceeded )
+                succeeded = false;
+
+            if ( 1 == remainingCount.fetch_sub( 1 ) ) {
+                if ( onCompleted )
+                    onCompleted( succeeded );
+                promise.set_value( succeeded );
+            }
+        }
+    };
+
+    struct SceneDecodingItem {
+        size_t                   encodedSize;
+        std::function< void( ) > task;
+    };
+
+    auto pDecoding         = std::make_shared< SceneDecoding >( );
+    pDecoding->onCompleted = std::move( onCompleted );
+    std::future< bool > future = pDecoding->promise.get_future( );
+
+    /* The scene is verified once on the calling thread, the workers only read it. */
+    const apemodefb::SceneFb* pScene = sceneFile.GetScene( );
+    if ( nullptr == pScene ) {
+        decodedMeshes.clear( );
+        decodedCurves.clear( );
+        if ( pDecoding->onCompleted )
+            pDecoding->onCompleted( false );
+        pDecoding->promise.set_value( false );
+        return future;
+    }
+
+    const uint32_t meshCount  = pScene->meshes( ) ? pScene->meshes( )->size( ) : 0;
+    const uint32_t curveCount = pScene->anim_curves( ) ? pScene->anim_curves( )->size( ) : 0;
+
+    std::vector< uint32_t > meshIndices;
+    std::vector< uint32_t > curveIndices;
+    for ( uint32_t i = 0; i < meshCount; ++i ) {
+        if ( sceneFile.IsMeshEncoded( i ) )
+            meshIndices.push_back( i );
+    }
+    for ( uint32_t i = 0; i < curveCount; ++i ) {
+        if ( sceneFile.IsCurveEncoded( i ) )
+            curveIndices.push_back( i );
+    }
+
+    /* Resizing keeps the buffers of the existing items. */
+    decodedMeshes.resize( meshIndices.size( ) );
+    decodedCurves.resize( curveIndices.size( ) );
+
+    std::vector< SceneDecodingItem > items;
+    items.reserve( meshIndices.size( ) + curveIndices.size( ) );
+
+    for ( size_t i = 0; i < meshIndices.size( ); ++i ) {
+        const uint32_t meshIndex   = meshIndices[ i ];
+        DecodedMesh*   pDecodedMesh = &decodedMeshes[ i ];
+        pDecodedMesh->meshIndex     = meshIndex;
+        pDecodedMesh->decoded       = false;
+
+        SceneDecodingItem item;
+        item.encodedSize = sceneFile.GetVertexBytes( meshIndex ).size( ) + sceneFile.GetIndexBytes( meshIndex ).size( );
+        item.task        = [&sceneFile, meshIndex, pDecodedMesh, pDecoding] {
+            /* A throwing item (std::bad_alloc) fails, the other items still complete the scene. */
+            try {
+                pDecodedMesh->decoded = sceneFile.DecodeMesh(
+                    meshIndex, pDecodedMesh->vertices, pDecodedMesh->indices, pDecodedMesh->vertexSpan, pDecodedMesh->indexSpan );
+            } catch ( ... ) {
+                pDecodedMesh->decoded = false;
+            }
+            pDecoding->Complete( pDecodedMesh->decoded );
+        };
+        items.push_back( std::move( item ) );
+    }
+
+    for ( size_t i = 0; i < curveIndices.size( ); ++i ) {
+        const uint32_t curveIndex    = curveIndices[ i ];
+        DecodedCurve*  pDecodedCurve = &decodedCurves[ i ];
+        pDecodedCurve->curveIndex    = curveIndex;
+        pDecodedCurve->decoded       = false;
+
+        SceneDecodingItem item;
+        item.encodedSize = sceneFile.GetCurveKeyBytes( curveIndex ).size( );
+        item.task        = [&sceneFile, curveIndex, pDecodedCurve, pDecoding] {
+            try {
+                pDecodedCurve->decoded = sceneFile.DecodeCurveKeys( curveIndex, pDecodedCurve->keys );
+            } catch ( ... ) {
+                pDecodedCurve->decoded = false;
+            }
+            pDecoding->Complete( pDecodedCurve->decoded );
+        };
+        items.push_back( std::move( item ) );
+    }
+
+    if ( items.empty( ) ) {
+        if ( pDecoding->onCompleted )
+            pDecoding->onCompleted( true );
+        pDecoding->promise.set_value( true );
+        return future;
+    }
+
+    std::stable_sort( items.begin( ), items.end( ), []( const SceneDecodingItem& a, const SceneDecodingItem& b ) {
+        return a.encodedSize > b.encodedSize;
+    } );
+
+    pDecoding->remainingCount = uint32_t( items.size( ) );
+
+    std::vector< std::function< void( ) > > newTasks;
+    newTasks.reserve( items.size( ) );
+    for ( SceneDecodingItem& item : items ) {
+        newTasks.push_back( std::move( item.task ) );
+    }
+
+    Enqueue( newTasks );
+    return future;
+}
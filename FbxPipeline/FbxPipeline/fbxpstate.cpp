@@ -5,6 +5,7 @@
 #include <iostream>
 #include <iomanip>
 #include <ctime>
+#include <cstring>
 
 #include <flatbuffers/util.h>
 #include <spdlog/sinks/msvc_sink.h>
@@ -16,18 +17,42 @@ std::string ResolveFullPath( const char* path );
 std::string GetFileName( const char* filePath );
 bool        MakeDirectory( const char* directory );
 bool        FileExists( const char* filePath );
+std::string ReplaceExtension( const char* path, const char* extension );
 
 void SplitFilename( const std::string& filePath, std::string * parentFolderName, std::string * fileName );
 bool InitializeSdkObjects( FbxManager*& pManager, FbxScene*& pScene );
 void DestroySdkObjects( FbxManager* pManager );
 bool LoadScene( FbxManager* pManager, FbxDocument* pScene, const char* pFilename );
+void ReleaseExtensions( apemode::State& s );
+void ReloadExtensions( apemode::State& s );
+void PackMaterialTextures( apemode::State& s );
+void PackTextureAtlases( apemode::State& s );
+bool ParseBlockCompressionType( const std::string& name, apemodefb::ECompressionTypeFb& compressionType );
+int  GetDefaultBlockCompressionLevel( apemodefb::ECompressionTypeFb compressionType );
+bool IsTextureFormat( const std::string& textureFormat );
+bool TranscodeTexture( const std::string& textureFormat, apemode::ETextureUsage usage, std::vector< uint8_t >& buffer, std::string& errorMessage );
+bool ReadKtx2TextureInfo( const uint8_t* buffer, size_t bufferSize, apemodefb::TextureInfoFb& textureInfo );
+void BuildNodeOrder( apemode::State& s, std::vector< apemodefb::NodeOrderFb >& nodeOrder, std::vector< apemodefb::NodeLevelFb >& nodeLevels );
 
 apemode::State s;
+thread_local apemode::State* currentState = nullptr;
+
 apemode::State& apemode::State::Get( ) {
-    return s;
+    return currentState ? *currentState : s;
+}
+
+apemode::State::CurrentScope::CurrentScope( State& state ) : previous( currentState ) {
+    currentState = &state;
 }
 
-std::shared_ptr< spdlog::logger > CreateLogger( spdlog::level::level_enum lvl, std::string logFile ) {
+apemode::State::CurrentScope::~CurrentScope( ) {
+    currentState = previous;
+}
+
+std::shared_ptr< spdlog::logger > CreateLogger( spdlog::level::level_enum           lvl,
+                                                spdlog::level::level_enum           summaryLvl,
+                                                std::string                         logFile,
+                                                std::shared_ptr< spdlog::logger >&  summaryLogger ) {
     if ( logFile.empty( ) ) {
 
         /* This code is about creation of a name for a log file.
@@ -63,29 +88,44 @@ std::shared_ptr< spdlog::logger > CreateLogger( spdlog::level::level_enum lvl, s
         std::make_shared< spdlog::sinks::msvc_sink_mt >( ),
         std::make_shared< spdlog::sinks::simple_file_sink_mt >( logFile )
 #else
-        std::make_shared< spdlog::sinks::stdout_sink_st >( ),
-        std::make_shared< spdlog::sinks::simple_file_sink_st >( logFile )
-        // std::make_shared< spdlog::sinks::stdout_sink_mt >( ),
-        // std::make_shared< spdlog::sinks::simple_file_sink_mt >( logFile )
+        std::make_shared< spdlog::sinks::stdout_sink_mt >( ),
+        std::make_shared< spdlog::sinks::simple_file_sink_mt >( logFile )
 #endif
     };
 
-    auto logger = spdlog::create<>( "apemode", sinks.begin( ), sinks.end( ) );
+    /* The banner is written synchronously, the patterns of the async logger are applied on its worker thread. */
+    auto bannerLogger = std::make_shared< spdlog::logger >( "apemode-banner", sinks.begin( ), sinks.end( ) );
+    bannerLogger->set_level( lvl );
+
+    bannerLogger->set_pattern( "%v" );
+    bannerLogger->info( "    ______" );
+    bannerLogger->info( "   / __/ /_  _  ______" );
+    bannerLogger->info( "  / /_/ __ \\| |/_/ __ \\" );
+    bannerLogger->info( " / __/ /_/ />  </ /_/ /" );
+    bannerLogger->info( "/_/ /_.___/_/|_/ .___/" );
+    bannerLogger->info( "              /_/" );
+    bannerLogger->info( "" );
+
+    bannerLogger->set_pattern( "%c" );
+    bannerLogger->info( "" );
+    bannerLogger->flush( );
+
+    /* Formatting and writing happen on the logger thread, the queue is bounded (blocks when full). */
+    const size_t queueSize = 8192;
+    auto logger = std::make_shared< spdlog::async_logger >( "apemode", sinks.begin( ), sinks.end( ), queueSize, spdlog::async_overflow_policy::block_retry );
     logger->set_level( lvl );
+    logger->set_pattern( "[%T.%f] [%L] %v" );
+    logger->flush_on( spdlog::level::err );
+    spdlog::register_logger( logger );
+
+    /* The stage summaries pass when the details are filtered out (--quiet), the sinks are shared (thread-safe). */
+    summaryLogger = logger;
+    if ( summaryLvl < lvl ) {
+        summaryLogger = std::make_shared< spdlog::logger >( "apemode-summary", sinks.begin( ), sinks.end( ) );
+        summaryLogger->set_level( summaryLvl );
+        summaryLogger->set_pattern( "[%T.%f] [%L] %v" );
+    }
 
-    spdlog::set_pattern( "%v" );
-    logger->info( "    ______" );
-    logger->info( "   / __/ /_  _  ______" );
-    logger->info( "  / /_/ __ \\| |/_/ __ \\" );
-    logger->info( " / __/ /_/ />  </ /_/ /" );
-    logger->info( "/_/ /_.___/_/|_/ .___/" );
-    logger->info( "              /_/" );
-    logger->info( "" );
-
-    spdlog::set_pattern( "%c" );
-    logger->info( "" );
-
-    spdlog::set_pattern( "[%T.%f] [%L] %v" );
     return logger;
 }
 
@@ -93,12 +133,26 @@ apemode::State& apemode::State::Main( int argc, const char**& argv ) {
     try {
         s.options.parse( argc, argv );
         s.executableName = argv[ 0 ];
+        s.outputFile     = s.options[ "o" ].as< std::string >( );
+        s.SetInputFile( s.options[ "i" ].as< std::string >( ) );
 
-        auto lvl = spdlog::level::info;
-        if ( s.options[ "log-level" ].count( ) > 0 )
+        if ( s.options[ "trace" ].count( ) > 0 )
+            s.profiler.Enable( );
+
+        /* Details (per node, mesh, curve, ...) are logged at debug level, the quiet mode keeps warnings and the stage summaries. */
+        auto lvl = s.options[ "quiet" ].as< bool >( ) ? spdlog::level::warn : spdlog::level::info;
+        auto summaryLvl = spdlog::level::info;
+        if ( s.options[ "log-level" ].count( ) > 0 ) {
             lvl = (spdlog::level::level_enum) s.options[ "log-level" ].as< int >( );
+            summaryLvl = lvl;
+        }
 
-        s.console = CreateLogger( lvl, s.options[ "l" ].as< std::string >( ) );
+        s.console = CreateLogger( lvl, summaryLvl, s.options[ "l" ].as< std::string >( ), s.summary );
+
+        if ( s.options[ "cache" ].count( ) > 0 ) {
+            s.cache.directory = s.options[ "cache" ].as< std::string >( );
+            s.cache.CreateDirectories( );
+        }
     } catch ( const cxxopts::OptionException& e ) {
         std::cerr << s.options.help( {"main"} ) << std::endl;
         std::cerr << "Error parsing options:" << e.what( ) << std::endl;
@@ -124,13 +178,40 @@ apemode::State::State( ) : options( GetExecutable( ) ) {
     options.add_options( "main" )( "script-file", "Script file", cxxopts::value< std::vector< std::string > >( ) );
     options.add_options( "main" )( "script-input", "Script input string", cxxopts::value< std::vector< std::string > >( ) );
     options.add_options( "main" )( "log-level", "Log level: 0 (most detailed) - 6 (off)", cxxopts::value< int >( ) );
+    options.add_options( "main" )( "quiet", "Log only warnings, errors and stage summaries.", cxxopts::value< bool >( ) );
     options.add_options( "main" )( "sync-keys", "Synchronize curve keys for properties", cxxopts::value< bool >( ) );
     options.add_options( "main" )( "reduce-keys", "Reduce the keys in the animation curves.", cxxopts::value< bool >( ) );
     options.add_options( "main" )( "reduce-const-keys", "Reduce constant keys in the animation curves.", cxxopts::value< bool >( ) );
     options.add_options( "main" )( "resample-framerate", "Frame rate at which animation curves will be resampled (60 - default, 0 - disable).", cxxopts::value< float >( ) );
-    options.add_options( "main" )( "mesh-compression", "Mesh compression method.", cxxopts::value< std::string >( ) );
+    options.add_options( "main" )( "mesh-compression", "Mesh compression method: none (default), draco, meshopt (with lz4 block compression of the mesh buffers unless --block-compression is set), auto.", cxxopts::value< std::string >( ) );
+    options.add_options( "main" )( "mesh-decode-budget", "Minimum decoding speed in MB/s of the raw mesh data for --mesh-compression auto, estimated per codec (0 - default, no limit).", cxxopts::value< float >( ) );
+    options.add_options( "main" )( "mesh-error-tolerance", "Maximum position error relative to the mesh size for --mesh-compression auto (0.0001 - default).", cxxopts::value< float >( ) );
     options.add_options( "main" )( "anim-compression", "Anim compression method.", cxxopts::value< std::string >( ) );
     options.add_options( "main" )( "enable-fat-skinned-vertices", "Enables skinned vertices with 8 bones.", cxxopts::value< bool >( ) );
+    options.add_options( "main" )( "io-threads", "Number of threads that prefetch embedded files (4 - default, 0 - disable).", cxxopts::value< int >( ) );
+    options.add_options( "main" )( "prefetch-budget", "Memory budget in MB for prefetched embedded files (512 - default).", cxxopts::value< int >( ) );
+    options.add_options( "main" )( "trace", "Chrome trace file (chrome://tracing, ui.perfetto.dev) with stage timings.", cxxopts::value< std::string >( ) );
+    options.add_options( "main" )( "report", "JSON report file with mesh, curve and section statistics.", cxxopts::value< std::string >( ) );
+    options.add_options( "main" )( "batch", "Text file with input files (one per line), -o and --report are treated as directories.", cxxopts::value< std::string >( ) );
+    options.add_options( "main" )( "jobs", "Number of inputs converted concurrently in the batch mode (1 - default).", cxxopts::value< int >( ) );
+    options.add_options( "main" )( "watch", "Keep running and export the input again when it, its textures or the scripts change.", cxxopts::value< bool >( ) );
+    options.add_options( "main" )( "cache", "Cache directory, the unchanged assets and mesh encoding results are reused.", cxxopts::value< std::string >( ) );
+    options.add_options( "main" )( "block-compression", "Block compression of the vertices, indices, curve keys and files: none (default), zstd, lz4.", cxxopts::value< std::string >( ) );
+    options.add_options( "main" )( "block-compression-level", "Block compression level (zstd: 1-22, 9 - default; lz4: 0 - fast, 1-12 - HC, 9 - default).", cxxopts::value< int >( ) );
+    options.add_options( "main" )( "split-blobs", "Write the meshes, curves and files to the sidecar .fbxpmesh/.fbxpanim/.fbxptex files next to the scene.", cxxopts::value< bool >( ) );
+    options.add_options( "main" )( "pack-orm", "Pack the grayscale occlusion, roughness and metalness maps of the materials into a texture (R - occlusion, G - roughness, B - metalness).", cxxopts::value< bool >( ) );
+    options.add_options( "main" )( "atlas-max-size", "Material textures up to this size in pixels are packed into the shared atlases (0 - default, disabled).", cxxopts::value< int >( ) );
+    options.add_options( "main" )( "atlas-size", "Maximum size of the texture atlases in pixels (2048 - default).", cxxopts::value< int >( ) );
+    options.add_options( "main" )( "texture-format", "Transcode the material textures to KTX2 with mips: none (default), rgba8, bc1, bc3, bc7, auto (bc1 or bc7 with alpha), normal maps are bc5.", cxxopts::value< std::string >( ) );
+}
+
+void apemode::State::InheritSettings( const State& other ) {
+    options                = other.options;
+    console                = other.console;
+    summary                = other.summary;
+    executableName         = other.executableName;
+    cache.directory        = other.cache.directory;
+    legacyTriangulationSdk = other.legacyTriangulationSdk;
 }
 
 apemode::State::~State( ) {
@@ -138,6 +219,8 @@ apemode::State::~State( ) {
 
     if ( console )
         console->flush( );
+    if ( summary && summary != console )
+        summary->flush( );
 }
 
 bool apemode::State::Initialize( ) {
@@ -145,27 +228,184 @@ bool apemode::State::Initialize( ) {
         InitializeSdkObjects( manager, scene );
     }
 
+    int ioThreadCount = 4;
+    if ( options[ "io-threads" ].count( ) > 0 )
+        ioThreadCount = std::max( 0, options[ "io-threads" ].as< int >( ) );
+
+    int prefetchBudgetMb = 512;
+    if ( options[ "prefetch-budget" ].count( ) > 0 )
+        prefetchBudgetMb = std::max( 0, options[ "prefetch-budget" ].as< int >( ) );
+
+    textureFormat = "none";
+    if ( options[ "texture-format" ].count( ) > 0 ) {
+        textureFormat = options[ "texture-format" ].as< std::string >( );
+        if ( false == IsTextureFormat( textureFormat ) ) {
+            console->warn( "Unknown texture format \"{}\" (none, rgba8, bc1, bc3, bc7, auto), disabled", textureFormat );
+            textureFormat = "none";
+        }
+    }
+
+    packOrm = options[ "pack-orm" ].count( ) > 0 && options[ "pack-orm" ].as< bool >( );
+    splitBlobs = options[ "split-blobs" ].count( ) > 0 && options[ "split-blobs" ].as< bool >( );
+
+    atlasMaxSize = 0;
+    if ( options[ "atlas-max-size" ].count( ) > 0 )
+        atlasMaxSize = uint32_t( std::max( 0, options[ "atlas-max-size" ].as< int >( ) ) );
+
+    atlasSize = 2048;
+    if ( options[ "atlas-size" ].count( ) > 0 )
+        atlasSize = uint32_t( std::max( 0, options[ "atlas-size" ].as< int >( ) ) );
+
+    /* The textures are transcoded on the prefetching threads right after they are read.
+     * The packing reads the source images from the prefetcher, the textures are transcoded in Finalize then. */
+    filePrefetcher.process = nullptr;
+    if ( false == packOrm && 0 == atlasMaxSize ) {
+        filePrefetcher.process = [this]( const std::string& fullPath, ETextureUsage usage, std::vector< uint8_t >& fileBuffer ) {
+            TranscodeFile( fullPath, usage, fileBuffer );
+        };
+    }
+
+    console->info( "File prefetching: {} threads, {} MB", ioThreadCount, prefetchBudgetMb );
+    filePrefetcher.Start( (uint32_t) ioThreadCount, size_t( prefetchBudgetMb ) * 1024 * 1024 );
+
+    blockCompressionType = apemodefb::ECompressionTypeFb_None;
+    if ( options[ "block-compression" ].count( ) > 0 &&
+         false == ParseBlockCompressionType( options[ "block-compression" ].as< std::string >( ), blockCompressionType ) ) {
+        console->warn( "Unknown block compression \"{}\" (none, zstd, lz4), disabled", options[ "block-compression" ].as< std::string >( ) );
+    }
+
+    blockCompressionLevel = GetDefaultBlockCompressionLevel( blockCompressionType );
+    if ( options[ "block-compression-level" ].count( ) > 0 )
+        blockCompressionLevel = options[ "block-compression-level" ].as< int >( );
+
+    if ( blockCompressionType != apemodefb::ECompressionTypeFb_None )
+        console->info( "Block compression: {}, level {}", apemodefb::EnumNameECompressionTypeFb( blockCompressionType ), blockCompressionLevel );
+
+    /* The meshopt streams are meant to be followed by a general purpose codec, LZ4 keeps the decoding fast.
+     * Unless the block compression is set explicitly, it is applied to the meshopt buffers only (not to the curves and files). */
+    meshoptBlockCompressionType  = blockCompressionType;
+    meshoptBlockCompressionLevel = blockCompressionLevel;
+    if ( options[ "block-compression" ].count( ) == 0 && options[ "mesh-compression" ].count( ) > 0 &&
+         options[ "mesh-compression" ].as< std::string >( ) == "meshopt" ) {
+        meshoptBlockCompressionType = apemodefb::ECompressionTypeFb_LZ4;
+        if ( options[ "block-compression-level" ].count( ) == 0 )
+            meshoptBlockCompressionLevel = GetDefaultBlockCompressionLevel( meshoptBlockCompressionType );
+
+        console->info( "Block compression of the meshopt buffers: {}, level {} (--block-compression none disables)",
+                       apemodefb::EnumNameECompressionTypeFb( meshoptBlockCompressionType ),
+                       meshoptBlockCompressionLevel );
+    }
+
     return manager && scene;
 }
 
 void apemode::State::Release( ) {
+    filePrefetcher.Stop( );
+    ReleaseExtensions( *this );
+
     if ( manager ) {
         DestroySdkObjects( manager );
         manager = nullptr;
     }
 }
 
-bool apemode::State::Load( ) {
-    const std::string inputFile = options[ "i" ].as< std::string >( );
+void apemode::State::ReloadScripts( ) {
+    ReloadExtensions( *this );
+}
+
+/**
+ * Clears the exported data and the scene of the previous asset, the manager and the options are kept.
+ * Allows to export multiple scenes in a single process (batch mode, bench).
+ **/
+void apemode::State::Reset( ) {
+    if ( scene ) {
+        scene->Destroy( );
+        scene = FbxScene::Create( manager, "" );
+    }
+
+    filePrefetcher.Stop( );
+    filePrefetcher.entries.clear( );
+    filePrefetcher.budgetUsed = 0;
+    filePrefetcher.Start( filePrefetcher.threadCount, filePrefetcher.budget );
+
+    for ( auto& blobFile : blobFiles ) {
+        blobFile.Close( );
+        blobFile.id     = (uint32_t) -1;
+        blobFile.failed = false;
+    }
+
+    blobFileNames.clear( );
+    builder.Clear( );
+    report         = BuildReport( );
+    cache.assetKey = 0;
+
+    nodes.clear( );
+    materials.clear( );
+    embeddedFiles.clear( );
+    embeddedFileContents.clear( );
+    unresolvedFiles.clear( );
+    nodeDict.clear( );
+    textureDict.clear( );
+    textureHashDict.clear( );
+    materialDict.clear( );
+    animStackDict.clear( );
+    animLayerDict.clear( );
+    transforms.clear( );
+    transformLimits.clear( );
+    textures.clear( );
+    cameras.clear( );
+    lights.clear( );
+    meshes.clear( );
+    animStacks.clear( );
+    animLayers.clear( );
+    animCurves.clear( );
+    skins.clear( );
+    boolValues.clear( );
+    intValues.clear( );
+    floatValues.clear( );
+    stringValues.clear( );
+    bboxMin = apemodefb::Vec3Fb( );
+    bboxMax = apemodefb::Vec3Fb( );
+}
+
+void apemode::State::SetInputFile( const std::string& filePath ) {
+    inputFile = filePath;
     SplitFilename( inputFile.c_str( ), &folderPath, &fileName );
     // logger->info( "File name  : \"{}\"", fileName );
     // logger->info( "Folder name: \"{}\"", folderPath );
+}
+
+std::string apemode::State::GetOutputFile( ) const {
+    /* Empty output file means the output is written next to the input. */
+    if ( outputFile.empty( ) )
+        return folderPath + fileName + "." + apemodefb::SceneFbExtension( );
+
+    return outputFile;
+}
+
+bool apemode::State::Load( ) {
+    report.inputFile = inputFile;
+
+    FBXP_PROFILE_SCOPE( "Import", inputFile.c_str( ) );
     return LoadScene( manager, scene, inputFile.c_str( ) );
 }
 
 std::string ToPrettySizeString( size_t size );
-bool        ReadBinFile( const char* srcPath, std::vector< uint8_t >& fileBuffer, bool findFile );
-void        RunExtensionsOnFinalize( );
+bool        GetBinFileSize( const char* srcPath, size_t& fileSize );
+bool        ReadBinFile( const char* srcPath, uint8_t* fileBuffer, size_t fileSize );
+void        RunExtensionsOnFinalize( apemode::State& s );
+bool        CompressBlock( apemodefb::ECompressionTypeFb compressionType, int level, const void* src, size_t srcSize, std::vector< uint8_t >& dst );
+uint64_t    HashFileContent( const void* data, size_t dataSize );
+bool        CompareFileContent( const char* srcPath, const void* data, size_t dataSize );
+bool        CompareFileContent( const char* srcPath, const char* otherSrcPath );
+
+/* The offsets of the Finalize sections, assigned within the profiled scopes. */
+template < typename T >
+using VectorOffset = flatbuffers::Offset< flatbuffers::Vector< T > >;
+template < typename T >
+using StructVectorOffset = flatbuffers::Offset< flatbuffers::Vector< const T* > >;
+template < typename T >
+using TableVectorOffset = flatbuffers::Offset< flatbuffers::Vector< flatbuffers::Offset< T > > >;
 
 std::string ToString( const std::vector< uint32_t >& xx ) {
     std::stringstream ss;
@@ -205,7 +445,21 @@ std::string ToString( const std::vector< apemodefb::SubsetFb >& xx ) {
 }
 
 bool apemode::State::Finalize( ) {
-    RunExtensionsOnFinalize( );
+    FBXP_PROFILE_SCOPE( "Finalize" );
+
+    {
+        FBXP_PROFILE_SCOPE( "Extensions" );
+        RunExtensionsOnFinalize( *this );
+    }
+
+    /* After the extensions, they can replace the materials (glTF). */
+    if ( packOrm ) {
+        PackMaterialTextures( *this );
+    }
+
+    if ( atlasMaxSize && atlasSize ) {
+        PackTextureAtlases( *this );
+    }
 
     //
     // Set global material indices to subsets
@@ -231,28 +485,49 @@ bool apemode::State::Finalize( ) {
     // Finalize values
     //
 
+    report.AddSection( "Streamed", builder.GetSize( ) );
+
     console->info( "> Strings" );
-    std::vector< flatbuffers::Offset< flatbuffers::String > > stringOffsets; {
+    TableVectorOffset< flatbuffers::String > stringsOffset; {
+        FBXP_PROFILE_SCOPE( "Strings" );
+        std::vector< flatbuffers::Offset< flatbuffers::String > > stringOffsets;
         stringOffsets.reserve( stringValues.size( ) );
         for ( auto& string : stringValues ) {
             const auto valueOffset = builder.CreateString( string );
             stringOffsets.push_back( valueOffset );
         }
+
+        stringsOffset = builder.CreateVector( stringOffsets );
     }
 
-    const auto stringsOffset = builder.CreateVector( stringOffsets );
+    report.AddSection( "Strings", stringsOffset.o );
     console->info( "< Succeeded {} ", ToPrettySizeString( stringsOffset.o ) );
 
     console->info( "> Floats" );
-    const auto floatsOffset = builder.CreateVector( floatValues );
+    VectorOffset< float > floatsOffset; {
+        FBXP_PROFILE_SCOPE( "Floats" );
+        floatsOffset = builder.CreateVector( floatValues );
+    }
+
+    report.AddSection( "Floats", floatsOffset.o );
     console->info( "< Succeeded {} ", ToPrettySizeString( floatsOffset.o ) );
 
     console->info( "> Ints" );
-    const auto intsOffset = builder.CreateVector( intValues );
+    VectorOffset< int32_t > intsOffset; {
+        FBXP_PROFILE_SCOPE( "Ints" );
+        intsOffset = builder.CreateVector( intValues );
+    }
+
+    report.AddSection( "Ints", intsOffset.o );
     console->info( "< Succeeded {} ", ToPrettySizeString( intsOffset.o ) );
 
     console->info( "> Bools" );
-    const auto boolsOffset = builder.CreateVector( boolValues );
+    VectorOffset< uint8_t > boolsOffset; {
+        FBXP_PROFILE_SCOPE( "Bools" );
+        boolsOffset = builder.CreateVector( boolValues );
+    }
+
+    report.AddSection( "Bools", boolsOffset.o );
     console->info( "< Succeeded {} ", ToPrettySizeString( boolsOffset.o ) );
 
     //
@@ -260,7 +535,12 @@ bool apemode::State::Finalize( ) {
     //
 
     console->info( "> Transforms" );
-    const auto transformsOffset = builder.CreateVectorOfStructs( transforms );
+    StructVectorOffset< apemodefb::TransformFb > transformsOffset; {
+        FBXP_PROFILE_SCOPE( "Transforms" );
+        transformsOffset = builder.CreateVectorOfStructs( transforms );
+    }
+
+    report.AddSection( "Transforms", transformsOffset.o );
     console->info( "< Succeeded {} ", ToPrettySizeString( transformsOffset.o ) );
 
     //
@@ -268,7 +548,12 @@ bool apemode::State::Finalize( ) {
     //
 
     console->info( "> Transform Limits" );
-    const auto transformLimitsOffset = builder.CreateVectorOfStructs( transformLimits );
+    StructVectorOffset< apemodefb::TransformLimitsFb > transformLimitsOffset; {
+        FBXP_PROFILE_SCOPE( "Transform Limits" );
+        transformLimitsOffset = builder.CreateVectorOfStructs( transformLimits );
+    }
+
+    report.AddSection( "Transform Limits", transformLimitsOffset.o );
     console->info( "< Succeeded {} ", ToPrettySizeString( transformLimitsOffset.o ) );
 
     //
@@ -276,17 +561,21 @@ bool apemode::State::Finalize( ) {
     //
 
     console->info( "> Nodes" );
-    std::vector< flatbuffers::Offset< apemodefb::NodeFb > > nodeOffsets; {
+    TableVectorOffset< apemodefb::NodeFb > nodesOffset; {
+        FBXP_PROFILE_SCOPE( "Nodes" );
+        std::vector< flatbuffers::Offset< apemodefb::NodeFb > > nodeOffsets;
         nodeOffsets.reserve( nodes.size( ) );
         for ( auto& node : nodes ) {
             const auto curveIdsOffset    = builder.CreateVector( node.curveIds );
             const auto childIdsOffset    = builder.CreateVector( node.childIds );
 
-            console->info( "+ curve ids: {}, child ids: {}, unique material ids: {}, mesh id: {}",
-                           node.curveIds.size( ),
-                           node.childIds.size( ),
-                           ToString( node.materialIds ),
-                           node.meshId == -1 ? "<none>" : std::to_string( node.meshId ) );
+            if ( console->should_log( spdlog::level::debug ) ) {
+                console->debug( "+ curve ids: {}, child ids: {}, unique material ids: {}, mesh id: {}",
+                                node.curveIds.size( ),
+                                node.childIds.size( ),
+                                ToString( node.materialIds ),
+                                node.meshId == -1 ? "<none>" : std::to_string( node.meshId ) );
+            }
 
             apemodefb::NodeFbBuilder nodeBuilder( builder );
             nodeBuilder.add_id( node.id );
@@ -303,61 +592,101 @@ bool apemode::State::Finalize( ) {
             nodeBuilder.add_anim_curve_ids( curveIdsOffset );
             nodeOffsets.push_back( nodeBuilder.Finish( ) );
         }
+
+        nodesOffset = builder.CreateVector( nodeOffsets );
     }
 
-    const auto nodesOffset = builder.CreateVector( nodeOffsets );
+    report.AddSection( "Nodes", nodesOffset.o );
     console->info( "< Succeeded {} ", ToPrettySizeString( nodesOffset.o ) );
 
+    //
+    // Finalize node order
+    //
+
+    console->info( "> Node Order" );
+    StructVectorOffset< apemodefb::NodeOrderFb > nodeOrderOffset;
+    StructVectorOffset< apemodefb::NodeLevelFb > nodeLevelsOffset; {
+        FBXP_PROFILE_SCOPE( "Node Order" );
+        std::vector< apemodefb::NodeOrderFb > nodeOrder;
+        std::vector< apemodefb::NodeLevelFb > nodeLevels;
+        BuildNodeOrder( *this, nodeOrder, nodeLevels );
+        console->debug( "+ nodes: {}, levels: {}", nodeOrder.size( ), nodeLevels.size( ) );
+
+        nodeOrderOffset = builder.CreateVectorOfStructs( nodeOrder );
+        nodeLevelsOffset = builder.CreateVectorOfStructs( nodeLevels );
+    }
+
+    report.AddSection( "Node Order", nodeLevelsOffset.o );
+    console->info( "< Succeeded {} ", ToPrettySizeString( nodeLevelsOffset.o ) );
+
     //
     // Finalize curves
     //
 
     console->info( "> AnimStacks" );
-    std::vector< apemodefb::AnimStackFb > stacks;
-    stacks.reserve( animStacks.size( ) );
-    std::transform( animStacks.begin( ), animStacks.end( ), std::back_inserter( stacks ), [&]( const AnimStack& animStack ) {
-        return apemodefb::AnimStackFb( animStack.id, animStack.nameId );
-    } );
+    StructVectorOffset< apemodefb::AnimStackFb > animStacksOffset; {
+        FBXP_PROFILE_SCOPE( "AnimStacks" );
+        std::vector< apemodefb::AnimStackFb > stacks;
+        stacks.reserve( animStacks.size( ) );
+        std::transform( animStacks.begin( ), animStacks.end( ), std::back_inserter( stacks ), [&]( const AnimStack& animStack ) {
+            return apemodefb::AnimStackFb( animStack.id, animStack.nameId );
+        } );
+
+        animStacksOffset = builder.CreateVectorOfStructs( stacks );
+    }
 
-    const auto animStacksOffset = builder.CreateVectorOfStructs( stacks );
+    report.AddSection( "AnimStacks", animStacksOffset.o );
     console->info( "< Succeeded {} ", ToPrettySizeString( animStacksOffset.o ) );
 
     console->info( "> AnimLayers" );
-    std::vector< apemodefb::AnimLayerFb > layers;
-    stacks.reserve( animLayers.size( ) );
-    std::transform( animLayers.begin( ), animLayers.end( ), std::back_inserter( layers ), [&]( const AnimLayer& animLayer ) {
-        return apemodefb::AnimLayerFb( animLayer.id, animLayer.animStackId, animLayer.animStackIdx, animLayer.nameId );
-    } );
+    StructVectorOffset< apemodefb::AnimLayerFb > animLayersOffset; {
+        FBXP_PROFILE_SCOPE( "AnimLayers" );
+        std::vector< apemodefb::AnimLayerFb > layers;
+        stacks.reserve( animLayers.size( ) );
+        std::transform( animLayers.begin( ), animLayers.end( ), std::back_inserter( layers ), [&]( const AnimLayer& animLayer ) {
+            return apemodefb::AnimLayerFb( animLayer.id, animLayer.animStackId, animLayer.animStackIdx, animLayer.nameId );
+        } );
+
+        animLayersOffset = builder.CreateVectorOfStructs( layers );
+    }
 
-    const auto animLayersOffset = builder.CreateVectorOfStructs( layers );
+    report.AddSection( "AnimLayers", animLayersOffset.o );
     console->info( "< Succeeded {} ", ToPrettySizeString( animLayersOffset.o ) );
 
     console->info( "> AnimCurves" );
-    
-    std::vector< flatbuffers::Offset< apemodefb::AnimCurveFb > > curveOffsets;
-    curveOffsets.reserve( animCurves.size( ) );
-    for ( auto& curve : animCurves ) {
-        console->info( "+ keys {} ({}/{}) ",
-                       curve.keys.size( ),
-                       apemodefb::EnumNameEAnimCurvePropertyFb( curve.property ),
-                       apemodefb::EnumNameEAnimCurveChannelFb( curve.channel ) );
-
-        auto keysOffset = builder.CreateVector(curve.keys);
-
-        apemodefb::AnimCurveFbBuilder curveBuilder( builder );
-        curveBuilder.add_id( curve.id );
-        curveBuilder.add_channel( curve.channel );
-        curveBuilder.add_anim_stack_id( curve.animStackId );
-        curveBuilder.add_anim_layer_id( curve.animLayerId );
-        curveBuilder.add_property( curve.property );
-        curveBuilder.add_name_id( curve.nameId );
-        curveBuilder.add_keys( keysOffset );
-        curveBuilder.add_key_type(curve.keyType);
-        curveBuilder.add_compression_type(curve.compressionType);
-        curveOffsets.push_back( curveBuilder.Finish( ) );
-    }
-
-    const auto animCurvesOffset = builder.CreateVector( curveOffsets );
+    TableVectorOffset< apemodefb::AnimCurveFb > animCurvesOffset; {
+        FBXP_PROFILE_SCOPE( "AnimCurves" );
+        std::vector< flatbuffers::Offset< apemodefb::AnimCurveFb > > curveOffsets;
+        curveOffsets.reserve( animCurves.size( ) );
+        for ( auto& curve : animCurves ) {
+            SerializeAnimCurveKeys( curve );
+
+            console->debug( "+ keys {} ({}/{}) ",
+                            curve.keysSize,
+                            apemodefb::EnumNameEAnimCurvePropertyFb( curve.property ),
+                            apemodefb::EnumNameEAnimCurveChannelFb( curve.channel ) );
+
+            apemodefb::AnimCurveFbBuilder curveBuilder( builder );
+            curveBuilder.add_id( curve.id );
+            curveBuilder.add_channel( curve.channel );
+            curveBuilder.add_anim_stack_id( curve.animStackId );
+            curveBuilder.add_anim_layer_id( curve.animLayerId );
+            curveBuilder.add_property( curve.property );
+            curveBuilder.add_name_id( curve.nameId );
+            curveBuilder.add_keys( curve.keysOffset );
+            curveBuilder.add_key_type(curve.keyType);
+            curveBuilder.add_compression_type(curve.compressionType);
+            if ( splitBlobs )
+                curveBuilder.add_keys_blob( &curve.keysBlob );
+            if ( curve.keysCompression.compression_type( ) != apemodefb::ECompressionTypeFb_None )
+                curveBuilder.add_keys_compression( &curve.keysCompression );
+            curveOffsets.push_back( curveBuilder.Finish( ) );
+        }
+
+        animCurvesOffset = builder.CreateVector( curveOffsets );
+    }
+
+    report.AddSection( "AnimCurves", animCurvesOffset.o );
     console->info( "< Succeeded {} ", ToPrettySizeString( animCurvesOffset.o ) );
 
     //
@@ -365,26 +694,31 @@ bool apemode::State::Finalize( ) {
     //
 
     console->info( "> Materials" );
-    std::vector< flatbuffers::Offset< apemodefb::MaterialFb > > materialOffsets;
-    materialOffsets.reserve( materials.size( ) );
-    for ( auto& material : materials ) {
-        console->info( "+ {} -> properties: {}, textures: {}",
-                       stringValues[ ValueId( material.nameId ).valueIndex ],
-                       material.properties.size( ),
-                       material.textureProperties.size( ) );
-
-        auto propertiesOffset = builder.CreateVectorOfStructs( material.properties );
-        auto texturesOffset = builder.CreateVectorOfStructs( material.textureProperties );
-
-        apemodefb::MaterialFbBuilder materialBuilder( builder );
-        materialBuilder.add_id( material.id );
-        materialBuilder.add_name_id( material.nameId );
-        materialBuilder.add_properties( propertiesOffset );
-        materialBuilder.add_texture_properties( texturesOffset );
-        materialOffsets.push_back( materialBuilder.Finish( ) );
-    }
-
-    const auto materialsOffset = builder.CreateVector( materialOffsets );
+    TableVectorOffset< apemodefb::MaterialFb > materialsOffset; {
+        FBXP_PROFILE_SCOPE( "Materials" );
+        std::vector< flatbuffers::Offset< apemodefb::MaterialFb > > materialOffsets;
+        materialOffsets.reserve( materials.size( ) );
+        for ( auto& material : materials ) {
+            console->debug( "+ {} -> properties: {}, textures: {}",
+                            stringValues[ ValueId( material.nameId ).valueIndex ],
+                            material.properties.size( ),
+                            material.textureProperties.size( ) );
+
+            auto propertiesOffset = builder.CreateVectorOfStructs( material.properties );
+            auto texturesOffset = builder.CreateVectorOfStructs( material.textureProperties );
+
+            apemodefb::MaterialFbBuilder materialBuilder( builder );
+            materialBuilder.add_id( material.id );
+            materialBuilder.add_name_id( material.nameId );
+            materialBuilder.add_properties( propertiesOffset );
+            materialBuilder.add_texture_properties( texturesOffset );
+            materialOffsets.push_back( materialBuilder.Finish( ) );
+        }
+
+        materialsOffset = builder.CreateVector( materialOffsets );
+    }
+
+    report.AddSection( "Materials", materialsOffset.o );
     console->info( "< Succeeded {} ", ToPrettySizeString( materialsOffset.o ) );
 
     //
@@ -392,18 +726,23 @@ bool apemode::State::Finalize( ) {
     //
 
     console->info( "> Skins" );
-    std::vector< flatbuffers::Offset< apemodefb::SkinFb > > skinOffsets;
-    skinOffsets.reserve( skins.size( ) );
-
-    std::transform( skins.begin( ), skins.end( ), std::back_inserter( skinOffsets ), [&]( const Skin& skin ) {
-        console->info( "+ link ids: {} ", skin.linkIds.size( ) );
-        return apemodefb::CreateSkinFb( builder,
-                                        skin.nameId,
-                                        builder.CreateVector( skin.linkIds ),
-                                        builder.CreateVectorOfStructs( skin.invBindPoseMatrices ) );
-    } );
-
-    auto skinsOffset = builder.CreateVector( skinOffsets );
+    TableVectorOffset< apemodefb::SkinFb > skinsOffset; {
+        FBXP_PROFILE_SCOPE( "Skins" );
+        std::vector< flatbuffers::Offset< apemodefb::SkinFb > > skinOffsets;
+        skinOffsets.reserve( skins.size( ) );
+
+        std::transform( skins.begin( ), skins.end( ), std::back_inserter( skinOffsets ), [&]( const Skin& skin ) {
+            console->debug( "+ link ids: {} ", skin.linkIds.size( ) );
+            return apemodefb::CreateSkinFb( builder,
+                                            skin.nameId,
+                                            builder.CreateVector( skin.linkIds ),
+                                            builder.CreateVectorOfStructs( skin.invBindPoseMatrices ) );
+        } );
+
+        skinsOffset = builder.CreateVector( skinOffsets );
+    }
+
+    report.AddSection( "Skins", skinsOffset.o );
     console->info( "< Succeeded {} ", ToPrettySizeString( skinsOffset.o ) );
 
     //
@@ -411,32 +750,47 @@ bool apemode::State::Finalize( ) {
     //
 
     console->info( "> Meshes" );
-    std::vector< flatbuffers::Offset< apemodefb::MeshFb > > meshOffsets;
-    meshOffsets.reserve( meshes.size( ) );
-    for ( auto& mesh : meshes ) {
-        console->info( "+ subsets ({}): {}, vertex count: {}, vertex bytes: {}", //, vertex format: {} ",
-                       mesh.subsets.size( ),
-                       ToString( mesh.subsets ),
-                       mesh.submeshes[ 0 ].vertex_count( ),
-                       mesh.vertices.size( ),
-                       apemodefb::EnumNameEVertexFormatFb( mesh.submeshes[ 0 ].vertex_format( ) ) );
-
-        auto vsOffset = builder.CreateVector( mesh.vertices );
-        auto smOffset = builder.CreateVectorOfStructs( mesh.submeshes );
-        auto ssOffset = builder.CreateVectorOfStructs( mesh.subsets );
-        auto siOffset = builder.CreateVector( mesh.indices );
-
-        apemodefb::MeshFbBuilder meshBuilder( builder );
-        meshBuilder.add_vertices( vsOffset );
-        meshBuilder.add_submeshes( smOffset );
-        meshBuilder.add_subsets( ssOffset );
-        meshBuilder.add_indices( siOffset );
-        meshBuilder.add_index_type( mesh.indexType );
-        meshBuilder.add_skin_id( mesh.skinId );
-        meshOffsets.push_back( meshBuilder.Finish( ) );
-    }
-
-    const auto meshesOffset = builder.CreateVector( meshOffsets );
+    TableVectorOffset< apemodefb::MeshFb > meshesOffset; {
+        FBXP_PROFILE_SCOPE( "Meshes" );
+        std::vector< flatbuffers::Offset< apemodefb::MeshFb > > meshOffsets;
+        meshOffsets.reserve( meshes.size( ) );
+        for ( auto& mesh : meshes ) {
+            SerializeMeshBuffers( mesh );
+
+            if ( console->should_log( spdlog::level::debug ) ) {
+                console->debug( "+ subsets ({}): {}, vertex count: {}, vertex bytes: {}", //, vertex format: {} ",
+                                mesh.subsets.size( ),
+                                ToString( mesh.subsets ),
+                                mesh.submeshes[ 0 ].vertex_count( ),
+                                mesh.verticesSize,
+                                apemodefb::EnumNameEVertexFormatFb( mesh.submeshes[ 0 ].vertex_format( ) ) );
+            }
+
+            auto smOffset = builder.CreateVectorOfStructs( mesh.submeshes );
+            auto ssOffset = builder.CreateVectorOfStructs( mesh.subsets );
+
+            apemodefb::MeshFbBuilder meshBuilder( builder );
+            meshBuilder.add_vertices( mesh.verticesOffset );
+            meshBuilder.add_submeshes( smOffset );
+            meshBuilder.add_subsets( ssOffset );
+            meshBuilder.add_indices( mesh.indicesOffset );
+            meshBuilder.add_index_type( mesh.indexType );
+            meshBuilder.add_skin_id( mesh.skinId );
+            if ( splitBlobs ) {
+                meshBuilder.add_vertices_blob( &mesh.verticesBlob );
+                meshBuilder.add_indices_blob( &mesh.indicesBlob );
+            }
+            if ( mesh.verticesCompression.compression_type( ) != apemodefb::ECompressionTypeFb_None )
+                meshBuilder.add_vertices_compression( &mesh.verticesCompression );
+            if ( mesh.indicesCompression.compression_type( ) != apemodefb::ECompressionTypeFb_None )
+                meshBuilder.add_indices_compression( &mesh.indicesCompression );
+            meshOffsets.push_back( meshBuilder.Finish( ) );
+        }
+
+        meshesOffset = builder.CreateVector( meshOffsets );
+    }
+
+    report.AddSection( "Meshes", meshesOffset.o );
     console->info( "< Succeeded {} ", ToPrettySizeString( meshesOffset.o ) );
 
     //
@@ -444,7 +798,12 @@ bool apemode::State::Finalize( ) {
     //
 
     console->info( "> Cameras" );
-    const auto camerasOffset = builder.CreateVectorOfStructs( cameras );
+    StructVectorOffset< apemodefb::CameraFb > camerasOffset; {
+        FBXP_PROFILE_SCOPE( "Cameras" );
+        camerasOffset = builder.CreateVectorOfStructs( cameras );
+    }
+
+    report.AddSection( "Cameras", camerasOffset.o );
     console->info( "< Succeeded {} ", ToPrettySizeString( camerasOffset.o ) );
 
     //
@@ -452,7 +811,12 @@ bool apemode::State::Finalize( ) {
     //
 
     console->info( "> Lights" );
-    const auto lightsOffset = builder.CreateVectorOfStructs( lights );
+    StructVectorOffset< apemodefb::LightFb > lightsOffset; {
+        FBXP_PROFILE_SCOPE( "Lights" );
+        lightsOffset = builder.CreateVectorOfStructs( lights );
+    }
+
+    report.AddSection( "Lights", lightsOffset.o );
     console->info( "< Succeeded {} ", ToPrettySizeString( lightsOffset.o ) );
 
     //
@@ -460,24 +824,164 @@ bool apemode::State::Finalize( ) {
     //
 
     console->info( "> Files" );
-    std::vector< uint8_t > tempFileBuffer;
-    std::vector< flatbuffers::Offset< apemodefb::FileFb > > fileOffsets;
-    fileOffsets.reserve( embeddedFiles.size( ) );
-    for ( auto& embeddedFile : embeddedFiles) {
-        if ( false == embeddedFile.fullPath.empty( ) ) {
-            if ( ReadBinFile( embeddedFile.fullPath.c_str( ), tempFileBuffer, true ) ) {
-                console->info( "+ {} ({}, {}) ",
-                               ToPrettySizeString( tempFileBuffer.size( ) ),
-                               tempFileBuffer.size( ),
-                               embeddedFile.fullPath );
-
-                fileOffsets.push_back( apemodefb::CreateFileFbDirect(
-                    builder, (uint32_t) fileOffsets.size( ), embeddedFile.nameId, &tempFileBuffer ) );
+    TableVectorOffset< apemodefb::FileFb > filesOffset; {
+        FBXP_PROFILE_SCOPE( "Files" );
+        std::vector< flatbuffers::Offset< apemodefb::FileFb > > fileOffsets;
+        fileOffsets.reserve( embeddedFiles.size( ) );
+        const bool fileBuffersCompressed = blockCompressionType != apemodefb::ECompressionTypeFb_None;
+        std::vector< uint8_t > tempFileBuffer;
+        std::vector< uint32_t > fileIndices( embeddedFiles.size( ), (uint32_t) -1 );
+        for ( auto& embeddedFile : embeddedFiles) {
+            if ( embeddedFile.packed ) {
+                /* Release the prefetched buffer and the budget. */
+                uint64_t contentHash = 0;
+                size_t   contentSize = 0;
+                filePrefetcher.Acquire( embeddedFile.id, tempFileBuffer, contentHash, contentSize );
+                console->debug( "+ {} packed", embeddedFile.fullPath );
+                continue;
+            }
+
+            size_t fileSize = 0;
+            const bool transcodesFile = embeddedFile.usage != eTextureUsage_None && textureFormat != "none";
+            if ( embeddedFile.serialized ) {
+                console->debug( "+ {} ({}, {}) streamed",
+                                ToPrettySizeString( embeddedFile.bufferSize ),
+                                embeddedFile.bufferSize,
+                                embeddedFile.fullPath );
+            } else if ( filePrefetcher.Acquire( embeddedFile.id, tempFileBuffer, embeddedFile.contentHash, embeddedFile.contentSize ) ) {
+                embeddedFile.hasContentHash = true;
+                console->debug( "+ {} ({}, {}) prefetched",
+                                ToPrettySizeString( tempFileBuffer.size( ) ),
+                                tempFileBuffer.size( ),
+                                embeddedFile.fullPath );
+
+                /* The source images of the packing were not transcoded on the prefetching threads. */
+                if ( transcodesFile && nullptr == filePrefetcher.process && false == DeduplicateFile( embeddedFile, tempFileBuffer.data( ) ) )
+                    TranscodeFile( embeddedFile.fullPath, embeddedFile.usage, tempFileBuffer );
+
+                SerializeFileBuffer( embeddedFile, tempFileBuffer );
+            }
+
+            if ( false == embeddedFile.serialized && false == embeddedFile.generatedBuffer.empty( ) ) {
+                console->debug( "+ {} ({}, {}) generated",
+                                ToPrettySizeString( embeddedFile.generatedBuffer.size( ) ),
+                                embeddedFile.generatedBuffer.size( ),
+                                stringValues[ ValueId( embeddedFile.nameId ).valueIndex ] );
+
+                embeddedFile.contentHash    = HashFileContent( embeddedFile.generatedBuffer.data( ), embeddedFile.generatedBuffer.size( ) );
+                embeddedFile.contentSize    = embeddedFile.generatedBuffer.size( );
+                embeddedFile.hasContentHash = true;
+
+                /* The generated contents are kept for the comparisons with the next files. */
+                std::vector< uint8_t > fileBuffer;
+                if ( false == DeduplicateFile( embeddedFile, embeddedFile.generatedBuffer.data( ) ) ) {
+                    fileBuffer = embeddedFile.generatedBuffer;
+                    if ( transcodesFile )
+                        TranscodeFile( stringValues[ ValueId( embeddedFile.nameId ).valueIndex ], embeddedFile.usage, fileBuffer );
+                }
+
+                SerializeFileBuffer( embeddedFile, fileBuffer );
+            }
+
+            if ( false == embeddedFile.serialized && ( splitBlobs || fileBuffersCompressed || transcodesFile ) &&
+                 false == embeddedFile.fullPath.empty( ) && GetBinFileSize( embeddedFile.fullPath.c_str( ), fileSize ) ) {
+
+                /* The file goes through the temporary buffer (blob file, block compression, texture transcoding). */
+                tempFileBuffer.resize( fileSize );
+                if ( false == ReadBinFile( embeddedFile.fullPath.c_str( ), tempFileBuffer.data( ), fileSize ) ) {
+                    /* No entry is written, the textures of the file are remapped to -1. */
+                    console->error( "Failed to read file: {}", embeddedFile.fullPath );
+                    continue;
+                }
+
+                console->debug( "+ {} ({}, {}) ",
+                                ToPrettySizeString( fileSize ),
+                                fileSize,
+                                embeddedFile.fullPath );
+
+                /* The duplicates are not transcoded. */
+                embeddedFile.contentHash    = HashFileContent( tempFileBuffer.data( ), fileSize );
+                embeddedFile.contentSize    = fileSize;
+                embeddedFile.hasContentHash = true;
+                if ( false == DeduplicateFile( embeddedFile, tempFileBuffer.data( ) ) && transcodesFile )
+                    TranscodeFile( embeddedFile.fullPath, embeddedFile.usage, tempFileBuffer );
+
+                SerializeFileBuffer( embeddedFile, tempFileBuffer );
+            }
+
+            if ( embeddedFile.duplicateFileId != (uint32_t) -1 ) {
+                console->debug( "+ {} duplicates {}", embeddedFile.fullPath, embeddedFiles[ embeddedFile.duplicateFileId ].fullPath );
+            } else if ( embeddedFile.serialized ) {
+                fileIndices[ embeddedFile.id ] = (uint32_t) fileOffsets.size( );
+                const bool bufferCompressed = embeddedFile.bufferCompression.compression_type( ) != apemodefb::ECompressionTypeFb_None;
+                fileOffsets.push_back( apemodefb::CreateFileFb( builder,
+                                                                (uint32_t) fileOffsets.size( ),
+                                                                embeddedFile.nameId,
+                                                                embeddedFile.bufferOffset,
+                                                                splitBlobs ? &embeddedFile.bufferBlob : nullptr,
+                                                                bufferCompressed ? &embeddedFile.bufferCompression : nullptr,
+                                                                embeddedFile.hasTextureInfo ? &embeddedFile.textureInfo : nullptr ) );
+            } else if ( false == embeddedFile.fullPath.empty( ) && GetBinFileSize( embeddedFile.fullPath.c_str( ), fileSize ) ) {
+
+                /* The file is read directly into the builder's memory, no intermediate copies. */
+                const flatbuffers::uoffset_t builderSize = builder.GetSize( );
+                uint8_t* fileBuffer = nullptr;
+                builder.ForceVectorAlignment( fileSize, sizeof( uint8_t ), kFileBufferAlignment );
+                const auto bufferOffset = builder.CreateUninitializedVector( fileSize, &fileBuffer );
+
+                if ( false == ReadBinFile( embeddedFile.fullPath.c_str( ), fileBuffer, fileSize ) ) {
+                    /* The reserved space is dropped, no entry is written and the textures of the file are remapped to -1. */
+                    console->error( "Failed to read file: {}", embeddedFile.fullPath );
+                    builder.Rollback( builderSize );
+                    continue;
+                }
+
+                /* The file is hashed in the builder's memory, the duplicate drops the read file. */
+                embeddedFile.contentHash    = HashFileContent( fileBuffer, fileSize );
+                embeddedFile.contentSize    = fileSize;
+                embeddedFile.hasContentHash = true;
+                if ( DeduplicateFile( embeddedFile, fileBuffer ) ) {
+                    console->debug( "+ {} duplicates {}", embeddedFile.fullPath, embeddedFiles[ embeddedFile.duplicateFileId ].fullPath );
+                    builder.Rollback( builderSize );
+                    continue;
+                }
+
+                console->debug( "+ {} ({}, {}) ",
+                                ToPrettySizeString( fileSize ),
+                                fileSize,
+                                embeddedFile.fullPath );
+
+                fileIndices[ embeddedFile.id ] = (uint32_t) fileOffsets.size( );
+                fileOffsets.push_back( apemodefb::CreateFileFb(
+                    builder, (uint32_t) fileOffsets.size( ), embeddedFile.nameId, bufferOffset ) );
+            } else if ( false == embeddedFile.fullPath.empty( ) ) {
+                console->error( "Failed to open file: {}", embeddedFile.fullPath );
+            }
+        }
+
+        /* The textures reference the embedded files, they are remapped to the written ones. */
+        size_t duplicateFileCount = 0;
+        for ( auto& embeddedFile : embeddedFiles ) {
+            decltype( embeddedFile.generatedBuffer )( ).swap( embeddedFile.generatedBuffer );
+            if ( embeddedFile.duplicateFileId != (uint32_t) -1 ) {
+                fileIndices[ embeddedFile.id ] = fileIndices[ embeddedFile.duplicateFileId ];
+                ++duplicateFileCount;
             }
         }
+
+        for ( auto& texture : textures ) {
+            if ( texture.file_id( ) < fileIndices.size( ) )
+                texture.mutate_file_id( fileIndices[ texture.file_id( ) ] );
+        }
+
+        if ( duplicateFileCount )
+            console->info( "Deduplicated {} embedded files", duplicateFileCount );
+
+        filePrefetcher.Stop( );
+        filesOffset = builder.CreateVector(fileOffsets);
     }
 
-    const auto filesOffset = builder.CreateVector(fileOffsets);
+    report.AddSection( "Files", filesOffset.o );
     console->info( "< Succeeded {} ", ToPrettySizeString( filesOffset.o ) );
 
     //
@@ -485,38 +989,82 @@ bool apemode::State::Finalize( ) {
     //
 
     console->info( "> Textures" );
-    const auto texturesOffset = builder.CreateVectorOfStructs( textures );
+    StructVectorOffset< apemodefb::TextureFb > texturesOffset; {
+        FBXP_PROFILE_SCOPE( "Textures" );
+        texturesOffset = builder.CreateVectorOfStructs( textures );
+    }
+
+    report.AddSection( "Textures", texturesOffset.o );
     console->info( "< Succeeded {} ", ToPrettySizeString( texturesOffset.o ) );
 
+    //
+    // Finalize blob files
+    //
+
+    flatbuffers::Offset< flatbuffers::Vector< flatbuffers::Offset< flatbuffers::String > > > blobFilesOffset;
+    if ( false == blobFileNames.empty( ) ) {
+        console->info( "> Blob Files" );
+        FBXP_PROFILE_SCOPE( "Blob Files" );
+        if ( false == CloseBlobFiles( ) ) {
+            console->error( "Failed to write the blob files" );
+            DebugBreak( );
+            return false;
+        }
+
+        std::vector< flatbuffers::Offset< flatbuffers::String > > blobFileNameOffsets;
+        blobFileNameOffsets.reserve( blobFileNames.size( ) );
+        for ( auto& blobFileName : blobFileNames ) {
+            blobFileNameOffsets.push_back( builder.CreateString( blobFileName ) );
+        }
+
+        for ( auto& blobFile : blobFiles ) {
+            if ( blobFile.id != (uint32_t) -1 ) {
+                console->info( "+ {} ({}, {}) ", ToPrettySizeString( blobFile.size ), blobFile.size, blobFile.fullPath );
+            }
+        }
+
+        blobFilesOffset = builder.CreateVector( blobFileNameOffsets );
+        report.AddSection( "Blob Files", blobFilesOffset.o );
+        console->info( "< Succeeded {} ", ToPrettySizeString( blobFilesOffset.o ) );
+    }
+
     //
     // Finalize scene
     //
 
     console->info( "> Scene" );
-    apemodefb::SceneFbBuilder sceneBuilder( builder );
-    sceneBuilder.add_string_values( stringsOffset );
-    sceneBuilder.add_float_values( floatsOffset );
-    sceneBuilder.add_int_values( intsOffset );
-    sceneBuilder.add_bool_values( boolsOffset );
-    sceneBuilder.add_bbox_min( &bboxMin );
-    sceneBuilder.add_bbox_max( &bboxMax );
-    sceneBuilder.add_transforms( transformsOffset );
-    sceneBuilder.add_transform_limits( transformLimitsOffset );
-    sceneBuilder.add_nodes( nodesOffset );
-    sceneBuilder.add_meshes( meshesOffset );
-    sceneBuilder.add_textures( texturesOffset );
-    sceneBuilder.add_materials( materialsOffset );
-    sceneBuilder.add_files( filesOffset );
-    sceneBuilder.add_skins( skinsOffset );
-    sceneBuilder.add_cameras( camerasOffset );
-    sceneBuilder.add_lights( lightsOffset );
-    sceneBuilder.add_anim_stacks( animStacksOffset );
-    sceneBuilder.add_anim_layers( animLayersOffset );
-    sceneBuilder.add_anim_curves( animCurvesOffset );
-    sceneBuilder.add_version( apemodefb::EVersionFb::EVersionFb_Value );
-
-    auto sceneOffset = sceneBuilder.Finish( );
-    apemodefb::FinishSceneFbBuffer( builder, sceneOffset );
+    flatbuffers::Offset< apemodefb::SceneFb > sceneOffset; {
+        FBXP_PROFILE_SCOPE( "Scene" );
+        apemodefb::SceneFbBuilder sceneBuilder( builder );
+        sceneBuilder.add_string_values( stringsOffset );
+        sceneBuilder.add_float_values( floatsOffset );
+        sceneBuilder.add_int_values( intsOffset );
+        sceneBuilder.add_bool_values( boolsOffset );
+        sceneBuilder.add_bbox_min( &bboxMin );
+        sceneBuilder.add_bbox_max( &bboxMax );
+        sceneBuilder.add_transforms( transformsOffset );
+        sceneBuilder.add_transform_limits( transformLimitsOffset );
+        sceneBuilder.add_nodes( nodesOffset );
+        sceneBuilder.add_meshes( meshesOffset );
+        sceneBuilder.add_textures( texturesOffset );
+        sceneBuilder.add_materials( materialsOffset );
+        sceneBuilder.add_files( filesOffset );
+        sceneBuilder.add_skins( skinsOffset );
+        sceneBuilder.add_cameras( camerasOffset );
+        sceneBuilder.add_lights( lightsOffset );
+        sceneBuilder.add_anim_stacks( animStacksOffset );
+        sceneBuilder.add_anim_layers( animLayersOffset );
+        sceneBuilder.add_anim_curves( animCurvesOffset );
+        sceneBuilder.add_blob_files( blobFilesOffset );
+        sceneBuilder.add_node_order( nodeOrderOffset );
+        sceneBuilder.add_node_levels( nodeLevelsOffset );
+        sceneBuilder.add_version( apemodefb::EVersionFb::EVersionFb_Value );
+
+        sceneOffset = sceneBuilder.Finish( );
+        apemodefb::FinishSceneFbBuffer( builder, sceneOffset );
+    }
+
+    report.AddSection( "Scene", sceneOffset.o );
     console->info( "< Succeeded {} ", ToPrettySizeString( sceneOffset.o ) );
 
     //
@@ -524,26 +1072,31 @@ bool apemode::State::Finalize( ) {
     //
 
     console->info( "> Verification" );
+    bool verified = false; {
+        FBXP_PROFILE_SCOPE( "Verification" );
+        flatbuffers::Verifier v( builder.GetBufferPointer( ), builder.GetSize( ) );
+        verified = apemodefb::VerifySceneFbBuffer( v );
+    }
 
-    flatbuffers::Verifier v( builder.GetBufferPointer( ), builder.GetSize( ) );
-    if ( apemodefb::VerifySceneFbBuffer( v ) )
+    if ( verified )
         console->info( "< Succeeded" );
     else {
         assert( false );
     }
 
-    std::string output = options[ "o" ].as< std::string >( );
-    if ( output.empty( ) ) {
-        output = folderPath + fileName + "." + apemodefb::SceneFbExtension( );
-    } else {
+    const std::string output = GetOutputFile( );
+    if ( false == outputFile.empty( ) ) {
         std::string outputFolder;
         SplitFilename( output, &outputFolder, nullptr );
         MakeDirectory( outputFolder.c_str( ) );
     }
 
     console->info( "> Saving to: {}", output.c_str( ) );
+    FBXP_PROFILE_SCOPE( "Save", output.c_str( ) );
     if ( flatbuffers::SaveFile( output.c_str( ), (const char*) builder.GetBufferPointer( ), (size_t) builder.GetSize( ), true ) ) {
-        console->info( "+ {} ({}, {}) ", ToPrettySizeString( builder.GetSize( ) ), builder.GetSize( ), ResolveFullPath( output.c_str( ) ) );
+        summary->info( "Saved {} ({}, {}) ", ToPrettySizeString( builder.GetSize( ) ), builder.GetSize( ), ResolveFullPath( output.c_str( ) ) );
+        report.outputFile = ResolveFullPath( output.c_str( ) );
+        report.outputSize = builder.GetSize( );
         console->info( "< Succeeded" );
         return true;
     }
@@ -575,38 +1128,94 @@ apemode::ValueId apemode::State::PushValue( const bool value ) {
 }
 
 
+/**
+ * Note: Do not compare name_id and id.
+ **/
+static bool TextureEquals( const apemodefb::TextureFb& texture, const apemodefb::TextureFb& other ) {
+    return texture.alpha_source( )            == other.alpha_source( ) &&
+           texture.blend_mode( )              == other.blend_mode( ) &&
+           texture.wrap_mode_u( )             == other.wrap_mode_u( ) &&
+           texture.wrap_mode_v( )             == other.wrap_mode_v( ) &&
+           texture.mapping_type( )            == other.mapping_type( ) &&
+           texture.file_id( )                 == other.file_id( ) &&
+           texture.offset_u( )                == other.offset_u( ) &&
+           texture.offset_v( )                == other.offset_v( ) &&
+           texture.scale_u( )                 == other.scale_u( ) &&
+           texture.scale_v( )                 == other.scale_v( ) &&
+           texture.premultiplied_alpha( )     == other.premultiplied_alpha( ) &&
+           texture.swap_uv( )                 == other.swap_uv( ) &&
+           texture.rotation_u( )              == other.rotation_u( ) &&
+           texture.rotation_v( )              == other.rotation_v( ) &&
+           texture.rotation_w( )              == other.rotation_w( ) &&
+           texture.wipe_mode( )               == other.wipe_mode( ) &&
+           texture.texture_use( )             == other.texture_use( ) &&
+           texture.texture_type_id( )         == other.texture_type_id( ) &&
+           texture.planar_mapping_normal( )   == other.planar_mapping_normal( ) &&
+           texture.cropping_bottom( )         == other.cropping_bottom( ) &&
+           texture.cropping_left( )           == other.cropping_left( ) &&
+           texture.cropping_right( )          == other.cropping_right( ) &&
+           texture.cropping_top( )            == other.cropping_top( );
+}
+
+void HashCombine( uint64_t& hash, const void* pData, size_t dataSize ) {
+    const uint8_t* pBytes = reinterpret_cast< const uint8_t* >( pData );
+    for ( size_t i = 0; i < dataSize; ++i ) {
+        hash ^= pBytes[ i ];
+        hash *= 0x100000001b3ull;
+    }
+}
+
+/**
+ * Hashes exactly the fields compared in TextureEquals.
+ **/
+static uint64_t TextureHash( const apemodefb::TextureFb& texture ) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    HashCombine( hash, texture.alpha_source( ) );
+    HashCombine( hash, texture.blend_mode( ) );
+    HashCombine( hash, texture.wrap_mode_u( ) );
+    HashCombine( hash, texture.wrap_mode_v( ) );
+    HashCombine( hash, texture.mapping_type( ) );
+    HashCombine( hash, texture.file_id( ) );
+    HashCombine( hash, texture.offset_u( ) );
+    HashCombine( hash, texture.offset_v( ) );
+    HashCombine( hash, texture.scale_u( ) );
+    HashCombine( hash, texture.scale_v( ) );
+    HashCombine( hash, texture.premultiplied_alpha( ) );
+    HashCombine( hash, texture.swap_uv( ) );
+    HashCombine( hash, texture.rotation_u( ) );
+    HashCombine( hash, texture.rotation_v( ) );
+    HashCombine( hash, texture.rotation_w( ) );
+    HashCombine( hash, texture.wipe_mode( ) );
+    HashCombine( hash, texture.texture_use( ) );
+    HashCombine( hash, texture.texture_type_id( ) );
+    HashCombine( hash, texture.planar_mapping_normal( ) );
+    HashCombine( hash, texture.cropping_bottom( ) );
+    HashCombine( hash, texture.cropping_left( ) );
+    HashCombine( hash, texture.cropping_right( ) );
+    HashCombine( hash, texture.cropping_top( ) );
+    return hash;
+}
+
 uint32_t apemode::State::PushValue( const apemodefb::TextureFb & other ) {
-    for ( uint32_t i = 0; i < textures.size( ); ++i ) {
-        const auto& texture = textures[ i ];
-
-        //
-        // Note: Do not compare name_id and id
-        //
-
-        if ( texture.alpha_source( )            == other.alpha_source( ) &&
-             texture.blend_mode( )              == other.blend_mode( ) &&
-             texture.wrap_mode_u( )             == other.wrap_mode_u( ) &&
-             texture.wrap_mode_v( )             == other.wrap_mode_v( ) &&
-             texture.mapping_type( )            == other.mapping_type( ) &&
-             texture.file_id( )                 == other.file_id( ) &&
-             texture.offset_u( )                == other.offset_u( ) &&
-             texture.offset_v( )                == other.offset_v( ) &&
-             texture.scale_u( )                 == other.scale_u( ) &&
-             texture.scale_v( )                 == other.scale_v( ) &&
-             texture.premultiplied_alpha( )     == other.premultiplied_alpha( ) &&
-             texture.swap_uv( )                 == other.swap_uv( ) &&
-             texture.rotation_u( )              == other.rotation_u( ) &&
-             texture.rotation_v( )              == other.rotation_v( ) &&
-             texture.rotation_w( )              == other.rotation_w( ) &&
-             texture.wipe_mode( )               == other.wipe_mode( ) &&
-             texture.texture_use( )             == other.texture_use( ) &&
-             texture.texture_type_id( )         == other.texture_type_id( ) &&
-             texture.planar_mapping_normal( )   == other.planar_mapping_normal( ) &&
-             texture.cropping_bottom( )         == other.cropping_bottom( ) &&
-             texture.cropping_left( )           == other.cropping_left( ) &&
-             texture.cropping_right( )          == other.cropping_right( ) &&
-             texture.cropping_top( )            == other.cropping_top( ) ) {
 
+    //
+    // Note: The lookup is cleared when the textures are replaced (python extensions, packing),
+    //       and rebuilt here in case it does not match the collection anymore.
+    //
+
+    if ( textureHashDict.size( ) != textures.size( ) ) {
+        textureHashDict.clear( );
+        textureHashDict.reserve( textures.size( ) );
+        for ( uint32_t i = 0; i < textures.size( ); ++i ) {
+            textureHashDict.emplace( TextureHash( textures[ i ] ), i );
+        }
+    }
+
+    const uint64_t hash = TextureHash( other );
+    const auto range = textureHashDict.equal_range( hash );
+    for ( auto textureIt = range.first; textureIt != range.second; ++textureIt ) {
+        const uint32_t i = textureIt->second;
+        if ( i < textures.size( ) && TextureEquals( textures[ i ], other ) ) {
             return i;
         }
     }
@@ -614,10 +1223,11 @@ uint32_t apemode::State::PushValue( const apemodefb::TextureFb & other ) {
     const uint32_t id = static_cast< uint32_t >( textures.size( ) );
     textures.push_back( other );
     textures.back().mutate_id( id );
+    textureHashDict.emplace( hash, id );
     return id;
 }
 
-uint32_t apemode::State::EmbedFile( const std::string fullPath) {
+uint32_t apemode::State::EmbedFile( const std::string fullPath, ETextureUsage usage ) {
     if ( fullPath.empty( ) || false == FileExists( fullPath.c_str( ) ) )
         return std::numeric_limits< uint32_t >::max( );
 
@@ -634,11 +1244,251 @@ uint32_t apemode::State::EmbedFile( const std::string fullPath) {
     embeddedFile.id       = embeddedFileId;
     embeddedFile.nameId   = embeddedFileNameId;
     embeddedFile.fullPath = fullPath;
+    embeddedFile.usage    = usage;
 
     embeddedFiles.emplace_back( embeddedFile );
+    filePrefetcher.Push( embeddedFileId, fullPath, usage );
     return embeddedFileId;
 }
 
+uint32_t apemode::State::EmbedGeneratedFile( const std::string& fileName, std::vector< uint8_t > fileBuffer, ETextureUsage usage ) {
+    File embeddedFile;
+    embeddedFile.id              = static_cast< uint32_t >( embeddedFiles.size( ) );
+    embeddedFile.nameId          = PushValue( fileName );
+    embeddedFile.usage           = usage;
+    embeddedFile.generatedBuffer = std::move( fileBuffer );
+
+    embeddedFiles.emplace_back( std::move( embeddedFile ) );
+    return embeddedFiles.back( ).id;
+}
+
+bool apemode::State::DeduplicateFile( File& file, const uint8_t* content ) {
+    if ( file.duplicateFileId != (uint32_t) -1 )
+        return true;
+    if ( false == file.hasContentHash )
+        return false;
+
+    /* The same image is transcoded differently for the different usages. */
+    uint64_t contentKey = file.contentHash;
+    HashCombine( contentKey, uint64_t( file.contentSize ) );
+    if ( textureFormat != "none" )
+        HashCombine( contentKey, file.usage );
+
+    const auto contentIt = embeddedFileContents.emplace( contentKey, file.id ).first;
+    if ( contentIt->second == file.id )
+        return false;
+
+    /* The sources are compared in memory when possible (the generated files have no path), otherwise on the disk. */
+    const File&    ownerFile    = embeddedFiles[ contentIt->second ];
+    const uint8_t* ownerContent = ownerFile.fullPath.empty( ) ? ownerFile.generatedBuffer.data( ) : nullptr;
+    if ( nullptr == content && file.fullPath.empty( ) )
+        content = file.generatedBuffer.data( );
+
+    bool sameContent = ownerFile.contentSize == file.contentSize;
+    if ( sameContent && content && ownerContent )
+        sameContent = 0 == memcmp( content, ownerContent, file.contentSize );
+    else if ( sameContent && content )
+        sameContent = CompareFileContent( ownerFile.fullPath.c_str( ), content, file.contentSize );
+    else if ( sameContent && ownerContent )
+        sameContent = CompareFileContent( file.fullPath.c_str( ), ownerContent, file.contentSize );
+    else if ( sameContent )
+        sameContent = CompareFileContent( file.fullPath.c_str( ), ownerFile.fullPath.c_str( ) );
+
+    /* The hash collision, the file is written separately and is not compared again. */
+    if ( false == sameContent ) {
+        console->warn( "File {} has the same hash as {}, written separately", file.fullPath, ownerFile.fullPath );
+        file.hasContentHash = false;
+        return false;
+    }
+
+    file.duplicateFileId = contentIt->second;
+    file.serialized      = true;
+    return true;
+}
+
+bool apemode::State::TranscodeFile( const std::string& fullPath, ETextureUsage usage, std::vector< uint8_t >& fileBuffer ) {
+    if ( usage == eTextureUsage_None || textureFormat == "none" || fileBuffer.empty( ) )
+        return false;
+
+    FBXP_PROFILE_SCOPE( "TranscodeTexture" );
+
+    const size_t imageSize = fileBuffer.size( );
+    std::string  errorMessage;
+    if ( false == TranscodeTexture( textureFormat, usage, fileBuffer, errorMessage ) ) {
+        console->warn( "Failed to transcode texture {} ({}), stored as is", fullPath, errorMessage );
+        return false;
+    }
+
+    console->debug( "Transcoded texture {}: {} -> {}", fullPath, ToPrettySizeString( imageSize ), ToPrettySizeString( fileBuffer.size( ) ) );
+    return true;
+}
+
+void apemode::State::SerializeMeshBuffers( Mesh& mesh ) {
+    if ( mesh.serialized )
+        return;
+
+    const auto compressionType  = mesh.hasBlockCompression ? mesh.blockCompressionType : blockCompressionType;
+    const int  compressionLevel = mesh.hasBlockCompression ? mesh.blockCompressionLevel : blockCompressionLevel;
+
+    mesh.verticesCompression = CompressBuffer( mesh.vertices, compressionType, compressionLevel );
+    mesh.indicesCompression  = CompressBuffer( mesh.indices, compressionType, compressionLevel );
+    mesh.verticesSize        = mesh.vertices.size( );
+    mesh.indicesSize         = mesh.indices.size( );
+
+    if ( splitBlobs ) {
+        mesh.verticesBlob = WriteBlob( eBlobFileType_Mesh, mesh.vertices.data( ), mesh.verticesSize, kVertexBufferAlignment );
+        mesh.indicesBlob  = WriteBlob( eBlobFileType_Mesh, mesh.indices.data( ), mesh.indicesSize, kIndexBufferAlignment );
+    } else {
+        builder.ForceVectorAlignment( mesh.verticesSize, sizeof( uint8_t ), kVertexBufferAlignment );
+        mesh.verticesOffset = builder.CreateVector( mesh.vertices );
+
+        builder.ForceVectorAlignment( mesh.indicesSize, sizeof( uint8_t ), kIndexBufferAlignment );
+        mesh.indicesOffset = builder.CreateVector( mesh.indices );
+    }
+
+    mesh.serialized = true;
+
+    decltype( mesh.vertices )( ).swap( mesh.vertices );
+    decltype( mesh.indices )( ).swap( mesh.indices );
+}
+
+void apemode::State::SerializeAnimCurveKeys( AnimCurve& curve ) {
+    if ( curve.serialized )
+        return;
+
+    curve.keysCompression = CompressBuffer( curve.keys );
+    curve.keysSize        = curve.keys.size( );
+    if ( splitBlobs ) {
+        curve.keysBlob = WriteBlob( eBlobFileType_Anim, curve.keys.data( ), curve.keysSize, kAnimCurveAlignment );
+    } else {
+        builder.ForceVectorAlignment( curve.keysSize, sizeof( uint8_t ), kAnimCurveAlignment );
+        curve.keysOffset = builder.CreateVector( curve.keys );
+    }
+
+    curve.serialized = true;
+
+    decltype( curve.keys )( ).swap( curve.keys );
+}
+
+void apemode::State::SerializePrefetchedFiles( ) {
+    /* The material textures can be replaced by the packed ones in Finalize, they are kept in the prefetcher until then. */
+    if ( packOrm || atlasMaxSize )
+        return;
+
+    FBXP_PROFILE_SCOPE( "SerializePrefetchedFiles" );
+
+    uint32_t fileId = 0;
+    uint64_t contentHash = 0;
+    size_t   contentSize = 0;
+    std::vector< uint8_t > fileBuffer;
+
+    while ( filePrefetcher.AcquireReady( fileId, fileBuffer, contentHash, contentSize ) ) {
+        auto& embeddedFile = embeddedFiles[ fileId ];
+        assert( embeddedFile.id == fileId && false == embeddedFile.serialized );
+        embeddedFile.contentHash    = contentHash;
+        embeddedFile.contentSize    = contentSize;
+        embeddedFile.hasContentHash = true;
+        SerializeFileBuffer( embeddedFile, fileBuffer );
+    }
+}
+
+void apemode::State::SerializeFileBuffer( File& file, std::vector< uint8_t >& fileBuffer ) {
+    if ( DeduplicateFile( file, nullptr ) ) {
+        decltype( fileBuffer )( ).swap( fileBuffer );
+        return;
+    }
+
+    if ( file.usage != eTextureUsage_None )
+        file.hasTextureInfo = ReadKtx2TextureInfo( fileBuffer.data( ), fileBuffer.size( ), file.textureInfo );
+
+    file.bufferCompression = CompressBuffer( fileBuffer );
+    file.bufferSize        = fileBuffer.size( );
+    if ( splitBlobs ) {
+        file.bufferBlob = WriteBlob( eBlobFileType_Texture, fileBuffer.data( ), file.bufferSize, kFileBufferAlignment );
+    } else {
+        builder.ForceVectorAlignment( file.bufferSize, sizeof( uint8_t ), kFileBufferAlignment );
+        file.bufferOffset = builder.CreateVector( fileBuffer );
+    }
+
+    file.serialized = true;
+
+    decltype( fileBuffer )( ).swap( fileBuffer );
+}
+
+apemodefb::BlockCompressionFb apemode::State::CompressBuffer( std::vector< uint8_t >& buffer ) {
+    return CompressBuffer( buffer, blockCompressionType, blockCompressionLevel );
+}
+
+apemodefb::BlockCompressionFb apemode::State::CompressBuffer( std::vector< uint8_t >&       buffer,
+                                                              apemodefb::ECompressionTypeFb compressionType,
+                                                              int                           compressionLevel ) {
+    const apemodefb::BlockCompressionFb uncompressed( apemodefb::ECompressionTypeFb_None, 0, static_cast< uint32_t >( buffer.size( ) ) );
+    if ( compressionType == apemodefb::ECompressionTypeFb_None || buffer.empty( ) ||
+         buffer.size( ) > std::numeric_limits< uint32_t >::max( ) )
+        return uncompressed;
+
+    FBXP_PROFILE_SCOPE( "CompressBuffer" );
+
+    std::vector< uint8_t > compressedBuffer;
+    if ( false == CompressBlock( compressionType, compressionLevel, buffer.data( ), buffer.size( ), compressedBuffer ) ) {
+        console->warn( "Failed to compress {} buffer, stored uncompressed", ToPrettySizeString( buffer.size( ) ) );
+        return uncompressed;
+    }
+
+    /* The already compressed buffers (Draco, images) are kept as is, decoding them would only cost time. */
+    if ( compressedBuffer.size( ) >= buffer.size( ) )
+        return uncompressed;
+
+    buffer.swap( compressedBuffer );
+    return apemodefb::BlockCompressionFb( compressionType, int8_t( compressionLevel ), uncompressed.uncompressed_size( ) );
+}
+
+apemodefb::BlobRefFb apemode::State::WriteBlob( EBlobFileType blobFileType, const void* data, size_t dataSize, size_t alignment ) {
+    static const char* const kBlobFileExtensions[ eBlobFileTypeCount ] = {"fbxpmesh", "fbxpanim", "fbxptex"};
+
+    auto& blobFile = blobFiles[ blobFileType ];
+    if ( blobFile.id == (uint32_t) -1 ) {
+        const std::string output = GetOutputFile( );
+        if ( false == outputFile.empty( ) ) {
+            std::string outputFolder;
+            SplitFilename( output, &outputFolder, nullptr );
+            MakeDirectory( outputFolder.c_str( ) );
+        }
+
+        /* The names are relative to the scene file, the files are expected next to it. */
+        blobFile.id = static_cast< uint32_t >( blobFileNames.size( ) );
+        blobFile.Open( ReplaceExtension( output.c_str( ), kBlobFileExtensions[ blobFileType ] ) );
+        blobFileNames.push_back( GetFileName( blobFile.fullPath.c_str( ) ) );
+
+        if ( blobFile.failed )
+            console->error( "Failed to open blob file: {}", blobFile.fullPath );
+    }
+
+    /* The size is 32-bit, the offset is 64-bit, the blob file itself is not limited. */
+    uint64_t offset = 0;
+    if ( dataSize > std::numeric_limits< uint32_t >::max( ) ) {
+        console->error( "Blob is too large: {} ({})", ToPrettySizeString( dataSize ), blobFile.fullPath );
+        blobFile.failed = true;
+    } else {
+        /* The failures are reported when the file is closed. */
+        blobFile.Append( data, dataSize, alignment, offset );
+    }
+
+    return apemodefb::BlobRefFb( blobFile.id, static_cast< uint32_t >( dataSize ), offset );
+}
+
+bool apemode::State::CloseBlobFiles( ) {
+    bool closed = true;
+    for ( auto& blobFile : blobFiles ) {
+        if ( blobFile.id != (uint32_t) -1 && false == blobFile.Close( ) ) {
+            console->error( "Failed to write blob file: {}", blobFile.fullPath );
+            closed = false;
+        }
+    }
+
+    return closed;
+}
+
 apemode::ValueId apemode::State::PushValue( const int32_t value ) {
     return apemode::ValueId( apemodefb::EValueTypeFb_Int, static_cast< uint32_t >( VectorInsertUnique( intValues, value ) ) );
 }
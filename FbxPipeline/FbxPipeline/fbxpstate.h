@@ -1,6 +1,9 @@
 #pragma once
 
 #include <fbxppch.h>
+#include <fbxpprofiler.h>
+#include <fbxpreport.h>
+#include <fbxpcache.h>
 #include <scene_generated.h>
 
 #ifndef DebugBreak
@@ -12,6 +15,21 @@ inline void DebugBreak( ) {
 #define ARRAYSIZE( arr ) sizeof( arr ) / sizeof( arr[ 0 ] )
 #endif
 
+/* FNV-1a, 64 bit (the texture lookup, the build cache keys). */
+void HashCombine( uint64_t& hash, const void* pData, size_t dataSize );
+
+template < typename T >
+inline void HashCombine( uint64_t& hash, const T value ) {
+    HashCombine( hash, &value, sizeof( T ) );
+}
+
+/* Floats that compare equal must hash equal, -0.0f is folded into 0.0f. */
+template <>
+inline void HashCombine< float >( uint64_t& hash, const float value ) {
+    const float canonicalValue = value == 0.0f ? 0.0f : value;
+    HashCombine( hash, &canonicalValue, sizeof( float ) );
+}
+
 namespace apemode {
     struct Stopwatch {
         std::chrono::high_resolution_clock::time_point a{};
@@ -24,6 +42,137 @@ namespace apemode {
         }
     };
 
+    /* How the embedded file is sampled, picks the texture format and the mip filter (--texture-format). */
+    enum ETextureUsage {
+        eTextureUsage_None, /* Not a texture (--embed-file, scripts), stored as is. */
+        eTextureUsage_Color,
+        eTextureUsage_Data,
+        eTextureUsage_Normal,
+    };
+
+    /* The image placement in the texture atlas (--atlas-max-size), the rectangle excludes the gutters. */
+    struct TextureAtlasTile {
+        uint32_t atlasIndex  = (uint32_t) -1; /* Not packed. */
+        uint32_t x           = 0;
+        uint32_t y           = 0;
+        uint32_t width       = 0;
+        uint32_t height      = 0;
+        uint32_t atlasWidth  = 0;
+        uint32_t atlasHeight = 0;
+    };
+
+    /**
+     * Reads the embedded files on the background threads while the scene is being exported.
+     * The total size of the prefetched buffers, that were not yet acquired, is limited by the memory budget.
+     * The files that do not fit into the budget or were not read yet are read by the caller (see State::Finalize).
+     **/
+    struct FilePrefetcher {
+        enum EState { eState_Queued, eState_Reading, eState_Ready, eState_Failed, eState_Taken };
+
+        struct Entry {
+            std::string            fullPath;
+            ETextureUsage          usage = eTextureUsage_None;
+            std::vector< uint8_t > buffer;
+            uint64_t               contentHash = 0;
+            size_t                 contentSize = 0; /* The source size, the buffer can be transcoded. */
+            EState                 state = eState_Queued;
+        };
+
+        /* Runs on the worker after the file is read (texture transcoding), can replace the buffer. Set before Start. */
+        std::function< void( const std::string&, ETextureUsage, std::vector< uint8_t >& ) > process;
+
+        std::vector< std::thread > workers;
+        std::deque< uint32_t >     queue;
+        std::deque< uint32_t >     ready;
+        std::vector< Entry >       entries;
+        std::mutex                 mutex;
+        std::condition_variable    cv;
+        uint32_t                   threadCount = 0;
+        size_t                     budget      = 0;
+        size_t                     budgetUsed  = 0;
+        bool                       stop        = false;
+
+        ~FilePrefetcher( );
+
+        void Start( uint32_t workerCount, size_t memoryBudget );
+        void Stop( );
+        void Push( uint32_t fileId, const std::string& fullPath, ETextureUsage usage );
+        bool Acquire( uint32_t fileId, std::vector< uint8_t >& buffer, uint64_t& contentHash, size_t& contentSize );
+        bool AcquireReady( uint32_t& fileId, std::vector< uint8_t >& buffer, uint64_t& contentHash, size_t& contentSize );
+        /* Puts the acquired (or read by the caller) buffer back, the file is acquired again in State::Finalize. */
+        void Restore( uint32_t fileId, std::vector< uint8_t >& buffer, uint64_t contentHash, size_t contentSize );
+        void Run( );
+    };
+
+    /**
+     * FlatBufferBuilder that can reserve the memory upfront.
+     * The builder grows by doubling its storage, and every growth copies the already serialized data.
+     **/
+    struct FlatBufferBuilder : flatbuffers::FlatBufferBuilder {
+        using flatbuffers::FlatBufferBuilder::FlatBufferBuilder;
+
+        void Reserve( size_t size ) {
+            const size_t currentSize = GetSize( );
+            if ( size > currentSize && buf_.capacity( ) < size ) {
+                buf_.make_space( size - currentSize );
+                buf_.pop( size - currentSize );
+            }
+        }
+
+        /**
+         * Pads the buffer so that the next vector of len elements starts at the aligned offset within the file.
+         * Must be called right before creating the vector.
+         * The alignment is also tracked for the final buffer size, so the offsets stay aligned after Finish.
+         **/
+        void ForceVectorAlignment( size_t len, size_t elemsize, size_t alignment ) {
+            assert( alignment && ( alignment & ( alignment - 1 ) ) == 0 );
+            minalign_ = std::max( minalign_, alignment );
+            PreAlign( len * elemsize, alignment );
+        }
+
+        /* Drops everything written after the builder had the size (the vector that is not referenced after all). */
+        void Rollback( flatbuffers::uoffset_t size ) {
+            assert( size <= GetSize( ) );
+            buf_.pop( GetSize( ) - size );
+        }
+    };
+
+    /* Alignments of the blobs within the output file (mapped file can be used directly by the GPU or SIMD decoders). */
+    static const size_t kVertexBufferAlignment = 64;
+    static const size_t kIndexBufferAlignment  = 64;
+    static const size_t kAnimCurveAlignment    = 16;
+    static const size_t kFileBufferAlignment   = 256;
+
+    typedef flatbuffers::Offset< flatbuffers::Vector< uint8_t > > ByteVectorOffset;
+
+    /**
+     * Sidecar file of the split mode (--split-blobs argument).
+     * The heavy buffers are appended to it instead of the scene buffer and are referenced with BlobRefFb,
+     * the file is written sequentially and can exceed the 2 GB limit of the scene buffer.
+     **/
+    struct BlobFile {
+        std::string fullPath;
+        uint32_t    id     = (uint32_t) -1;
+        uint64_t    size   = 0;
+        FILE*       stream = nullptr;
+        bool        failed = false;
+
+        ~BlobFile( );
+
+        bool Open( const std::string& filePath );
+        /* Pads the file to the alignment and appends the data, returns the offset of the data. */
+        bool Append( const void* data, size_t dataSize, size_t alignment, uint64_t& offset );
+        /* Returns false if any of the writes failed. */
+        bool Close( );
+    };
+
+    enum EBlobFileType {
+        eBlobFileType_Mesh,
+        eBlobFileType_Anim,
+        eBlobFileType_Texture,
+        eBlobFileTypeCount
+    };
+
     apemodefb::Mat4Fb Cast(const FbxAMatrix m);
     apemodefb::DualQuatFb Cast(const FbxDualQuaternion dq);
 
@@ -73,6 +222,20 @@ namespace apemode {
         std::vector< uint32_t >             animCurveIds;
         apemodefb::EIndexTypeFb             indexType;
         uint32_t                            skinId = -1;
+        ByteVectorOffset                    verticesOffset;
+        ByteVectorOffset                    indicesOffset;
+        size_t                              verticesSize = 0;
+        size_t                              indicesSize  = 0;
+        apemodefb::BlobRefFb                verticesBlob;
+        apemodefb::BlobRefFb                indicesBlob;
+        apemodefb::BlockCompressionFb       verticesCompression;
+        apemodefb::BlockCompressionFb       indicesCompression;
+        bool                                serialized   = false;
+
+        /* Block codec picked for the mesh (--mesh-compression auto, meshopt), the global one is used otherwise. */
+        bool                                hasBlockCompression   = false;
+        apemodefb::ECompressionTypeFb       blockCompressionType  = apemodefb::ECompressionTypeFb_None;
+        int                                 blockCompressionLevel = 0;
     };
 
     struct FBXPIPELINE_API Node {
@@ -123,6 +286,11 @@ namespace apemode {
         apemodefb::EAnimCurveKeyTypeFb  keyType;
         apemodefb::ECompressionTypeFb   compressionType;
         std::vector< uint8_t >          keys;
+        ByteVectorOffset                keysOffset;
+        size_t                          keysSize   = 0;
+        apemodefb::BlobRefFb            keysBlob;
+        apemodefb::BlockCompressionFb   keysCompression;
+        bool                            serialized = false;
     };
 
     struct FBXPIPELINE_API Material {
@@ -133,9 +301,23 @@ namespace apemode {
     };
 
     struct FBXPIPELINE_API File {
-        uint32_t    id;
-        uint32_t    nameId;
-        std::string fullPath;
+        uint32_t                      id;
+        uint32_t                      nameId;
+        std::string                   fullPath;
+        ByteVectorOffset              bufferOffset;
+        size_t                        bufferSize = 0;
+        apemodefb::BlobRefFb          bufferBlob;
+        apemodefb::BlockCompressionFb bufferCompression;
+        bool                          serialized      = false;
+        ETextureUsage                 usage           = eTextureUsage_None;
+        apemodefb::TextureInfoFb      textureInfo;
+        bool                          hasTextureInfo  = false;
+        uint64_t                      contentHash     = 0;
+        size_t                        contentSize     = 0; /* The source size, before transcoding. */
+        bool                          hasContentHash  = false;
+        uint32_t                      duplicateFileId = (uint32_t) -1; /* The file with the same contents that is written instead. */
+        std::vector< uint8_t >        generatedBuffer; /* The contents of the generated files (packed textures), fullPath is empty. Kept until all the files are written (see DeduplicateFile). */
+        bool                          packed          = false; /* Replaced by the packed texture or atlas and not referenced, not written. */
     };
 
     struct FBXPIPELINE_API State {
@@ -143,15 +325,26 @@ namespace apemode {
         FbxScene*                                   scene   = nullptr;
         std::string                                 executableName;
         std::shared_ptr< spdlog::logger >           console;
-        flatbuffers::FlatBufferBuilder              builder;
+        std::shared_ptr< spdlog::logger >           summary; /* Stage summaries, same as console unless --quiet. */
+        Profiler&                                   profiler = Profiler::Get( );
+        BuildReport                                 report;
+        BuildCache                                  cache;
+        apemode::FlatBufferBuilder                  builder;
         cxxopts::Options                            options;
+        std::string                                 inputFile;
+        std::string                                 outputFile;
         std::string                                 fileName;
         std::string                                 folderPath;
         std::vector< Node >                         nodes;
         std::vector< Material >                     materials;
         std::vector< File >                         embeddedFiles;
+        std::unordered_map< uint64_t, uint32_t >    embeddedFileContents; /* Content key -> id of the written file. */
+        FilePrefetcher                              filePrefetcher;
+        BlobFile                                    blobFiles[ eBlobFileTypeCount ];
+        std::vector< std::string >                  blobFileNames;
         std::map< uint64_t, uint32_t >              nodeDict;
         std::map< uint64_t, uint32_t >              textureDict;
+        std::unordered_multimap< uint64_t, uint32_t > textureHashDict;
         std::map< uint64_t, uint32_t >              materialDict;
         std::map< uint64_t, uint32_t >              animStackDict;
         std::map< uint64_t, uint32_t >              animLayerDict;
@@ -166,6 +359,11 @@ namespace apemode {
         std::vector< AnimCurve >                    animCurves;
         std::vector< Skin >                         skins;
         std::vector< std::string >                  searchLocations;
+        std::vector< int64_t >                      searchLocationWriteTimes; /* Directory write times at indexing, see UpdateSearchLocations. */
+        std::unordered_map< std::string, std::vector< std::string > > searchLocationFiles;
+        std::vector< std::string >                  searchLocationFilePaths;
+        std::string                                 searchLocationsInputFile;
+        std::set< std::string >                     unresolvedFiles; /* The names that were not found in the search locations. */
         std::vector< bool >                         boolValues;
         std::vector< int32_t >                      intValues;
         std::vector< float >                        floatValues;
@@ -177,14 +375,41 @@ namespace apemode {
 
         bool legacyTriangulationSdk = false;
 
+        /* Block compression of the serialized buffers (--block-compression), parsed in Initialize. */
+        apemodefb::ECompressionTypeFb blockCompressionType  = apemodefb::ECompressionTypeFb_None;
+        int                           blockCompressionLevel = 0;
+        /* Block compression of the meshopt vertex and index buffers, LZ4 unless --block-compression is set. */
+        apemodefb::ECompressionTypeFb meshoptBlockCompressionType  = apemodefb::ECompressionTypeFb_None;
+        int                           meshoptBlockCompressionLevel = 0;
+
+        /* GPU format of the embedded textures (--texture-format), "none" keeps the source images. */
+        std::string textureFormat = "none";
+        /* The occlusion, roughness and metalness maps of the materials are packed into a texture (--pack-orm). */
+        bool packOrm = false;
+        /* The heavy buffers are written to the sidecar blob files (--split-blobs). */
+        bool splitBlobs = false;
+        /* The textures up to this size are packed into the atlases of atlasSize (--atlas-max-size, --atlas-size), 0 disables. */
+        uint32_t atlasMaxSize = 0;
+        uint32_t atlasSize    = 2048;
+
         State( );
         ~State( );
 
+        /* Copies the parsed options and the logger of the main state to the worker state. */
+        void InheritSettings( const State& other );
+
         bool Initialize( );
         void Release( );
+        void Reset( );
+        /* The python scripts are executed again on the next finalization (watch mode). */
+        void ReloadScripts( );
+        void SetInputFile( const std::string& filePath );
         bool Load( );
         bool Finalize( );
 
+        /* The output file, or the input file with the scene extension if it is empty. */
+        std::string GetOutputFile( ) const;
+
         ValueId  PushValue( const char* value );
         ValueId  PushValue( const std::string& value );
         ValueId  PushValue( const int32_t value );
@@ -195,8 +420,50 @@ namespace apemode {
         ValueId  PushValue( const bool value );
         uint32_t PushValue( const apemodefb::TextureFb& value );
 
-        uint32_t EmbedFile( const std::string fullPath );
+        uint32_t EmbedFile( const std::string fullPath, ETextureUsage usage = eTextureUsage_None );
+        /* Embeds the file generated during the export, the name is used for the FileFb. */
+        uint32_t EmbedGeneratedFile( const std::string& fileName, std::vector< uint8_t > fileBuffer, ETextureUsage usage );
+        /* Replaces the image with the KTX2 payload of the texture format, returns false if the buffer is kept as is. */
+        bool TranscodeFile( const std::string& fullPath, ETextureUsage usage, std::vector< uint8_t >& fileBuffer );
+        /**
+         * Marks the file as the duplicate of the written file with the same contents (and usage for the transcoded textures).
+         * Otherwise the file becomes the owner of its contents and has to be written, returns false.
+         * The files with the same hash and size are compared byte by byte, the content is the source of the file if it is in memory,
+         * nullptr to read the source from the disk.
+         **/
+        bool DeduplicateFile( File& file, const uint8_t* content );
+
+        /* Write the heavy buffers to the builder as soon as they are final and release the memory. */
+        void SerializeMeshBuffers( Mesh& mesh );
+        void SerializeAnimCurveKeys( AnimCurve& curve );
+        void SerializePrefetchedFiles( );
+        void SerializeFileBuffer( File& file, std::vector< uint8_t >& fileBuffer );
+
+        /**
+         * Compresses the buffer in place with the block codec and returns the descriptor with the uncompressed size.
+         * The buffer is kept as is (compression type None) if the codec is disabled or the buffer does not shrink.
+         **/
+        apemodefb::BlockCompressionFb CompressBuffer( std::vector< uint8_t >& buffer );
+        apemodefb::BlockCompressionFb CompressBuffer( std::vector< uint8_t >& buffer, apemodefb::ECompressionTypeFb compressionType, int compressionLevel );
+
+        /* Appends the data to the blob file of the type, the file is created next to the output on the first write. */
+        apemodefb::BlobRefFb WriteBlob( EBlobFileType blobFileType, const void* data, size_t dataSize, size_t alignment );
+        /* Closes the blob files, returns false if any of them failed. */
+        bool CloseBlobFiles( );
+
+        /**
+         * Makes the state current for the calling thread for the lifetime of the scope.
+         * The export stages receive the state explicitly, Get is left for the helpers
+         * (logging, file search, python bindings) that run under the current state.
+         **/
+        struct FBXPIPELINE_API CurrentScope {
+            State* previous;
+
+            CurrentScope( State& state );
+            ~CurrentScope( );
+        };
 
+        /* Returns the current state of the calling thread, or the main state. */
         static State& Get( );
         static State& Main( int argc, const char**& argv );
     };
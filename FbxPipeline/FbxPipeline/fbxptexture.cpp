@@ -0,0 +1,620 @@
+#include <fbxppch.h>
+#include <fbxpstate.h>
+
+#include <stb_image.h>
+#include <stb_image_write.h>
+#include <rgbcx.h>
+#include <bc7enc.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+
+/**
+ * Texture transcoding (--texture-format).
+ * The source images are decoded to RGBA8, the mip chain is built with the 2x2 box filter
+ * (in linear space for the color textures, renormalized for the normal maps), and the levels are encoded
+ * to the block format and written as the KTX2 payload (Vulkan format, level index and data format descriptor),
+ * the runtime can upload the levels directly. The metadata is duplicated to FileFb.texture_info.
+ **/
+
+namespace {
+    const uint8_t kKtx2Identifier[ 12 ] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+    const size_t kKtx2HeaderSize     = 80; /* Identifier, header and index. */
+    const size_t kKtx2LevelIndexSize = 24; /* Byte offset, byte length and uncompressed byte length. */
+    const int    kRgbcxLevel         = 10; /* 0 (fastest) - 18 (best), rgbcx::MAX_LEVEL. */
+
+    /* The Vulkan formats and the Khronos data format values of the texture formats. */
+    struct TextureFormatDesc {
+        uint32_t vkFormat;
+        uint32_t blockSize;  /* Bytes of the 4x4 block, or of the pixel for the uncompressed formats. */
+        uint32_t blockWidth; /* 4 for the block formats, 1 otherwise. */
+        uint8_t  colorModel;
+        bool     srgb;
+    };
+
+    TextureFormatDesc GetTextureFormatDesc( apemodefb::ETextureFormatFb format ) {
+        switch ( format ) {
+            case apemodefb::ETextureFormatFb_RGBA8:      return {37, 4, 1, 1, false};
+            case apemodefb::ETextureFormatFb_RGBA8_sRGB: return {43, 4, 1, 1, true};
+            case apemodefb::ETextureFormatFb_BC1:        return {131, 8, 4, 128, false};
+            case apemodefb::ETextureFormatFb_BC1_sRGB:   return {132, 8, 4, 128, true};
+            case apemodefb::ETextureFormatFb_BC3:        return {137, 16, 4, 130, false};
+            case apemodefb::ETextureFormatFb_BC3_sRGB:   return {138, 16, 4, 130, true};
+            case apemodefb::ETextureFormatFb_BC5:        return {141, 16, 4, 132, false};
+            case apemodefb::ETextureFormatFb_BC7:        return {145, 16, 4, 134, false};
+            case apemodefb::ETextureFormatFb_BC7_sRGB:   return {146, 16, 4, 134, true};
+            default:                                     return {0, 0, 0, 0, false};
+        }
+    }
+
+    struct Image {
+        uint32_t               width  = 0;
+        uint32_t               height = 0;
+        std::vector< uint8_t > pixels; /* RGBA8 */
+    };
+
+    float SrgbToLinear( uint8_t value ) {
+        static const std::array< float, 256 > lut = [] {
+            std::array< float, 256 > values;
+            for ( uint32_t i = 0; i < 256; ++i ) {
+                const float v = i / 255.0f;
+                values[ i ]   = v <= 0.04045f ? v / 12.92f : std::pow( ( v + 0.055f ) / 1.055f, 2.4f );
+            }
+            return values;
+        }( );
+
+        return lut[ value ];
+    }
+
+    uint8_t LinearToSrgb( float value ) {
+        value = std::min( 1.0f, std::max( 0.0f, value ) );
+        value = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow( value, 1.0f / 2.4f ) - 0.055f;
+        return uint8_t( value * 255.0f + 0.5f );
+    }
+
+    uint8_t ToUNorm8( float value ) {
+        return uint8_t( std::min( 1.0f, std::max( 0.0f, value ) ) * 255.0f + 0.5f );
+    }
+
+    /* The next level of the mip chain, odd dimensions clamp the last row and column. */
+    Image Downsample( const Image& src, apemode::ETextureUsage usage ) {
+        Image dst;
+        dst.width  = std::max( 1u, src.width / 2 );
+        dst.height = std::max( 1u, src.height / 2 );
+        dst.pixels.resize( dst.width * dst.height * 4 );
+
+        for ( uint32_t y = 0; y < dst.height; ++y ) {
+            const uint32_t y0 = std::min( y * 2, src.height - 1 );
+            const uint32_t y1 = std::min( y * 2 + 1, src.height - 1 );
+
+            for ( uint32_t x = 0; x < dst.width; ++x ) {
+                const uint32_t x0 = std::min( x * 2, src.width - 1 );
+                const uint32_t x1 = std::min( x * 2 + 1, src.width - 1 );
+
+                const uint8_t* texels[ 4 ] = {&src.pixels[ ( y0 * src.width + x0 ) * 4 ],
+                                              &src.pixels[ ( y0 * src.width + x1 ) * 4 ],
+                                              &src.pixels[ ( y1 * src.width + x0 ) * 4 ],
+                                              &src.pixels[ ( y1 * src.width + x1 ) * 4 ]};
+
+                float sum[ 4 ] = {0, 0, 0, 0};
+                for ( const uint8_t* texel : texels ) {
+                    for ( uint32_t c = 0; c < 3; ++c ) {
+                        switch ( usage ) {
+                            case apemode::eTextureUsage_Color:  sum[ c ] += SrgbToLinear( texel[ c ] ); break;
+                            case apemode::eTextureUsage_Normal: sum[ c ] += texel[ c ] / 255.0f * 2.0f - 1.0f; break;
+                            default:                            sum[ c ] += texel[ c ] / 255.0f; break;
+                        }
+                    }
+
+                    /* Alpha is always linear. */
+                    sum[ 3 ] += texel[ 3 ] / 255.0f;
+                }
+
+                uint8_t* pixel = &dst.pixels[ ( y * dst.width + x ) * 4 ];
+                if ( usage == apemode::eTextureUsage_Normal ) {
+                    const float length = std::sqrt( sum[ 0 ] * sum[ 0 ] + sum[ 1 ] * sum[ 1 ] + sum[ 2 ] * sum[ 2 ] );
+                    const float scale  = length > 0.0f ? 1.0f / length : 0.0f;
+                    for ( uint32_t c = 0; c < 3; ++c ) {
+                        pixel[ c ] = ToUNorm8( sum[ c ] * scale * 0.5f + 0.5f );
+                    }
+                } else {
+                    for ( uint32_t c = 0; c < 3; ++c ) {
+                        pixel[ c ] = usage == apemode::eTextureUsage_Color ? LinearToSrgb( sum[ c ] * 0.25f ) : ToUNorm8( sum[ c ] * 0.25f );
+                    }
+                }
+
+                pixel[ 3 ] = ToUNorm8( sum[ 3 ] * 0.25f );
+            }
+        }
+
+        return dst;
+    }
+
+    void InitializeBlockEncoders( ) {
+        static std::once_flag initialized;
+        std::call_once( initialized, [] {
+            rgbcx::init( );
+            bc7enc_compress_block_init( );
+        } );
+    }
+
+    /* Encodes the level to the format, the partial blocks on the right and bottom edges repeat the edge texels. */
+    std::vector< uint8_t > EncodeLevel( const Image& level, apemodefb::ETextureFormatFb format, apemode::ETextureUsage usage ) {
+        const TextureFormatDesc desc = GetTextureFormatDesc( format );
+        if ( desc.blockWidth == 1 )
+            return level.pixels;
+
+        bc7enc_compress_block_params bc7Params;
+        bc7enc_compress_block_params_init( &bc7Params );
+        if ( usage != apemode::eTextureUsage_Color )
+            bc7enc_compress_block_params_init_linear_weights( &bc7Params );
+
+        const uint32_t blockCountX = ( level.width + 3 ) / 4;
+        const uint32_t blockCountY = ( level.height + 3 ) / 4;
+
+        std::vector< uint8_t > blocks( blockCountX * blockCountY * desc.blockSize );
+        uint8_t                blockPixels[ 16 * 4 ];
+
+        for ( uint32_t by = 0; by < blockCountY; ++by ) {
+            for ( uint32_t bx = 0; bx < blockCountX; ++bx ) {
+                for ( uint32_t i = 0; i < 16; ++i ) {
+                    const uint32_t x = std::min( bx * 4 + i % 4, level.width - 1 );
+                    const uint32_t y = std::min( by * 4 + i / 4, level.height - 1 );
+                    memcpy( &blockPixels[ i * 4 ], &level.pixels[ ( y * level.width + x ) * 4 ], 4 );
+                }
+
+                uint8_t* block = &blocks[ ( by * blockCountX + bx ) * desc.blockSize ];
+                switch ( format ) {
+                    case apemodefb::ETextureFormatFb_BC1:
+                    case apemodefb::ETextureFormatFb_BC1_sRGB:
+                        rgbcx::encode_bc1( kRgbcxLevel, block, blockPixels, false, false );
+                        break;
+                    case apemodefb::ETextureFormatFb_BC3:
+                    case apemodefb::ETextureFormatFb_BC3_sRGB:
+                        rgbcx::encode_bc3( kRgbcxLevel, block, blockPixels );
+                        break;
+                    case apemodefb::ETextureFormatFb_BC5:
+                        rgbcx::encode_bc5( block, blockPixels, 0, 1, 4 );
+                        break;
+                    default:
+                        bc7enc_compress_block( block, blockPixels, &bc7Params );
+                        break;
+                }
+            }
+        }
+
+        return blocks;
+    }
+
+    bool IsOpaque( const Image& image ) {
+        for ( size_t i = 3; i < image.pixels.size( ); i += 4 ) {
+            if ( image.pixels[ i ] != 255 )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool SelectTextureFormat( const std::string&          textureFormat,
+                              apemode::ETextureUsage      usage,
+                              const Image&                image,
+                              apemodefb::ETextureFormatFb& format ) {
+        const bool srgb = usage == apemode::eTextureUsage_Color;
+
+        /* The normal maps keep two channels in the block formats, the shaders reconstruct the third one. */
+        if ( usage == apemode::eTextureUsage_Normal && textureFormat != "rgba8" ) {
+            format = apemodefb::ETextureFormatFb_BC5;
+            return true;
+        }
+
+        if ( textureFormat == "rgba8" ) {
+            format = srgb ? apemodefb::ETextureFormatFb_RGBA8_sRGB : apemodefb::ETextureFormatFb_RGBA8;
+        } else if ( textureFormat == "bc1" || ( textureFormat == "auto" && IsOpaque( image ) ) ) {
+            format = srgb ? apemodefb::ETextureFormatFb_BC1_sRGB : apemodefb::ETextureFormatFb_BC1;
+        } else if ( textureFormat == "bc3" ) {
+            format = srgb ? apemodefb::ETextureFormatFb_BC3_sRGB : apemodefb::ETextureFormatFb_BC3;
+        } else if ( textureFormat == "bc7" || textureFormat == "auto" ) {
+            format = srgb ? apemodefb::ETextureFormatFb_BC7_sRGB : apemodefb::ETextureFormatFb_BC7;
+        } else {
+            return false;
+        }
+
+        return true;
+    }
+
+    /* The generated images (packed textures, atlases) are embedded as PNG. */
+    bool EncodePng( const Image& image, std::vector< uint8_t >& png ) {
+        const auto writeFn = []( void* context, void* data, int size ) {
+            auto buffer = static_cast< std::vector< uint8_t >* >( context );
+            buffer->insert( buffer->end( ), static_cast< uint8_t* >( data ), static_cast< uint8_t* >( data ) + size );
+        };
+
+        png.clear( );
+        return 0 != stbi_write_png_to_func( writeFn, &png, int( image.width ), int( image.height ), 4, image.pixels.data( ), int( image.width * 4 ) );
+    }
+
+    template < typename T >
+    void Write( std::vector< uint8_t >& buffer, size_t offset, T value ) {
+        memcpy( buffer.data( ) + offset, &value, sizeof( T ) );
+    }
+
+    template < typename T >
+    T Read( const uint8_t* buffer, size_t offset ) {
+        T value;
+        memcpy( &value, buffer + offset, sizeof( T ) );
+        return value;
+    }
+
+    size_t AlignOffset( size_t offset, size_t alignment ) {
+        return ( offset + alignment - 1 ) / alignment * alignment;
+    }
+
+    /* Basic data format descriptor block with a sample per channel (or per the block half for BC3 and BC5). */
+    std::vector< uint32_t > BuildDataFormatDescriptor( apemodefb::ETextureFormatFb format ) {
+        const TextureFormatDesc desc = GetTextureFormatDesc( format );
+
+        struct Sample {
+            uint32_t bitOffset;
+            uint32_t bitLength;
+            uint32_t channelId;
+            uint32_t upper;
+        };
+
+        const uint32_t kLinear = 0x10; /* The alpha sample qualifier for the sRGB formats. */
+        const uint32_t kAlpha  = 15;
+
+        std::vector< Sample > samples;
+        switch ( format ) {
+            case apemodefb::ETextureFormatFb_RGBA8:
+            case apemodefb::ETextureFormatFb_RGBA8_sRGB:
+                samples = {{0, 8, 0, 255}, {8, 8, 1, 255}, {16, 8, 2, 255}, {24, 8, kAlpha | ( desc.srgb ? kLinear : 0 ), 255}};
+                break;
+            case apemodefb::ETextureFormatFb_BC3:
+            case apemodefb::ETextureFormatFb_BC3_sRGB:
+                samples = {{0, 64, kAlpha | ( desc.srgb ? kLinear : 0 ), UINT32_MAX}, {64, 64, 0, UINT32_MAX}};
+                break;
+            case apemodefb::ETextureFormatFb_BC5:
+                samples = {{0, 64, 0, UINT32_MAX}, {64, 64, 1, UINT32_MAX}};
+                break;
+            default:
+                samples = {{0, desc.blockSize * 8, 0, UINT32_MAX}};
+                break;
+        }
+
+        const uint32_t blockSize  = 24 + 16 * uint32_t( samples.size( ) );
+        const uint32_t blockDim   = desc.blockWidth - 1;
+        const uint32_t primaries  = 1; /* BT709 */
+        const uint32_t transfer   = desc.srgb ? 2 : 1;
+
+        std::vector< uint32_t > dfd;
+        dfd.push_back( 4 + blockSize );
+        dfd.push_back( 0 ); /* Khronos vendor, basic descriptor type. */
+        dfd.push_back( 2 | ( blockSize << 16 ) );
+        dfd.push_back( desc.colorModel | ( primaries << 8 ) | ( transfer << 16 ) );
+        dfd.push_back( blockDim | ( blockDim << 8 ) );
+        dfd.push_back( desc.blockSize );
+        dfd.push_back( 0 );
+
+        for ( const auto& sample : samples ) {
+            dfd.push_back( sample.bitOffset | ( ( sample.bitLength - 1 ) << 16 ) | ( sample.channelId << 24 ) );
+            dfd.push_back( 0 );
+            dfd.push_back( 0 );
+            dfd.push_back( sample.upper );
+        }
+
+        return dfd;
+    }
+
+    /* The levels are stored from the smallest one, the level index starts from the base level. */
+    std::vector< uint8_t > WriteKtx2( const Image&                                 baseLevel,
+                                      apemodefb::ETextureFormatFb                  format,
+                                      const std::vector< std::vector< uint8_t > >& levels ) {
+        const TextureFormatDesc       desc = GetTextureFormatDesc( format );
+        const std::vector< uint32_t > dfd  = BuildDataFormatDescriptor( format );
+
+        const size_t levelAlignment = desc.blockSize % 4 == 0 ? desc.blockSize : desc.blockSize * 4;
+        const size_t dfdOffset      = kKtx2HeaderSize + kKtx2LevelIndexSize * levels.size( );
+        const size_t dfdSize        = dfd.size( ) * sizeof( uint32_t );
+
+        std::vector< size_t > levelOffsets( levels.size( ) );
+        size_t                size = dfdOffset + dfdSize;
+        for ( size_t i = levels.size( ); i > 0; --i ) {
+            levelOffsets[ i - 1 ] = AlignOffset( size, levelAlignment );
+            size                  = levelOffsets[ i - 1 ] + levels[ i - 1 ].size( );
+        }
+
+        std::vector< uint8_t > ktx( size, 0 );
+        memcpy( ktx.data( ), kKtx2Identifier, sizeof( kKtx2Identifier ) );
+        Write< uint32_t >( ktx, 12, desc.vkFormat );
+        Write< uint32_t >( ktx, 16, 1 ); /* typeSize */
+        Write< uint32_t >( ktx, 20, baseLevel.width );
+        Write< uint32_t >( ktx, 24, baseLevel.height );
+        Write< uint32_t >( ktx, 28, 0 ); /* pixelDepth */
+        Write< uint32_t >( ktx, 32, 0 ); /* layerCount */
+        Write< uint32_t >( ktx, 36, 1 ); /* faceCount */
+        Write< uint32_t >( ktx, 40, uint32_t( levels.size( ) ) );
+        Write< uint32_t >( ktx, 44, 0 ); /* supercompressionScheme */
+        Write< uint32_t >( ktx, 48, uint32_t( dfdOffset ) );
+        Write< uint32_t >( ktx, 52, uint32_t( dfdSize ) );
+
+        for ( size_t i = 0; i < levels.size( ); ++i ) {
+            const size_t levelIndexOffset = kKtx2HeaderSize + kKtx2LevelIndexSize * i;
+            Write< uint64_t >( ktx, levelIndexOffset, levelOffsets[ i ] );
+            Write< uint64_t >( ktx, levelIndexOffset + 8, levels[ i ].size( ) );
+            Write< uint64_t >( ktx, levelIndexOffset + 16, levels[ i ].size( ) );
+            memcpy( ktx.data( ) + levelOffsets[ i ], levels[ i ].data( ), levels[ i ].size( ) );
+        }
+
+        memcpy( ktx.data( ) + dfdOffset, dfd.data( ), dfdSize );
+        return ktx;
+    }
+} // namespace
+
+bool IsTextureFormat( const std::string& textureFormat ) {
+    return textureFormat == "none" || textureFormat == "rgba8" || textureFormat == "bc1" || textureFormat == "bc3" ||
+           textureFormat == "bc7" || textureFormat == "auto";
+}
+
+/**
+ * Decodes the image, builds the mip chain and replaces the buffer with the KTX2 payload.
+ * Returns false with the error message if the image cannot be decoded (the buffer is kept as is then).
+ **/
+bool TranscodeTexture( const std::string&      textureFormat,
+                       apemode::ETextureUsage  usage,
+                       std::vector< uint8_t >& buffer,
+                       std::string&            errorMessage ) {
+    if ( buffer.size( ) > size_t( std::numeric_limits< int >::max( ) ) ) {
+        errorMessage = "too large";
+        return false;
+    }
+
+    int      width = 0, height = 0, channelCount = 0;
+    stbi_uc* pixels = stbi_load_from_memory( buffer.data( ), int( buffer.size( ) ), &width, &height, &channelCount, 4 );
+    if ( nullptr == pixels ) {
+        errorMessage = stbi_failure_reason( );
+        return false;
+    }
+
+    Image baseLevel;
+    baseLevel.width  = uint32_t( width );
+    baseLevel.height = uint32_t( height );
+    baseLevel.pixels.assign( pixels, pixels + size_t( width ) * size_t( height ) * 4 );
+    stbi_image_free( pixels );
+
+    apemodefb::ETextureFormatFb format;
+    if ( false == SelectTextureFormat( textureFormat, usage, baseLevel, format ) ) {
+        errorMessage = "unknown texture format " + textureFormat;
+        return false;
+    }
+
+    InitializeBlockEncoders( );
+
+    std::vector< std::vector< uint8_t > > levels;
+    levels.push_back( EncodeLevel( baseLevel, format, usage ) );
+
+    Image level = baseLevel;
+    while ( level.width > 1 || level.height > 1 ) {
+        level = Downsample( level, usage );
+        levels.push_back( EncodeLevel( level, format, usage ) );
+    }
+
+    buffer = WriteKtx2( baseLevel, format, levels );
+    return true;
+}
+
+/* Fills the texture info from the KTX2 header, returns false if the buffer is not KTX2 or the format is not known. */
+bool ReadKtx2TextureInfo( const uint8_t* buffer, size_t bufferSize, apemodefb::TextureInfoFb& textureInfo ) {
+    if ( bufferSize < kKtx2HeaderSize || memcmp( buffer, kKtx2Identifier, sizeof( kKtx2Identifier ) ) != 0 )
+        return false;
+
+    const uint32_t vkFormat   = Read< uint32_t >( buffer, 12 );
+    const uint32_t width      = Read< uint32_t >( buffer, 20 );
+    const uint32_t height     = Read< uint32_t >( buffer, 24 );
+    const uint32_t levelCount = Read< uint32_t >( buffer, 40 );
+
+    for ( int format = apemodefb::ETextureFormatFb_MIN; format <= apemodefb::ETextureFormatFb_MAX; ++format ) {
+        const auto textureFormat = static_cast< apemodefb::ETextureFormatFb >( format );
+        if ( GetTextureFormatDesc( textureFormat ).vkFormat == vkFormat ) {
+            textureInfo = apemodefb::TextureInfoFb( width, height, textureFormat, uint8_t( std::max( 1u, levelCount ) ) );
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Packs the channels of the images into the RGB channels of the PNG image (the missing channels and alpha are white).
+ * The images that provide a single channel have to be grayscale (roughness, metalness, occlusion maps),
+ * all the images have to be of the same size. Returns false with the error message otherwise.
+ **/
+bool PackTextureChannels( const std::vector< uint8_t >* const ( &images )[ 3 ],
+                          const uint32_t ( &imageChannels )[ 3 ],
+                          std::vector< uint8_t >& packedImage,
+                          std::string&            errorMessage ) {
+    Image decodedImages[ 3 ];
+    Image packed;
+
+    for ( uint32_t c = 0; c < 3; ++c ) {
+        if ( nullptr == images[ c ] )
+            continue;
+
+        /* The image shared by the channels is decoded once. */
+        uint32_t sharedChannel = 0;
+        while ( sharedChannel < c && images[ sharedChannel ] != images[ c ] )
+            ++sharedChannel;
+
+        if ( sharedChannel != c ) {
+            decodedImages[ c ] = decodedImages[ sharedChannel ];
+        } else {
+            int      width = 0, height = 0, channelCount = 0;
+            stbi_uc* pixels = stbi_load_from_memory( images[ c ]->data( ), int( images[ c ]->size( ) ), &width, &height, &channelCount, 4 );
+            if ( nullptr == pixels ) {
+                errorMessage = stbi_failure_reason( );
+                return false;
+            }
+
+            decodedImages[ c ].width  = uint32_t( width );
+            decodedImages[ c ].height = uint32_t( height );
+            decodedImages[ c ].pixels.assign( pixels, pixels + size_t( width ) * size_t( height ) * 4 );
+            stbi_image_free( pixels );
+        }
+
+        const Image& image = decodedImages[ c ];
+        if ( packed.pixels.empty( ) ) {
+            packed.width  = image.width;
+            packed.height = image.height;
+            packed.pixels.assign( size_t( packed.width ) * packed.height * 4, 255 );
+        } else if ( packed.width != image.width || packed.height != image.height ) {
+            errorMessage = "the images differ in size";
+            return false;
+        }
+
+        const bool singleChannel = std::count( std::begin( images ), std::end( images ), images[ c ] ) == 1;
+        for ( size_t i = 0; i < packed.pixels.size( ); i += 4 ) {
+            const uint8_t* pixel = &image.pixels[ i ];
+            if ( singleChannel && ( pixel[ 0 ] != pixel[ 1 ] || pixel[ 0 ] != pixel[ 2 ] ) ) {
+                errorMessage = "the image is not grayscale";
+                return false;
+            }
+
+            packed.pixels[ i + c ] = pixel[ imageChannels[ c ] ];
+        }
+    }
+
+    if ( packed.pixels.empty( ) ) {
+        errorMessage = "no images";
+        return false;
+    }
+
+    if ( false == EncodePng( packed, packedImage ) ) {
+        errorMessage = "failed to encode png";
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Packs the images into the atlases (shelf packing, the tallest images first) and encodes the atlases as PNG.
+ * Each tile is surrounded by the gutter of the repeated edge texels, and the tiles start at the block boundaries,
+ * so the block compression and the first mips of the atlas do not mix the neighbouring tiles.
+ * The images that cannot be decoded, exceed the maximum size or do not fit, and the atlases with a single tile are left unpacked.
+ **/
+void BuildTextureAtlases( const std::vector< const std::vector< uint8_t >* >& images,
+                          uint32_t                                            maxImageSize,
+                          uint32_t                                            atlasSize,
+                          uint32_t                                            gutter,
+                          std::vector< std::vector< uint8_t > >&              atlasImages,
+                          std::vector< apemode::TextureAtlasTile >&           tiles ) {
+    const auto alignToBlock = []( uint32_t value ) { return ( value + 3 ) / 4 * 4; };
+
+    std::vector< Image > decodedImages( images.size( ) );
+    std::vector< size_t > order;
+
+    for ( size_t i = 0; i < images.size( ); ++i ) {
+        int width = 0, height = 0, channelCount = 0;
+        if ( 0 == stbi_info_from_memory( images[ i ]->data( ), int( images[ i ]->size( ) ), &width, &height, &channelCount ) ||
+             uint32_t( width ) > maxImageSize || uint32_t( height ) > maxImageSize )
+            continue;
+
+        stbi_uc* pixels = stbi_load_from_memory( images[ i ]->data( ), int( images[ i ]->size( ) ), &width, &height, &channelCount, 4 );
+        if ( nullptr == pixels )
+            continue;
+
+        decodedImages[ i ].width  = uint32_t( width );
+        decodedImages[ i ].height = uint32_t( height );
+        decodedImages[ i ].pixels.assign( pixels, pixels + size_t( width ) * size_t( height ) * 4 );
+        stbi_image_free( pixels );
+        order.push_back( i );
+    }
+
+    std::stable_sort( order.begin( ), order.end( ), [&]( size_t a, size_t b ) {
+        return decodedImages[ a ].height > decodedImages[ b ].height;
+    } );
+
+    struct Atlas {
+        uint32_t              width       = 0;
+        uint32_t              height      = 0;
+        uint32_t              shelfX      = 0;
+        uint32_t              shelfY      = 0;
+        uint32_t              shelfHeight = 0;
+        std::vector< size_t > imageIndices;
+    };
+
+    std::vector< Atlas > atlases;
+    tiles.assign( images.size( ), apemode::TextureAtlasTile( ) );
+
+    for ( const size_t i : order ) {
+        const uint32_t slotWidth  = alignToBlock( decodedImages[ i ].width + gutter * 2 );
+        const uint32_t slotHeight = alignToBlock( decodedImages[ i ].height + gutter * 2 );
+        if ( slotWidth > atlasSize || slotHeight > atlasSize )
+            continue;
+
+        if ( false == atlases.empty( ) && atlases.back( ).shelfX + slotWidth > atlasSize ) {
+            atlases.back( ).shelfY += atlases.back( ).shelfHeight;
+            atlases.back( ).shelfX      = 0;
+            atlases.back( ).shelfHeight = 0;
+        }
+
+        if ( atlases.empty( ) || atlases.back( ).shelfY + slotHeight > atlasSize ) {
+            atlases.emplace_back( );
+        }
+
+        Atlas& atlas = atlases.back( );
+        tiles[ i ].atlasIndex = uint32_t( atlases.size( ) - 1 );
+        tiles[ i ].x          = atlas.shelfX + gutter;
+        tiles[ i ].y          = atlas.shelfY + gutter;
+        tiles[ i ].width      = decodedImages[ i ].width;
+        tiles[ i ].height     = decodedImages[ i ].height;
+
+        atlas.shelfX += slotWidth;
+        atlas.shelfHeight = std::max( atlas.shelfHeight, slotHeight );
+        atlas.width       = std::max( atlas.width, atlas.shelfX );
+        atlas.height      = std::max( atlas.height, atlas.shelfY + atlas.shelfHeight );
+        atlas.imageIndices.push_back( i );
+    }
+
+    atlasImages.clear( );
+    for ( auto& atlas : atlases ) {
+        if ( atlas.imageIndices.size( ) < 2 ) {
+            tiles[ atlas.imageIndices.front( ) ] = apemode::TextureAtlasTile( );
+            continue;
+        }
+
+        Image packed;
+        packed.width  = atlas.width;
+        packed.height = atlas.height;
+        packed.pixels.assign( size_t( packed.width ) * packed.height * 4, 0 );
+
+        for ( const size_t i : atlas.imageIndices ) {
+            const Image& image = decodedImages[ i ];
+            auto&        tile  = tiles[ i ];
+            tile.atlasIndex    = uint32_t( atlasImages.size( ) );
+            tile.atlasWidth    = packed.width;
+            tile.atlasHeight   = packed.height;
+
+            for ( uint32_t y = 0; y < image.height + gutter * 2; ++y ) {
+                const uint32_t srcY = std::min( std::max( y, gutter ) - gutter, image.height - 1 );
+                for ( uint32_t x = 0; x < image.width + gutter * 2; ++x ) {
+                    const uint32_t srcX = std::min( std::max( x, gutter ) - gutter, image.width - 1 );
+                    memcpy( &packed.pixels[ ( size_t( tile.y - gutter + y ) * packed.width + tile.x - gutter + x ) * 4 ],
+                            &image.pixels[ ( size_t( srcY ) * image.width + srcX ) * 4 ],
+                            4 );
+                }
+            }
+        }
+
+        std::vector< uint8_t > atlasImage;
+        if ( false == EncodePng( packed, atlasImage ) ) {
+            for ( const size_t i : atlas.imageIndices )
+                tiles[ i ] = apemode::TextureAtlasTile( );
+            continue;
+        }
+
+        atlasImages.push_back( std::move( atlasImage ) );
+    }
+}
@@ -72,15 +72,14 @@ void PopulateTransformLimits( FbxNode* pFbxNode, apemodefb::TransformLimitsFb& l
                              limits.mutable_scaling_min_active( ) );
 }
 
-void PopulateTransformLimits( FbxNode* pFbxNode, apemode::Node& n ) {
+void PopulateTransformLimits( apemode::State& s, FbxNode* pFbxNode, apemode::Node& n ) {
     if ( pFbxNode->TranslationMaxX.Get( ) || pFbxNode->TranslationMaxY.Get( ) || pFbxNode->TranslationMaxZ.Get( ) ||
          pFbxNode->TranslationMinX.Get( ) || pFbxNode->TranslationMinY.Get( ) || pFbxNode->TranslationMinZ.Get( ) ||
          pFbxNode->RotationMaxX.Get( ) || pFbxNode->RotationMaxY.Get( ) || pFbxNode->RotationMaxZ.Get( ) ||
          pFbxNode->RotationMinX.Get( ) || pFbxNode->RotationMinY.Get( ) || pFbxNode->RotationMinZ.Get( ) ||
          pFbxNode->ScalingMaxX.Get( ) || pFbxNode->ScalingMaxY.Get( ) || pFbxNode->ScalingMaxZ.Get( ) ||
          pFbxNode->ScalingMinX.Get( ) || pFbxNode->ScalingMinY.Get( ) || pFbxNode->ScalingMinZ.Get( ) ) {
-        auto& s = apemode::State::Get( );
-        s.console->info( "Node \"{}\" has transform limits.", pFbxNode->GetName( ) );
+        s.console->debug( "Node \"{}\" has transform limits.", pFbxNode->GetName( ) );
 
         const uint32_t transformLimitsId = static_cast< uint32_t >( s.transformLimits.size( ) );
         s.transformLimits.emplace_back( );
@@ -97,37 +96,33 @@ inline void LogIfNotEqual( const FbxVector4& v, const FbxVector4& compare, const
     s.console->warn( "{}: ({} {} {})", name, v[ 0 ], v[ 1 ], v[ 2 ] );
 }
 
-void PrintGlobalTransform( FbxNode * pFbxNode ) {
-    auto& s = apemode::State::Get( );
-    
+void PrintGlobalTransform( apemode::State& s, FbxNode * pFbxNode ) {
     auto globalTransform = pFbxNode->EvaluateGlobalTransform();
 
-    s.console->info( "\t globalTransform:" );
-    s.console->info( "\t {} {} {} {}",
-                     (float) globalTransform.Get( 0, 0 ),
-                     (float) globalTransform.Get( 0, 1 ),
-                     (float) globalTransform.Get( 0, 2 ),
-                     (float) globalTransform.Get( 0, 3 ) );
-    s.console->info( "\t {} {} {} {}",
-                     (float) globalTransform.Get( 1, 0 ),
-                     (float) globalTransform.Get( 1, 1 ),
-                     (float) globalTransform.Get( 1, 2 ),
-                     (float) globalTransform.Get( 1, 3 ) );
-    s.console->info( "\t {} {} {} {}",
-                     (float) globalTransform.Get( 2, 0 ),
-                     (float) globalTransform.Get( 2, 1 ),
-                     (float) globalTransform.Get( 2, 2 ),
-                     (float) globalTransform.Get( 2, 3 ) );
-    s.console->info( "\t {} {} {} {}",
-                     (float) globalTransform.Get( 3, 0 ),
-                     (float) globalTransform.Get( 3, 1 ),
-                     (float) globalTransform.Get( 3, 2 ),
-                     (float) globalTransform.Get( 3, 3 ) );
+    s.console->debug( "\t globalTransform:" );
+    s.console->debug( "\t {} {} {} {}",
+                      (float) globalTransform.Get( 0, 0 ),
+                      (float) globalTransform.Get( 0, 1 ),
+                      (float) globalTransform.Get( 0, 2 ),
+                      (float) globalTransform.Get( 0, 3 ) );
+    s.console->debug( "\t {} {} {} {}",
+                      (float) globalTransform.Get( 1, 0 ),
+                      (float) globalTransform.Get( 1, 1 ),
+                      (float) globalTransform.Get( 1, 2 ),
+                      (float) globalTransform.Get( 1, 3 ) );
+    s.console->debug( "\t {} {} {} {}",
+                      (float) globalTransform.Get( 2, 0 ),
+                      (float) globalTransform.Get( 2, 1 ),
+                      (float) globalTransform.Get( 2, 2 ),
+                      (float) globalTransform.Get( 2, 3 ) );
+    s.console->debug( "\t {} {} {} {}",
+                      (float) globalTransform.Get( 3, 0 ),
+                      (float) globalTransform.Get( 3, 1 ),
+                      (float) globalTransform.Get( 3, 2 ),
+                      (float) globalTransform.Get( 3, 3 ) );
 }
 
-void ExportTransform( FbxNode* pFbxNode, apemode::Node& n ) {
-    auto& s = apemode::State::Get( );
-
+void ExportTransform( apemode::State& s, FbxNode* pFbxNode, apemode::Node& n ) {
     const FbxVector4 kFbxZero( 0.0, 0.0, 0.0, 0.0 );
     const FbxVector4 kFbxOne( 1.0, 1.0, 1.0, 1.0 );
 
@@ -145,7 +140,7 @@ void ExportTransform( FbxNode* pFbxNode, apemode::Node& n ) {
     LOG_IF_NOT_EQUAL_OFFSET_PROPERTY( GeometricRotation, kFbxZero );
 #undef LOG_IF_NOT_EQUAL_OFFSET_PROPERTY
 
-    PrintGlobalTransform(pFbxNode);
+    PrintGlobalTransform( s, pFbxNode );
 
     s.transforms.emplace_back( Cast( pFbxNode->LclTranslation.Get( ) ),
                                Cast( pFbxNode->GetRotationOffset( FbxNode::eSourcePivot ) ),
@@ -160,5 +155,5 @@ void ExportTransform( FbxNode* pFbxNode, apemode::Node& n ) {
                                Cast( pFbxNode->GetGeometricRotation( FbxNode::eSourcePivot ) ),
                                Cast( pFbxNode->GetGeometricScaling( FbxNode::eSourcePivot ) ) );
 
-    PopulateTransformLimits( pFbxNode, n );
+    PopulateTransformLimits( s, pFbxNode, n );
 }
@@ -0,0 +1,140 @@
+#include <fbxppch.h>
+#include <fbxpwatch.h>
+
+#include <set>
+#include <sys/stat.h>
+
+#if defined( __linux__ )
+#include <errno.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+bool        FileExists( const char* filePath );
+std::string ResolveFullPath( const char* path );
+std::string ReplaceSlashes( std::string path );
+void        SplitFilename( const std::string& filePath, std::string* parentFolderName, std::string* fileName );
+
+namespace {
+    int64_t GetWriteTime( const std::string& filePath ) {
+        struct stat fileStat;
+        if ( 0 == stat( filePath.c_str( ), &fileStat ) )
+            return static_cast< int64_t >( fileStat.st_mtime );
+
+        return -1;
+    }
+} // namespace
+
+apemode::FileWatcher::~FileWatcher( ) {
+    Close( );
+}
+
+void apemode::FileWatcher::Close( ) {
+#if defined( __linux__ )
+    if ( inotifyFd >= 0 ) {
+        close( inotifyFd );
+        inotifyFd = -1;
+    }
+#endif
+
+    directories.clear( );
+    writeTimes.clear( );
+    filePaths.clear( );
+}
+
+void apemode::FileWatcher::Watch( const std::vector< std::string >& watchedFilePaths ) {
+    Close( );
+
+    for ( auto& watchedFilePath : watchedFilePaths ) {
+        if ( false == watchedFilePath.empty( ) && FileExists( watchedFilePath.c_str( ) ) ) {
+            const std::string filePath = ReplaceSlashes( ResolveFullPath( watchedFilePath.c_str( ) ) );
+            if ( std::find( filePaths.begin( ), filePaths.end( ), filePath ) == filePaths.end( ) )
+                filePaths.push_back( filePath );
+        }
+    }
+
+#if defined( __linux__ )
+    inotifyFd = inotify_init1( IN_CLOEXEC );
+    if ( inotifyFd < 0 )
+        return;
+
+    std::set< std::string > watchedDirectories;
+    for ( auto& filePath : filePaths ) {
+        std::string directory;
+        SplitFilename( filePath, &directory, nullptr );
+        while ( directory.size( ) > 1 && directory.back( ) == '/' )
+            directory.pop_back( );
+
+        if ( watchedDirectories.insert( directory ).second ) {
+            const int watchDescriptor = inotify_add_watch( inotifyFd, directory.c_str( ), IN_CLOSE_WRITE | IN_MOVED_TO );
+            if ( watchDescriptor >= 0 )
+                directories[ watchDescriptor ] = directory;
+        }
+    }
+#else
+    for ( auto& filePath : filePaths )
+        writeTimes[ filePath ] = GetWriteTime( filePath );
+#endif
+}
+
+bool apemode::FileWatcher::Wait( std::vector< std::string >& changedFilePaths, uint32_t delayMilliseconds ) {
+    changedFilePaths.clear( );
+    if ( filePaths.empty( ) )
+        return false;
+
+    std::set< std::string > changedFiles;
+
+#if defined( __linux__ )
+    if ( inotifyFd < 0 || directories.empty( ) )
+        return false;
+
+    /* Waits for the first change infinitely, then until there are no changes within the delay. */
+    int timeout = -1;
+    alignas( inotify_event ) char eventBuffer[ 4096 ];
+
+    for ( ;; ) {
+        pollfd pollFd = {inotifyFd, POLLIN, 0};
+        const int readyCount = poll( &pollFd, 1, timeout );
+        if ( readyCount < 0 && errno == EINTR )
+            continue;
+        if ( readyCount <= 0 )
+            break;
+
+        const ssize_t eventBufferSize = read( inotifyFd, eventBuffer, sizeof( eventBuffer ) );
+        if ( eventBufferSize <= 0 )
+            break;
+
+        for ( const char* eventIt = eventBuffer; eventIt < eventBuffer + eventBufferSize; ) {
+            const inotify_event* event = reinterpret_cast< const inotify_event* >( eventIt );
+            eventIt += sizeof( inotify_event ) + event->len;
+
+            const auto directoryIt = directories.find( event->wd );
+            if ( event->len == 0 || directoryIt == directories.end( ) )
+                continue;
+
+            const std::string filePath = directoryIt->second + "/" + event->name;
+            if ( std::find( filePaths.begin( ), filePaths.end( ), filePath ) != filePaths.end( ) )
+                changedFiles.insert( filePath );
+        }
+
+        if ( false == changedFiles.empty( ) )
+            timeout = int( delayMilliseconds );
+    }
+#else
+    while ( changedFiles.empty( ) ) {
+        std::this_thread::sleep_for( std::chrono::milliseconds( delayMilliseconds ) );
+
+        for ( auto& filePath : filePaths ) {
+            const int64_t writeTime = GetWriteTime( filePath );
+            if ( writeTime != writeTimes[ filePath ] ) {
+                writeTimes[ filePath ] = writeTime;
+                changedFiles.insert( filePath );
+            }
+        }
+    }
+#endif
+
+    changedFilePaths.assign( changedFiles.begin( ), changedFiles.end( ) );
+    return false == changedFilePaths.empty( );
+}
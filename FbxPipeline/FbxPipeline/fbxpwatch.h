@@ -0,0 +1,35 @@
+#pragma once
+#include <fbxppch.h>
+#include <map>
+
+/**
+ * Watches the input files for changes (--watch argument).
+ * On Linux the parent directories are watched with inotify, editors and exporters
+ * usually write a temporary file and rename it over the original one.
+ * On the other platforms the modification times are polled.
+ **/
+
+namespace apemode {
+
+    struct FBXPIPELINE_API FileWatcher {
+        std::vector< std::string >       filePaths;
+        std::map< std::string, int64_t > writeTimes;
+        std::map< int, std::string >     directories;
+        int                              inotifyFd = -1;
+
+        ~FileWatcher( );
+
+        /* Replaces the watched files, the missing files are skipped. */
+        void Watch( const std::vector< std::string >& watchedFilePaths );
+
+        /**
+         * Blocks until some of the watched files change.
+         * The changes that follow within the delay are merged (the files are often written in several steps).
+         * Returns false if the files cannot be watched.
+         **/
+        bool Wait( std::vector< std::string >& changedFilePaths, uint32_t delayMilliseconds = 250 );
+
+        void Close( );
+    };
+
+} // namespace apemode
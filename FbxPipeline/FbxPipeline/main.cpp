@@ -1,26 +1,240 @@
 #include <fbxppch.h>
 #include <fbxpstate.h>
+#include <fbxpwatch.h>
 
-void ExportScene( FbxScene* pScene );
+#include <atomic>
+#include <fstream>
+
+void ExportScene( apemode::State& s, FbxScene* pScene );
 void ConvertScene( FbxManager* lSdkManager, FbxScene* lScene, FbxString lFilePath );
 
+/**
+ * Reads the input files for the batch mode, one per line.
+ * Empty lines and lines that start with '#' are skipped.
+ **/
+bool ReadBatchFile( const std::string& batchFile, std::vector< std::string >& inputFiles ) {
+    std::ifstream batchStream( batchFile );
+    if ( false == batchStream.good( ) )
+        return false;
+
+    std::string line;
+    while ( std::getline( batchStream, line ) ) {
+        const size_t first = line.find_first_not_of( " \t\r" );
+        const size_t last  = line.find_last_not_of( " \t\r" );
+        if ( first == std::string::npos || line[ first ] == '#' )
+            continue;
+
+        inputFiles.push_back( line.substr( first, last - first + 1 ) );
+    }
+
+    return true;
+}
+
+/**
+ * The inputs shared by the workers, each worker takes the next input until the queue is empty.
+ **/
+struct AssetQueue {
+    std::vector< std::string > inputFiles;
+    std::string                outputDirectory;
+    std::string                reportDirectory;
+    bool                       batch   = false;
+    bool                       convert = false;
+    std::atomic< size_t >      nextInput{0};
+    std::atomic< size_t >      succeededCount{0};
+};
+
+/**
+ * Converts the assets from the queue with the initialized state.
+ * The manager, IO settings, file prefetcher threads and python extensions are reused.
+ **/
+void ConvertAssets( apemode::State& s, AssetQueue& queue ) {
+    size_t assetCount = 0;
+    for ( size_t i = queue.nextInput++; i < queue.inputFiles.size( ); i = queue.nextInput++ ) {
+        if ( assetCount++ > 0 )
+            s.Reset( );
+
+        s.SetInputFile( queue.inputFiles[ i ] );
+
+        if ( queue.batch )
+            s.console->info( "Batch: [{}/{}] {}", i + 1, queue.inputFiles.size( ), s.inputFile );
+
+        /* Empty output file means the output is written next to the input. */
+        if ( false == queue.outputDirectory.empty( ) )
+            s.outputFile = queue.outputDirectory + "/" + s.fileName + "." + apemodefb::SceneFbExtension( );
+
+        bool succeeded = false;
+        if ( queue.convert ) {
+            if ( s.Load( ) ) {
+                ConvertScene( s.manager, s.scene, s.inputFile.c_str( ) );
+                succeeded = true;
+            }
+        } else {
+            /* Unchanged assets are not even loaded. */
+            if ( s.cache.RestoreAsset( s ) ) {
+                succeeded = true;
+            } else if ( s.Load( ) ) {
+                ExportScene( s, s.scene );
+                succeeded = s.Finalize( );
+
+                if ( succeeded )
+                    s.cache.StoreAsset( s );
+            }
+
+            if ( false == queue.reportDirectory.empty( ) )
+                s.report.Save( queue.reportDirectory + "/" + s.fileName + ".json" );
+        }
+
+        if ( succeeded )
+            ++queue.succeededCount;
+        else
+            s.console->error( "Failed to convert {}", s.inputFile );
+    }
+}
+
+/**
+ * Exports the asset again when the input, the embedded files or the scripts change.
+ * The manager, the python interpreter and the search location index stay resident
+ * (the directories with added, removed or renamed files are indexed again),
+ * the Draco encoding results of the unchanged meshes are reused from memory.
+ **/
+void WatchAsset( apemode::State& s, AssetQueue& queue ) {
+    apemode::FileWatcher watcher;
+
+    for ( ;; ) {
+        if ( s.options[ "report" ].count( ) > 0 )
+            s.report.Save( s.options[ "report" ].as< std::string >( ) );
+
+        std::vector< std::string > watchedFiles;
+        watchedFiles.push_back( s.inputFile );
+
+        /* The embedded files are not collected when the output is restored from the cache, its dependencies are watched instead. */
+        for ( auto& embeddedFile : s.embeddedFiles )
+            watchedFiles.push_back( embeddedFile.fullPath );
+        for ( auto& restoredDependency : s.cache.restoredDependencies )
+            watchedFiles.push_back( restoredDependency );
+
+        for ( const char* optionName : {"script-file", "script-input"} ) {
+            if ( s.options[ optionName ].count( ) > 0 )
+                for ( auto& scriptFile : s.options[ optionName ].as< std::vector< std::string > >( ) )
+                    watchedFiles.push_back( scriptFile );
+        }
+
+        watcher.Watch( watchedFiles );
+        s.console->info( "Watch: Waiting for changes ({} files) ...", watcher.filePaths.size( ) );
+        s.console->flush( );
+
+        std::vector< std::string > changedFiles;
+        if ( false == watcher.Wait( changedFiles ) ) {
+            s.console->error( "Watch: Failed to watch the files of {}", s.inputFile );
+            return;
+        }
+
+        for ( auto& changedFile : changedFiles )
+            s.console->info( "Watch: Changed {}", changedFile );
+
+        /* The scripts are cheap to execute compared to the export, they are reloaded on any change. */
+        if ( s.options[ "script-file" ].count( ) > 0 )
+            s.ReloadScripts( );
+
+        s.Reset( );
+        queue.nextInput      = 0;
+        queue.succeededCount = 0;
+        ConvertAssets( s, queue );
+        s.cache.TrimResidentStages( );
+    }
+}
+
 int main( int argc, char** argv ) {
 
     auto& s = apemode::State::Main( argc, (const char**&) argv );
-    bool convert = s.options[ "k" ].as< bool >( );
-
-    if ( s.Initialize( ) ) {
-        if ( s.Load( ) ) {
-            if ( convert )
-                ConvertScene( s.manager, s.scene, s.options[ "i" ].as< std::string >( ).c_str( ) );
-            else {
-                ExportScene( s.scene );
-                s.Finalize( );
-            }
+
+    AssetQueue queue;
+    queue.convert = s.options[ "k" ].as< bool >( );
+
+    /* In the batch mode -o and --report are the directories, the file names are taken from the inputs. */
+    queue.batch = s.options[ "batch" ].count( ) > 0;
+    if ( queue.batch ) {
+        if ( false == ReadBatchFile( s.options[ "batch" ].as< std::string >( ), queue.inputFiles ) ) {
+            s.console->error( "Failed to read batch file {}", s.options[ "batch" ].as< std::string >( ) );
+            return 1;
         }
+
+        queue.outputDirectory = s.outputFile;
+        if ( s.options[ "report" ].count( ) > 0 )
+            queue.reportDirectory = s.options[ "report" ].as< std::string >( );
+    } else {
+        queue.inputFiles.push_back( s.inputFile );
+    }
+
+    const bool watch = s.options[ "watch" ].count( ) > 0 && s.options[ "watch" ].as< bool >( );
+    if ( watch && ( queue.batch || queue.convert ) ) {
+        s.console->error( "The watch mode exports a single input, it cannot be combined with --batch or --convert" );
+        return 1;
+    }
+
+    /* The meshes that did not change between the exports are not encoded again. */
+    s.cache.resident = watch;
+
+    size_t jobCount = 1;
+    if ( s.options[ "jobs" ].count( ) > 0 )
+        jobCount = size_t( std::max( 1, s.options[ "jobs" ].as< int >( ) ) );
+    jobCount = std::min( jobCount, queue.inputFiles.size( ) );
+
+    if ( jobCount > 1 && s.options[ "script-file" ].count( ) > 0 ) {
+        /* There is a single embedded interpreter, the extensions cannot run concurrently. */
+        s.console->warn( "Python extensions are not thread-safe, ignoring --jobs" );
+        jobCount = 1;
     }
 
-    return 0;
+    if ( jobCount > 1 ) {
+        s.console->info( "Batch: {} inputs, {} jobs", queue.inputFiles.size( ), jobCount );
+
+        /* Each worker owns its manager, scene and exported data, only the options and the logger are shared. */
+        std::mutex                 initializeMutex;
+        std::vector< std::thread > workers;
+        workers.reserve( jobCount );
+
+        for ( size_t j = 0; j < jobCount; ++j ) {
+            workers.emplace_back( [&] {
+                apemode::State workerState;
+                workerState.InheritSettings( s );
+                apemode::State::CurrentScope currentScope( workerState );
+
+                /* Manager creation and plugin loading are not thread-safe. */
+                std::unique_lock< std::mutex > initializeLock( initializeMutex );
+                const bool initialized = workerState.Initialize( );
+                initializeLock.unlock( );
+
+                if ( initialized )
+                    ConvertAssets( workerState, queue );
+
+                workerState.Release( );
+            } );
+        }
+
+        for ( auto& worker : workers )
+            worker.join( );
+
+    } else if ( s.Initialize( ) ) {
+        ConvertAssets( s, queue );
+
+        if ( watch )
+            WatchAsset( s, queue );
+    }
+
+    /* The inputs left in the queue (failed initialization) are counted as failed too. */
+    const size_t failedCount = queue.inputFiles.size( ) - queue.succeededCount;
+    if ( queue.batch )
+        s.summary->info( "Batch: {} succeeded, {} failed", queue.succeededCount.load( ), failedCount );
+
+    if ( s.options[ "trace" ].count( ) > 0 )
+        s.profiler.Save( s.options[ "trace" ].as< std::string >( ) );
+
+    if ( s.options[ "report" ].count( ) > 0 && !queue.convert && !queue.batch )
+        s.report.Save( s.options[ "report" ].as< std::string >( ) );
+
+    s.Release( );
+    return failedCount ? 1 : 0;
 }
 
 /*
@@ -96,7 +96,29 @@ class AnimCurveFb(object):
             return self._tab.Get(flatbuffers.number_types.Uint8Flags, o + self._tab.Pos)
         return 0
 
-def AnimCurveFbStart(builder): builder.StartObject(9)
+    # AnimCurveFb
+    def KeysBlob(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(22))
+        if o != 0:
+            x = o + self._tab.Pos
+            from .BlobRefFb import BlobRefFb
+            obj = BlobRefFb()
+            obj.Init(self._tab.Bytes, x)
+            return obj
+        return None
+
+    # AnimCurveFb
+    def KeysCompression(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(24))
+        if o != 0:
+            x = o + self._tab.Pos
+            from .BlockCompressionFb import BlockCompressionFb
+            obj = BlockCompressionFb()
+            obj.Init(self._tab.Bytes, x)
+            return obj
+        return None
+
+def AnimCurveFbStart(builder): builder.StartObject(11)
 def AnimCurveFbAddId(builder, id): builder.PrependUint32Slot(0, id, 0)
 def AnimCurveFbAddNameId(builder, nameId): builder.PrependUint32Slot(1, nameId, 0)
 def AnimCurveFbAddAnimStackId(builder, animStackId): builder.PrependUint32Slot(2, animStackId, 0)
@@ -107,4 +129,6 @@ def AnimCurveFbAddKeys(builder, keys): builder.PrependUOffsetTRelativeSlot(6, fl
 def AnimCurveFbStartKeysVector(builder, numElems): return builder.StartVector(1, numElems, 1)
 def AnimCurveFbAddKeyType(builder, keyType): builder.PrependUint8Slot(7, keyType, 0)
 def AnimCurveFbAddCompressionType(builder, compressionType): builder.PrependUint8Slot(8, compressionType, 0)
+def AnimCurveFbAddKeysBlob(builder, keysBlob): builder.PrependStructSlot(9, flatbuffers.number_types.UOffsetTFlags.py_type(keysBlob), 0)
+def AnimCurveFbAddKeysCompression(builder, keysCompression): builder.PrependStructSlot(10, flatbuffers.number_types.UOffsetTFlags.py_type(keysCompression), 0)
 def AnimCurveFbEnd(builder): return builder.EndObject()
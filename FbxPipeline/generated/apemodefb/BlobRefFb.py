@@ -0,0 +1,26 @@
+# automatically generated by the FlatBuffers compiler, do not modify
+
+# namespace: apemodefb
+
+import flatbuffers
+
+class BlobRefFb(object):
+    __slots__ = ['_tab']
+
+    # BlobRefFb
+    def Init(self, buf, pos):
+        self._tab = flatbuffers.table.Table(buf, pos)
+
+    # BlobRefFb
+    def BlobFileId(self): return self._tab.Get(flatbuffers.number_types.Uint32Flags, self._tab.Pos + flatbuffers.number_types.UOffsetTFlags.py_type(0))
+    # BlobRefFb
+    def Size(self): return self._tab.Get(flatbuffers.number_types.Uint32Flags, self._tab.Pos + flatbuffers.number_types.UOffsetTFlags.py_type(4))
+    # BlobRefFb
+    def Offset(self): return self._tab.Get(flatbuffers.number_types.Uint64Flags, self._tab.Pos + flatbuffers.number_types.UOffsetTFlags.py_type(8))
+
+def CreateBlobRefFb(builder, blobFileId, size, offset):
+    builder.Prep(8, 16)
+    builder.PrependUint64(offset)
+    builder.PrependUint32(size)
+    builder.PrependUint32(blobFileId)
+    return builder.Offset()
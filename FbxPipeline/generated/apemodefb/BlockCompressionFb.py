@@ -0,0 +1,27 @@
+# automatically generated by the FlatBuffers compiler, do not modify
+
+# namespace: apemodefb
+
+import flatbuffers
+
+class BlockCompressionFb(object):
+    __slots__ = ['_tab']
+
+    # BlockCompressionFb
+    def Init(self, buf, pos):
+        self._tab = flatbuffers.table.Table(buf, pos)
+
+    # BlockCompressionFb
+    def CompressionType(self): return self._tab.Get(flatbuffers.number_types.Uint8Flags, self._tab.Pos + flatbuffers.number_types.UOffsetTFlags.py_type(0))
+    # BlockCompressionFb
+    def Level(self): return self._tab.Get(flatbuffers.number_types.Int8Flags, self._tab.Pos + flatbuffers.number_types.UOffsetTFlags.py_type(1))
+    # BlockCompressionFb
+    def UncompressedSize(self): return self._tab.Get(flatbuffers.number_types.Uint32Flags, self._tab.Pos + flatbuffers.number_types.UOffsetTFlags.py_type(4))
+
+def CreateBlockCompressionFb(builder, compressionType, level, uncompressedSize):
+    builder.Prep(4, 8)
+    builder.PrependUint32(uncompressedSize)
+    builder.Pad(2)
+    builder.PrependInt8(level)
+    builder.PrependUint8(compressionType)
+    return builder.Offset()
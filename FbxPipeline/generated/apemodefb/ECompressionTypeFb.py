@@ -5,4 +5,7 @@
 class ECompressionTypeFb(object):
     None = 0
     GoogleDraco3D = 1
+    Zstd = 2
+    LZ4 = 3
+    Meshopt = 4
 
@@ -0,0 +1,15 @@
+# automatically generated by the FlatBuffers compiler, do not modify
+
+# namespace: apemodefb
+
+class ETextureFormatFb(object):
+    RGBA8 = 0
+    RGBA8_sRGB = 1
+    BC1 = 2
+    BC1_sRGB = 3
+    BC3 = 4
+    BC3_sRGB = 5
+    BC5 = 6
+    BC7 = 7
+    BC7_sRGB = 8
+
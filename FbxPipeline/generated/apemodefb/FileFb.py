@@ -54,9 +54,45 @@ class FileFb(object):
             return self._tab.VectorLen(o)
         return 0
 
-def FileFbStart(builder): builder.StartObject(3)
+    # FileFb
+    def BufferBlob(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(10))
+        if o != 0:
+            x = o + self._tab.Pos
+            from .BlobRefFb import BlobRefFb
+            obj = BlobRefFb()
+            obj.Init(self._tab.Bytes, x)
+            return obj
+        return None
+
+    # FileFb
+    def BufferCompression(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(12))
+        if o != 0:
+            x = o + self._tab.Pos
+            from .BlockCompressionFb import BlockCompressionFb
+            obj = BlockCompressionFb()
+            obj.Init(self._tab.Bytes, x)
+            return obj
+        return None
+
+    # FileFb
+    def TextureInfo(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(14))
+        if o != 0:
+            x = o + self._tab.Pos
+            from .TextureInfoFb import TextureInfoFb
+            obj = TextureInfoFb()
+            obj.Init(self._tab.Bytes, x)
+            return obj
+        return None
+
+def FileFbStart(builder): builder.StartObject(6)
 def FileFbAddId(builder, id): builder.PrependUint32Slot(0, id, 0)
 def FileFbAddNameId(builder, nameId): builder.PrependUint32Slot(1, nameId, 0)
 def FileFbAddBuffer(builder, buffer): builder.PrependUOffsetTRelativeSlot(2, flatbuffers.number_types.UOffsetTFlags.py_type(buffer), 0)
 def FileFbStartBufferVector(builder, numElems): return builder.StartVector(1, numElems, 1)
+def FileFbAddBufferBlob(builder, bufferBlob): builder.PrependStructSlot(3, flatbuffers.number_types.UOffsetTFlags.py_type(bufferBlob), 0)
+def FileFbAddBufferCompression(builder, bufferCompression): builder.PrependStructSlot(4, flatbuffers.number_types.UOffsetTFlags.py_type(bufferCompression), 0)
+def FileFbAddTextureInfo(builder, textureInfo): builder.PrependStructSlot(5, flatbuffers.number_types.UOffsetTFlags.py_type(textureInfo), 0)
 def FileFbEnd(builder): return builder.EndObject()
@@ -114,7 +114,51 @@ class MeshFb(object):
             return self._tab.Get(flatbuffers.number_types.Uint32Flags, o + self._tab.Pos)
         return 0
 
-def MeshFbStart(builder): builder.StartObject(6)
+    # MeshFb
+    def VerticesBlob(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(16))
+        if o != 0:
+            x = o + self._tab.Pos
+            from .BlobRefFb import BlobRefFb
+            obj = BlobRefFb()
+            obj.Init(self._tab.Bytes, x)
+            return obj
+        return None
+
+    # MeshFb
+    def IndicesBlob(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(18))
+        if o != 0:
+            x = o + self._tab.Pos
+            from .BlobRefFb import BlobRefFb
+            obj = BlobRefFb()
+            obj.Init(self._tab.Bytes, x)
+            return obj
+        return None
+
+    # MeshFb
+    def VerticesCompression(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(20))
+        if o != 0:
+            x = o + self._tab.Pos
+            from .BlockCompressionFb import BlockCompressionFb
+            obj = BlockCompressionFb()
+            obj.Init(self._tab.Bytes, x)
+            return obj
+        return None
+
+    # MeshFb
+    def IndicesCompression(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(22))
+        if o != 0:
+            x = o + self._tab.Pos
+            from .BlockCompressionFb import BlockCompressionFb
+            obj = BlockCompressionFb()
+            obj.Init(self._tab.Bytes, x)
+            return obj
+        return None
+
+def MeshFbStart(builder): builder.StartObject(10)
 def MeshFbAddVertices(builder, vertices): builder.PrependUOffsetTRelativeSlot(0, flatbuffers.number_types.UOffsetTFlags.py_type(vertices), 0)
 def MeshFbStartVerticesVector(builder, numElems): return builder.StartVector(1, numElems, 1)
 def MeshFbAddSubmeshes(builder, submeshes): builder.PrependUOffsetTRelativeSlot(1, flatbuffers.number_types.UOffsetTFlags.py_type(submeshes), 0)
@@ -125,4 +169,8 @@ def MeshFbAddIndices(builder, indices): builder.PrependUOffsetTRelativeSlot(3, f
 def MeshFbStartIndicesVector(builder, numElems): return builder.StartVector(1, numElems, 1)
 def MeshFbAddIndexType(builder, indexType): builder.PrependUint8Slot(4, indexType, 0)
 def MeshFbAddSkinId(builder, skinId): builder.PrependUint32Slot(5, skinId, 0)
+def MeshFbAddVerticesBlob(builder, verticesBlob): builder.PrependStructSlot(6, flatbuffers.number_types.UOffsetTFlags.py_type(verticesBlob), 0)
+def MeshFbAddIndicesBlob(builder, indicesBlob): builder.PrependStructSlot(7, flatbuffers.number_types.UOffsetTFlags.py_type(indicesBlob), 0)
+def MeshFbAddVerticesCompression(builder, verticesCompression): builder.PrependStructSlot(8, flatbuffers.number_types.UOffsetTFlags.py_type(verticesCompression), 0)
+def MeshFbAddIndicesCompression(builder, indicesCompression): builder.PrependStructSlot(9, flatbuffers.number_types.UOffsetTFlags.py_type(indicesCompression), 0)
 def MeshFbEnd(builder): return builder.EndObject()
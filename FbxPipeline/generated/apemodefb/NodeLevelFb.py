@@ -0,0 +1,23 @@
+# automatically generated by the FlatBuffers compiler, do not modify
+
+# namespace: apemodefb
+
+import flatbuffers
+
+class NodeLevelFb(object):
+    __slots__ = ['_tab']
+
+    # NodeLevelFb
+    def Init(self, buf, pos):
+        self._tab = flatbuffers.table.Table(buf, pos)
+
+    # NodeLevelFb
+    def FirstIndex(self): return self._tab.Get(flatbuffers.number_types.Uint32Flags, self._tab.Pos + flatbuffers.number_types.UOffsetTFlags.py_type(0))
+    # NodeLevelFb
+    def Count(self): return self._tab.Get(flatbuffers.number_types.Uint32Flags, self._tab.Pos + flatbuffers.number_types.UOffsetTFlags.py_type(4))
+
+def CreateNodeLevelFb(builder, firstIndex, count):
+    builder.Prep(4, 8)
+    builder.PrependUint32(count)
+    builder.PrependUint32(firstIndex)
+    return builder.Offset()
@@ -0,0 +1,23 @@
+# automatically generated by the FlatBuffers compiler, do not modify
+
+# namespace: apemodefb
+
+import flatbuffers
+
+class NodeOrderFb(object):
+    __slots__ = ['_tab']
+
+    # NodeOrderFb
+    def Init(self, buf, pos):
+        self._tab = flatbuffers.table.Table(buf, pos)
+
+    # NodeOrderFb
+    def NodeId(self): return self._tab.Get(flatbuffers.number_types.Uint32Flags, self._tab.Pos + flatbuffers.number_types.UOffsetTFlags.py_type(0))
+    # NodeOrderFb
+    def ParentIndex(self): return self._tab.Get(flatbuffers.number_types.Uint32Flags, self._tab.Pos + flatbuffers.number_types.UOffsetTFlags.py_type(4))
+
+def CreateNodeOrderFb(builder, nodeId, parentIndex):
+    builder.Prep(4, 8)
+    builder.PrependUint32(parentIndex)
+    builder.PrependUint32(nodeId)
+    return builder.Offset()
@@ -381,7 +381,60 @@ class SceneFb(object):
             return self._tab.VectorLen(o)
         return 0
 
-def SceneFbStart(builder): builder.StartObject(20)
+    # SceneFb
+    def BlobFiles(self, j):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(44))
+        if o != 0:
+            a = self._tab.Vector(o)
+            return self._tab.String(a + flatbuffers.number_types.UOffsetTFlags.py_type(j * 4))
+        return ""
+
+    # SceneFb
+    def BlobFilesLength(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(44))
+        if o != 0:
+            return self._tab.VectorLen(o)
+        return 0
+
+    # SceneFb
+    def NodeOrder(self, j):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(46))
+        if o != 0:
+            x = self._tab.Vector(o)
+            x += flatbuffers.number_types.UOffsetTFlags.py_type(j) * 8
+            from .NodeOrderFb import NodeOrderFb
+            obj = NodeOrderFb()
+            obj.Init(self._tab.Bytes, x)
+            return obj
+        return None
+
+    # SceneFb
+    def NodeOrderLength(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(46))
+        if o != 0:
+            return self._tab.VectorLen(o)
+        return 0
+
+    # SceneFb
+    def NodeLevels(self, j):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(48))
+        if o != 0:
+            x = self._tab.Vector(o)
+            x += flatbuffers.number_types.UOffsetTFlags.py_type(j) * 8
+            from .NodeLevelFb import NodeLevelFb
+            obj = NodeLevelFb()
+            obj.Init(self._tab.Bytes, x)
+            return obj
+        return None
+
+    # SceneFb
+    def NodeLevelsLength(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(48))
+        if o != 0:
+            return self._tab.VectorLen(o)
+        return 0
+
+def SceneFbStart(builder): builder.StartObject(23)
 def SceneFbAddVersion(builder, version): builder.PrependUint8Slot(0, version, 0)
 def SceneFbAddBboxMin(builder, bboxMin): builder.PrependStructSlot(1, flatbuffers.number_types.UOffsetTFlags.py_type(bboxMin), 0)
 def SceneFbAddBboxMax(builder, bboxMax): builder.PrependStructSlot(2, flatbuffers.number_types.UOffsetTFlags.py_type(bboxMax), 0)
@@ -419,4 +472,10 @@ def SceneFbAddFloatValues(builder, floatValues): builder.PrependUOffsetTRelative
 def SceneFbStartFloatValuesVector(builder, numElems): return builder.StartVector(4, numElems, 4)
 def SceneFbAddStringValues(builder, stringValues): builder.PrependUOffsetTRelativeSlot(19, flatbuffers.number_types.UOffsetTFlags.py_type(stringValues), 0)
 def SceneFbStartStringValuesVector(builder, numElems): return builder.StartVector(4, numElems, 4)
+def SceneFbAddBlobFiles(builder, blobFiles): builder.PrependUOffsetTRelativeSlot(20, flatbuffers.number_types.UOffsetTFlags.py_type(blobFiles), 0)
+def SceneFbStartBlobFilesVector(builder, numElems): return builder.StartVector(4, numElems, 4)
+def SceneFbAddNodeOrder(builder, nodeOrder): builder.PrependUOffsetTRelativeSlot(21, flatbuffers.number_types.UOffsetTFlags.py_type(nodeOrder), 0)
+def SceneFbStartNodeOrderVector(builder, numElems): return builder.StartVector(8, numElems, 4)
+def SceneFbAddNodeLevels(builder, nodeLevels): builder.PrependUOffsetTRelativeSlot(22, flatbuffers.number_types.UOffsetTFlags.py_type(nodeLevels), 0)
+def SceneFbStartNodeLevelsVector(builder, numElems): return builder.StartVector(8, numElems, 4)
 def SceneFbEnd(builder): return builder.EndObject()
@@ -0,0 +1,30 @@
+# automatically generated by the FlatBuffers compiler, do not modify
+
+# namespace: apemodefb
+
+import flatbuffers
+
+class TextureInfoFb(object):
+    __slots__ = ['_tab']
+
+    # TextureInfoFb
+    def Init(self, buf, pos):
+        self._tab = flatbuffers.table.Table(buf, pos)
+
+    # TextureInfoFb
+    def Width(self): return self._tab.Get(flatbuffers.number_types.Uint32Flags, self._tab.Pos + flatbuffers.number_types.UOffsetTFlags.py_type(0))
+    # TextureInfoFb
+    def Height(self): return self._tab.Get(flatbuffers.number_types.Uint32Flags, self._tab.Pos + flatbuffers.number_types.UOffsetTFlags.py_type(4))
+    # TextureInfoFb
+    def Format(self): return self._tab.Get(flatbuffers.number_types.Uint8Flags, self._tab.Pos + flatbuffers.number_types.UOffsetTFlags.py_type(8))
+    # TextureInfoFb
+    def MipCount(self): return self._tab.Get(flatbuffers.number_types.Uint8Flags, self._tab.Pos + flatbuffers.number_types.UOffsetTFlags.py_type(9))
+
+def CreateTextureInfoFb(builder, width, height, format, mipCount):
+    builder.Prep(4, 12)
+    builder.Pad(2)
+    builder.PrependUint8(mipCount)
+    builder.PrependUint8(format)
+    builder.PrependUint32(height)
+    builder.PrependUint32(width)
+    return builder.Offset()
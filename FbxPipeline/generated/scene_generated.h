@@ -34,6 +34,12 @@ struct SkinnedVertexFb;
 
 struct FatSkinnedVertexFb;
 
+struct BlobRefFb;
+
+struct BlockCompressionFb;
+
+struct TextureInfoFb;
+
 struct AnimStackFb;
 
 struct AnimLayerFb;
@@ -70,12 +76,16 @@ struct LightFb;
 
 struct NodeFb;
 
+struct NodeOrderFb;
+
+struct NodeLevelFb;
+
 struct FileFb;
 
 struct SceneFb;
 
 enum EVersionFb {
-  EVersionFb_Value = 12,
+  EVersionFb_Value = 17,
   EVersionFb_MIN = EVersionFb_Value,
   EVersionFb_MAX = EVersionFb_Value
 };
@@ -693,14 +703,20 @@ inline const char *EnumNameEAreaLightTypeFb(EAreaLightTypeFb e) {
 enum ECompressionTypeFb {
   ECompressionTypeFb_None = 0,
   ECompressionTypeFb_GoogleDraco3D = 1,
+  ECompressionTypeFb_Zstd = 2,
+  ECompressionTypeFb_LZ4 = 3,
+  ECompressionTypeFb_Meshopt = 4,
   ECompressionTypeFb_MIN = ECompressionTypeFb_None,
-  ECompressionTypeFb_MAX = ECompressionTypeFb_GoogleDraco3D
+  ECompressionTypeFb_MAX = ECompressionTypeFb_Meshopt
 };
 
-inline ECompressionTypeFb (&EnumValuesECompressionTypeFb())[2] {
+inline ECompressionTypeFb (&EnumValuesECompressionTypeFb())[5] {
   static ECompressionTypeFb values[] = {
     ECompressionTypeFb_None,
-    ECompressionTypeFb_GoogleDraco3D
+    ECompressionTypeFb_GoogleDraco3D,
+    ECompressionTypeFb_Zstd,
+    ECompressionTypeFb_LZ4,
+    ECompressionTypeFb_Meshopt
   };
   return values;
 }
@@ -709,6 +725,9 @@ inline const char **EnumNamesECompressionTypeFb() {
   static const char *names[] = {
     "None",
     "GoogleDraco3D",
+    "Zstd",
+    "LZ4",
+    "Meshopt",
     nullptr
   };
   return names;
@@ -836,6 +855,56 @@ inline const char *EnumNameEIndexTypeFb(EIndexTypeFb e) {
   return EnumNamesEIndexTypeFb()[index];
 }
 
+enum ETextureFormatFb {
+  ETextureFormatFb_RGBA8 = 0,
+  ETextureFormatFb_RGBA8_sRGB = 1,
+  ETextureFormatFb_BC1 = 2,
+  ETextureFormatFb_BC1_sRGB = 3,
+  ETextureFormatFb_BC3 = 4,
+  ETextureFormatFb_BC3_sRGB = 5,
+  ETextureFormatFb_BC5 = 6,
+  ETextureFormatFb_BC7 = 7,
+  ETextureFormatFb_BC7_sRGB = 8,
+  ETextureFormatFb_MIN = ETextureFormatFb_RGBA8,
+  ETextureFormatFb_MAX = ETextureFormatFb_BC7_sRGB
+};
+
+inline ETextureFormatFb (&EnumValuesETextureFormatFb())[9] {
+  static ETextureFormatFb values[] = {
+    ETextureFormatFb_RGBA8,
+    ETextureFormatFb_RGBA8_sRGB,
+    ETextureFormatFb_BC1,
+    ETextureFormatFb_BC1_sRGB,
+    ETextureFormatFb_BC3,
+    ETextureFormatFb_BC3_sRGB,
+    ETextureFormatFb_BC5,
+    ETextureFormatFb_BC7,
+    ETextureFormatFb_BC7_sRGB
+  };
+  return values;
+}
+
+inline const char **EnumNamesETextureFormatFb() {
+  static const char *names[] = {
+    "RGBA8",
+    "RGBA8_sRGB",
+    "BC1",
+    "BC1_sRGB",
+    "BC3",
+    "BC3_sRGB",
+    "BC5",
+    "BC7",
+    "BC7_sRGB",
+    nullptr
+  };
+  return names;
+}
+
+inline const char *EnumNameETextureFormatFb(ETextureFormatFb e) {
+  const size_t index = static_cast<int>(e);
+  return EnumNamesETextureFormatFb()[index];
+}
+
 enum EAnimCurveKeyTypeFb {
   EAnimCurveKeyTypeFb_Resampled = 0,
   EAnimCurveKeyTypeFb_Cubic = 1,
@@ -1365,6 +1434,128 @@ MANUALLY_ALIGNED_STRUCT(4) FatSkinnedVertexFb FLATBUFFERS_FINAL_CLASS {
 };
 STRUCT_END(FatSkinnedVertexFb, 76);
 
+MANUALLY_ALIGNED_STRUCT(8) BlobRefFb FLATBUFFERS_FINAL_CLASS {
+ private:
+  uint32_t blob_file_id_;
+  uint32_t size_;
+  uint64_t offset_;
+
+ public:
+  BlobRefFb() {
+    memset(this, 0, sizeof(BlobRefFb));
+  }
+  BlobRefFb(uint32_t _blob_file_id, uint32_t _size, uint64_t _offset)
+      : blob_file_id_(flatbuffers::EndianScalar(_blob_file_id)),
+        size_(flatbuffers::EndianScalar(_size)),
+        offset_(flatbuffers::EndianScalar(_offset)) {
+  }
+  uint32_t blob_file_id() const {
+    return flatbuffers::EndianScalar(blob_file_id_);
+  }
+  void mutate_blob_file_id(uint32_t _blob_file_id) {
+    flatbuffers::WriteScalar(&blob_file_id_, _blob_file_id);
+  }
+  uint32_t size() const {
+    return flatbuffers::EndianScalar(size_);
+  }
+  void mutate_size(uint32_t _size) {
+    flatbuffers::WriteScalar(&size_, _size);
+  }
+  uint64_t offset() const {
+    return flatbuffers::EndianScalar(offset_);
+  }
+  void mutate_offset(uint64_t _offset) {
+    flatbuffers::WriteScalar(&offset_, _offset);
+  }
+};
+STRUCT_END(BlobRefFb, 16);
+
+MANUALLY_ALIGNED_STRUCT(4) BlockCompressionFb FLATBUFFERS_FINAL_CLASS {
+ private:
+  uint8_t compression_type_;
+  int8_t level_;
+  int16_t padding0__;
+  uint32_t uncompressed_size_;
+
+ public:
+  BlockCompressionFb() {
+    memset(this, 0, sizeof(BlockCompressionFb));
+  }
+  BlockCompressionFb(ECompressionTypeFb _compression_type, int8_t _level, uint32_t _uncompressed_size)
+      : compression_type_(flatbuffers::EndianScalar(static_cast<uint8_t>(_compression_type))),
+        level_(flatbuffers::EndianScalar(_level)),
+        padding0__(0),
+        uncompressed_size_(flatbuffers::EndianScalar(_uncompressed_size)) {
+    (void)padding0__;
+  }
+  ECompressionTypeFb compression_type() const {
+    return static_cast<ECompressionTypeFb>(flatbuffers::EndianScalar(compression_type_));
+  }
+  void mutate_compression_type(ECompressionTypeFb _compression_type) {
+    flatbuffers::WriteScalar(&compression_type_, static_cast<uint8_t>(_compression_type));
+  }
+  int8_t level() const {
+    return flatbuffers::EndianScalar(level_);
+  }
+  void mutate_level(int8_t _level) {
+    flatbuffers::WriteScalar(&level_, _level);
+  }
+  uint32_t uncompressed_size() const {
+    return flatbuffers::EndianScalar(uncompressed_size_);
+  }
+  void mutate_uncompressed_size(uint32_t _uncompressed_size) {
+    flatbuffers::WriteScalar(&uncompressed_size_, _uncompressed_size);
+  }
+};
+STRUCT_END(BlockCompressionFb, 8);
+
+MANUALLY_ALIGNED_STRUCT(4) TextureInfoFb FLATBUFFERS_FINAL_CLASS {
+ private:
+  uint32_t width_;
+  uint32_t height_;
+  uint8_t format_;
+  uint8_t mip_count_;
+  int16_t padding0__;
+
+ public:
+  TextureInfoFb() {
+    memset(this, 0, sizeof(TextureInfoFb));
+  }
+  TextureInfoFb(uint32_t _width, uint32_t _height, ETextureFormatFb _format, uint8_t _mip_count)
+      : width_(flatbuffers::EndianScalar(_width)),
+        height_(flatbuffers::EndianScalar(_height)),
+        format_(flatbuffers::EndianScalar(static_cast<uint8_t>(_format))),
+        mip_count_(flatbuffers::EndianScalar(_mip_count)),
+        padding0__(0) {
+    (void)padding0__;
+  }
+  uint32_t width() const {
+    return flatbuffers::EndianScalar(width_);
+  }
+  void mutate_width(uint32_t _width) {
+    flatbuffers::WriteScalar(&width_, _width);
+  }
+  uint32_t height() const {
+    return flatbuffers::EndianScalar(height_);
+  }
+  void mutate_height(uint32_t _height) {
+    flatbuffers::WriteScalar(&height_, _height);
+  }
+  ETextureFormatFb format() const {
+    return static_cast<ETextureFormatFb>(flatbuffers::EndianScalar(format_));
+  }
+  void mutate_format(ETextureFormatFb _format) {
+    flatbuffers::WriteScalar(&format_, static_cast<uint8_t>(_format));
+  }
+  uint8_t mip_count() const {
+    return flatbuffers::EndianScalar(mip_count_);
+  }
+  void mutate_mip_count(uint8_t _mip_count) {
+    flatbuffers::WriteScalar(&mip_count_, _mip_count);
+  }
+};
+STRUCT_END(TextureInfoFb, 12);
+
 MANUALLY_ALIGNED_STRUCT(4) AnimStackFb FLATBUFFERS_FINAL_CLASS {
  private:
   uint32_t id_;
@@ -2342,6 +2533,62 @@ MANUALLY_ALIGNED_STRUCT(4) LightFb FLATBUFFERS_FINAL_CLASS {
 };
 STRUCT_END(LightFb, 64);
 
+MANUALLY_ALIGNED_STRUCT(4) NodeOrderFb FLATBUFFERS_FINAL_CLASS {
+ private:
+  uint32_t node_id_;
+  uint32_t parent_index_;
+
+ public:
+  NodeOrderFb() {
+    memset(this, 0, sizeof(NodeOrderFb));
+  }
+  NodeOrderFb(uint32_t _node_id, uint32_t _parent_index)
+      : node_id_(flatbuffers::EndianScalar(_node_id)),
+        parent_index_(flatbuffers::EndianScalar(_parent_index)) {
+  }
+  uint32_t node_id() const {
+    return flatbuffers::EndianScalar(node_id_);
+  }
+  void mutate_node_id(uint32_t _node_id) {
+    flatbuffers::WriteScalar(&node_id_, _node_id);
+  }
+  uint32_t parent_index() const {
+    return flatbuffers::EndianScalar(parent_index_);
+  }
+  void mutate_parent_index(uint32_t _parent_index) {
+    flatbuffers::WriteScalar(&parent_index_, _parent_index);
+  }
+};
+STRUCT_END(NodeOrderFb, 8);
+
+MANUALLY_ALIGNED_STRUCT(4) NodeLevelFb FLATBUFFERS_FINAL_CLASS {
+ private:
+  uint32_t first_index_;
+  uint32_t count_;
+
+ public:
+  NodeLevelFb() {
+    memset(this, 0, sizeof(NodeLevelFb));
+  }
+  NodeLevelFb(uint32_t _first_index, uint32_t _count)
+      : first_index_(flatbuffers::EndianScalar(_first_index)),
+        count_(flatbuffers::EndianScalar(_count)) {
+  }
+  uint32_t first_index() const {
+    return flatbuffers::EndianScalar(first_index_);
+  }
+  void mutate_first_index(uint32_t _first_index) {
+    flatbuffers::WriteScalar(&first_index_, _first_index);
+  }
+  uint32_t count() const {
+    return flatbuffers::EndianScalar(count_);
+  }
+  void mutate_count(uint32_t _count) {
+    flatbuffers::WriteScalar(&count_, _count);
+  }
+};
+STRUCT_END(NodeLevelFb, 8);
+
 struct AnimCurveFb FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   enum {
     VT_ID = 4,
@@ -2352,7 +2599,9 @@ struct AnimCurveFb FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
     VT_CHANNEL = 14,
     VT_KEYS = 16,
     VT_KEY_TYPE = 18,
-    VT_COMPRESSION_TYPE = 20
+    VT_COMPRESSION_TYPE = 20,
+    VT_KEYS_BLOB = 22,
+    VT_KEYS_COMPRESSION = 24
   };
   uint32_t id() const {
     return GetField<uint32_t>(VT_ID, 0);
@@ -2421,6 +2670,18 @@ struct AnimCurveFb FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   bool mutate_compression_type(ECompressionTypeFb _compression_type) {
     return SetField<uint8_t>(VT_COMPRESSION_TYPE, static_cast<uint8_t>(_compression_type), 0);
   }
+  const BlobRefFb *keys_blob() const {
+    return GetStruct<const BlobRefFb *>(VT_KEYS_BLOB);
+  }
+  BlobRefFb *mutable_keys_blob() {
+    return GetStruct<BlobRefFb *>(VT_KEYS_BLOB);
+  }
+  const BlockCompressionFb *keys_compression() const {
+    return GetStruct<const BlockCompressionFb *>(VT_KEYS_COMPRESSION);
+  }
+  BlockCompressionFb *mutable_keys_compression() {
+    return GetStruct<BlockCompressionFb *>(VT_KEYS_COMPRESSION);
+  }
   bool Verify(flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyField<uint32_t>(verifier, VT_ID) &&
@@ -2433,6 +2694,8 @@ struct AnimCurveFb FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
            verifier.Verify(keys()) &&
            VerifyField<uint8_t>(verifier, VT_KEY_TYPE) &&
            VerifyField<uint8_t>(verifier, VT_COMPRESSION_TYPE) &&
+           VerifyField<BlobRefFb>(verifier, VT_KEYS_BLOB) &&
+           VerifyField<BlockCompressionFb>(verifier, VT_KEYS_COMPRESSION) &&
            verifier.EndTable();
   }
 };
@@ -2467,6 +2730,12 @@ struct AnimCurveFbBuilder {
   void add_compression_type(ECompressionTypeFb compression_type) {
     fbb_.AddElement<uint8_t>(AnimCurveFb::VT_COMPRESSION_TYPE, static_cast<uint8_t>(compression_type), 0);
   }
+  void add_keys_blob(const BlobRefFb *keys_blob) {
+    fbb_.AddStruct(AnimCurveFb::VT_KEYS_BLOB, keys_blob);
+  }
+  void add_keys_compression(const BlockCompressionFb *keys_compression) {
+    fbb_.AddStruct(AnimCurveFb::VT_KEYS_COMPRESSION, keys_compression);
+  }
   explicit AnimCurveFbBuilder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
     start_ = fbb_.StartTable();
@@ -2489,8 +2758,12 @@ inline flatbuffers::Offset<AnimCurveFb> CreateAnimCurveFb(
     EAnimCurveChannelFb channel = EAnimCurveChannelFb_X,
     flatbuffers::Offset<flatbuffers::Vector<uint8_t>> keys = 0,
     EAnimCurveKeyTypeFb key_type = EAnimCurveKeyTypeFb_Resampled,
-    ECompressionTypeFb compression_type = ECompressionTypeFb_None) {
+    ECompressionTypeFb compression_type = ECompressionTypeFb_None,
+    const BlobRefFb *keys_blob = 0,
+    const BlockCompressionFb *keys_compression = 0) {
   AnimCurveFbBuilder builder_(_fbb);
+  builder_.add_keys_compression(keys_compression);
+  builder_.add_keys_blob(keys_blob);
   builder_.add_keys(keys);
   builder_.add_anim_layer_id(anim_layer_id);
   builder_.add_anim_stack_id(anim_stack_id);
@@ -2513,7 +2786,9 @@ inline flatbuffers::Offset<AnimCurveFb> CreateAnimCurveFbDirect(
     EAnimCurveChannelFb channel = EAnimCurveChannelFb_X,
     const std::vector<uint8_t> *keys = nullptr,
     EAnimCurveKeyTypeFb key_type = EAnimCurveKeyTypeFb_Resampled,
-    ECompressionTypeFb compression_type = ECompressionTypeFb_None) {
+    ECompressionTypeFb compression_type = ECompressionTypeFb_None,
+    const BlobRefFb *keys_blob = 0,
+    const BlockCompressionFb *keys_compression = 0) {
   return apemodefb::CreateAnimCurveFb(
       _fbb,
       id,
@@ -2524,7 +2799,9 @@ inline flatbuffers::Offset<AnimCurveFb> CreateAnimCurveFbDirect(
       channel,
       keys ? _fbb.CreateVector<uint8_t>(*keys) : 0,
       key_type,
-      compression_type);
+      compression_type,
+      keys_blob,
+      keys_compression);
 }
 
 struct NameFb FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
@@ -2710,7 +2987,11 @@ struct MeshFb FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
     VT_SUBSETS = 8,
     VT_INDICES = 10,
     VT_INDEX_TYPE = 12,
-    VT_SKIN_ID = 14
+    VT_SKIN_ID = 14,
+    VT_VERTICES_BLOB = 16,
+    VT_INDICES_BLOB = 18,
+    VT_VERTICES_COMPRESSION = 20,
+    VT_INDICES_COMPRESSION = 22
   };
   const flatbuffers::Vector<uint8_t> *vertices() const {
     return GetPointer<const flatbuffers::Vector<uint8_t> *>(VT_VERTICES);
@@ -2748,6 +3029,30 @@ struct MeshFb FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   bool mutate_skin_id(uint32_t _skin_id) {
     return SetField<uint32_t>(VT_SKIN_ID, _skin_id, 0);
   }
+  const BlobRefFb *vertices_blob() const {
+    return GetStruct<const BlobRefFb *>(VT_VERTICES_BLOB);
+  }
+  BlobRefFb *mutable_vertices_blob() {
+    return GetStruct<BlobRefFb *>(VT_VERTICES_BLOB);
+  }
+  const BlobRefFb *indices_blob() const {
+    return GetStruct<const BlobRefFb *>(VT_INDICES_BLOB);
+  }
+  BlobRefFb *mutable_indices_blob() {
+    return GetStruct<BlobRefFb *>(VT_INDICES_BLOB);
+  }
+  const BlockCompressionFb *vertices_compression() const {
+    return GetStruct<const BlockCompressionFb *>(VT_VERTICES_COMPRESSION);
+  }
+  BlockCompressionFb *mutable_vertices_compression() {
+    return GetStruct<BlockCompressionFb *>(VT_VERTICES_COMPRESSION);
+  }
+  const BlockCompressionFb *indices_compression() const {
+    return GetStruct<const BlockCompressionFb *>(VT_INDICES_COMPRESSION);
+  }
+  BlockCompressionFb *mutable_indices_compression() {
+    return GetStruct<BlockCompressionFb *>(VT_INDICES_COMPRESSION);
+  }
   bool Verify(flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyOffset(verifier, VT_VERTICES) &&
@@ -2760,6 +3065,10 @@ struct MeshFb FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
            verifier.Verify(indices()) &&
            VerifyField<uint8_t>(verifier, VT_INDEX_TYPE) &&
            VerifyField<uint32_t>(verifier, VT_SKIN_ID) &&
+           VerifyField<BlobRefFb>(verifier, VT_VERTICES_BLOB) &&
+           VerifyField<BlobRefFb>(verifier, VT_INDICES_BLOB) &&
+           VerifyField<BlockCompressionFb>(verifier, VT_VERTICES_COMPRESSION) &&
+           VerifyField<BlockCompressionFb>(verifier, VT_INDICES_COMPRESSION) &&
            verifier.EndTable();
   }
 };
@@ -2785,6 +3094,18 @@ struct MeshFbBuilder {
   void add_skin_id(uint32_t skin_id) {
     fbb_.AddElement<uint32_t>(MeshFb::VT_SKIN_ID, skin_id, 0);
   }
+  void add_vertices_blob(const BlobRefFb *vertices_blob) {
+    fbb_.AddStruct(MeshFb::VT_VERTICES_BLOB, vertices_blob);
+  }
+  void add_indices_blob(const BlobRefFb *indices_blob) {
+    fbb_.AddStruct(MeshFb::VT_INDICES_BLOB, indices_blob);
+  }
+  void add_vertices_compression(const BlockCompressionFb *vertices_compression) {
+    fbb_.AddStruct(MeshFb::VT_VERTICES_COMPRESSION, vertices_compression);
+  }
+  void add_indices_compression(const BlockCompressionFb *indices_compression) {
+    fbb_.AddStruct(MeshFb::VT_INDICES_COMPRESSION, indices_compression);
+  }
   explicit MeshFbBuilder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
     start_ = fbb_.StartTable();
@@ -2804,8 +3125,16 @@ inline flatbuffers::Offset<MeshFb> CreateMeshFb(
     flatbuffers::Offset<flatbuffers::Vector<const SubsetFb *>> subsets = 0,
     flatbuffers::Offset<flatbuffers::Vector<uint8_t>> indices = 0,
     EIndexTypeFb index_type = EIndexTypeFb_UInt16,
-    uint32_t skin_id = 0) {
+    uint32_t skin_id = 0,
+    const BlobRefFb *vertices_blob = 0,
+    const BlobRefFb *indices_blob = 0,
+    const BlockCompressionFb *vertices_compression = 0,
+    const BlockCompressionFb *indices_compression = 0) {
   MeshFbBuilder builder_(_fbb);
+  builder_.add_indices_compression(indices_compression);
+  builder_.add_vertices_compression(vertices_compression);
+  builder_.add_indices_blob(indices_blob);
+  builder_.add_vertices_blob(vertices_blob);
   builder_.add_skin_id(skin_id);
   builder_.add_indices(indices);
   builder_.add_subsets(subsets);
@@ -2822,7 +3151,11 @@ inline flatbuffers::Offset<MeshFb> CreateMeshFbDirect(
     const std::vector<const SubsetFb *> *subsets = nullptr,
     const std::vector<uint8_t> *indices = nullptr,
     EIndexTypeFb index_type = EIndexTypeFb_UInt16,
-    uint32_t skin_id = 0) {
+    uint32_t skin_id = 0,
+    const BlobRefFb *vertices_blob = 0,
+    const BlobRefFb *indices_blob = 0,
+    const BlockCompressionFb *vertices_compression = 0,
+    const BlockCompressionFb *indices_compression = 0) {
   return apemodefb::CreateMeshFb(
       _fbb,
       vertices ? _fbb.CreateVector<uint8_t>(*vertices) : 0,
@@ -2830,7 +3163,11 @@ inline flatbuffers::Offset<MeshFb> CreateMeshFbDirect(
       subsets ? _fbb.CreateVector<const SubsetFb *>(*subsets) : 0,
       indices ? _fbb.CreateVector<uint8_t>(*indices) : 0,
       index_type,
-      skin_id);
+      skin_id,
+      vertices_blob,
+      indices_blob,
+      vertices_compression,
+      indices_compression);
 }
 
 struct MaterialFb FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
@@ -3179,7 +3516,10 @@ struct FileFb FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   enum {
     VT_ID = 4,
     VT_NAME_ID = 6,
-    VT_BUFFER = 8
+    VT_BUFFER = 8,
+    VT_BUFFER_BLOB = 10,
+    VT_BUFFER_COMPRESSION = 12,
+    VT_TEXTURE_INFO = 14
   };
   uint32_t id() const {
     return GetField<uint32_t>(VT_ID, 0);
@@ -3212,12 +3552,33 @@ struct FileFb FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   flatbuffers::Vector<uint8_t> *mutable_buffer() {
     return GetPointer<flatbuffers::Vector<uint8_t> *>(VT_BUFFER);
   }
+  const BlobRefFb *buffer_blob() const {
+    return GetStruct<const BlobRefFb *>(VT_BUFFER_BLOB);
+  }
+  BlobRefFb *mutable_buffer_blob() {
+    return GetStruct<BlobRefFb *>(VT_BUFFER_BLOB);
+  }
+  const BlockCompressionFb *buffer_compression() const {
+    return GetStruct<const BlockCompressionFb *>(VT_BUFFER_COMPRESSION);
+  }
+  BlockCompressionFb *mutable_buffer_compression() {
+    return GetStruct<BlockCompressionFb *>(VT_BUFFER_COMPRESSION);
+  }
+  const TextureInfoFb *texture_info() const {
+    return GetStruct<const TextureInfoFb *>(VT_TEXTURE_INFO);
+  }
+  TextureInfoFb *mutable_texture_info() {
+    return GetStruct<TextureInfoFb *>(VT_TEXTURE_INFO);
+  }
   bool Verify(flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyField<uint32_t>(verifier, VT_ID) &&
            VerifyField<uint32_t>(verifier, VT_NAME_ID) &&
            VerifyOffset(verifier, VT_BUFFER) &&
            verifier.Verify(buffer()) &&
+           VerifyField<BlobRefFb>(verifier, VT_BUFFER_BLOB) &&
+           VerifyField<BlockCompressionFb>(verifier, VT_BUFFER_COMPRESSION) &&
+           VerifyField<TextureInfoFb>(verifier, VT_TEXTURE_INFO) &&
            verifier.EndTable();
   }
 };
@@ -3234,6 +3595,15 @@ struct FileFbBuilder {
   void add_buffer(flatbuffers::Offset<flatbuffers::Vector<uint8_t>> buffer) {
     fbb_.AddOffset(FileFb::VT_BUFFER, buffer);
   }
+  void add_buffer_blob(const BlobRefFb *buffer_blob) {
+    fbb_.AddStruct(FileFb::VT_BUFFER_BLOB, buffer_blob);
+  }
+  void add_buffer_compression(const BlockCompressionFb *buffer_compression) {
+    fbb_.AddStruct(FileFb::VT_BUFFER_COMPRESSION, buffer_compression);
+  }
+  void add_texture_info(const TextureInfoFb *texture_info) {
+    fbb_.AddStruct(FileFb::VT_TEXTURE_INFO, texture_info);
+  }
   explicit FileFbBuilder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
     start_ = fbb_.StartTable();
@@ -3250,8 +3620,14 @@ inline flatbuffers::Offset<FileFb> CreateFileFb(
     flatbuffers::FlatBufferBuilder &_fbb,
     uint32_t id = 0,
     uint32_t name_id = 0,
-    flatbuffers::Offset<flatbuffers::Vector<uint8_t>> buffer = 0) {
+    flatbuffers::Offset<flatbuffers::Vector<uint8_t>> buffer = 0,
+    const BlobRefFb *buffer_blob = 0,
+    const BlockCompressionFb *buffer_compression = 0,
+    const TextureInfoFb *texture_info = 0) {
   FileFbBuilder builder_(_fbb);
+  builder_.add_texture_info(texture_info);
+  builder_.add_buffer_compression(buffer_compression);
+  builder_.add_buffer_blob(buffer_blob);
   builder_.add_buffer(buffer);
   builder_.add_name_id(name_id);
   builder_.add_id(id);
@@ -3262,12 +3638,18 @@ inline flatbuffers::Offset<FileFb> CreateFileFbDirect(
     flatbuffers::FlatBufferBuilder &_fbb,
     uint32_t id = 0,
     uint32_t name_id = 0,
-    const std::vector<uint8_t> *buffer = nullptr) {
+    const std::vector<uint8_t> *buffer = nullptr,
+    const BlobRefFb *buffer_blob = 0,
+    const BlockCompressionFb *buffer_compression = 0,
+    const TextureInfoFb *texture_info = 0) {
   return apemodefb::CreateFileFb(
       _fbb,
       id,
       name_id,
-      buffer ? _fbb.CreateVector<uint8_t>(*buffer) : 0);
+      buffer ? _fbb.CreateVector<uint8_t>(*buffer) : 0,
+      buffer_blob,
+      buffer_compression,
+      texture_info);
 }
 
 struct SceneFb FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
@@ -3291,7 +3673,10 @@ struct SceneFb FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
     VT_BOOL_VALUES = 36,
     VT_INT_VALUES = 38,
     VT_FLOAT_VALUES = 40,
-    VT_STRING_VALUES = 42
+    VT_STRING_VALUES = 42,
+    VT_BLOB_FILES = 44,
+    VT_NODE_ORDER = 46,
+    VT_NODE_LEVELS = 48
   };
   EVersionFb version() const {
     return static_cast<EVersionFb>(GetField<uint8_t>(VT_VERSION, 0));
@@ -3413,6 +3798,24 @@ struct SceneFb FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *mutable_string_values() {
     return GetPointer<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *>(VT_STRING_VALUES);
   }
+  const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *blob_files() const {
+    return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *>(VT_BLOB_FILES);
+  }
+  flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *mutable_blob_files() {
+    return GetPointer<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *>(VT_BLOB_FILES);
+  }
+  const flatbuffers::Vector<const NodeOrderFb *> *node_order() const {
+    return GetPointer<const flatbuffers::Vector<const NodeOrderFb *> *>(VT_NODE_ORDER);
+  }
+  flatbuffers::Vector<const NodeOrderFb *> *mutable_node_order() {
+    return GetPointer<flatbuffers::Vector<const NodeOrderFb *> *>(VT_NODE_ORDER);
+  }
+  const flatbuffers::Vector<const NodeLevelFb *> *node_levels() const {
+    return GetPointer<const flatbuffers::Vector<const NodeLevelFb *> *>(VT_NODE_LEVELS);
+  }
+  flatbuffers::Vector<const NodeLevelFb *> *mutable_node_levels() {
+    return GetPointer<flatbuffers::Vector<const NodeLevelFb *> *>(VT_NODE_LEVELS);
+  }
   bool Verify(flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyField<uint8_t>(verifier, VT_VERSION) &&
@@ -3459,6 +3862,13 @@ struct SceneFb FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
            VerifyOffset(verifier, VT_STRING_VALUES) &&
            verifier.Verify(string_values()) &&
            verifier.VerifyVectorOfStrings(string_values()) &&
+           VerifyOffset(verifier, VT_BLOB_FILES) &&
+           verifier.Verify(blob_files()) &&
+           verifier.VerifyVectorOfStrings(blob_files()) &&
+           VerifyOffset(verifier, VT_NODE_ORDER) &&
+           verifier.Verify(node_order()) &&
+           VerifyOffset(verifier, VT_NODE_LEVELS) &&
+           verifier.Verify(node_levels()) &&
            verifier.EndTable();
   }
 };
@@ -3526,6 +3936,15 @@ struct SceneFbBuilder {
   void add_string_values(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>> string_values) {
     fbb_.AddOffset(SceneFb::VT_STRING_VALUES, string_values);
   }
+  void add_blob_files(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>> blob_files) {
+    fbb_.AddOffset(SceneFb::VT_BLOB_FILES, blob_files);
+  }
+  void add_node_order(flatbuffers::Offset<flatbuffers::Vector<const NodeOrderFb *>> node_order) {
+    fbb_.AddOffset(SceneFb::VT_NODE_ORDER, node_order);
+  }
+  void add_node_levels(flatbuffers::Offset<flatbuffers::Vector<const NodeLevelFb *>> node_levels) {
+    fbb_.AddOffset(SceneFb::VT_NODE_LEVELS, node_levels);
+  }
   explicit SceneFbBuilder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
     start_ = fbb_.StartTable();
@@ -3559,8 +3978,14 @@ inline flatbuffers::Offset<SceneFb> CreateSceneFb(
     flatbuffers::Offset<flatbuffers::Vector<uint8_t>> bool_values = 0,
     flatbuffers::Offset<flatbuffers::Vector<int32_t>> int_values = 0,
     flatbuffers::Offset<flatbuffers::Vector<float>> float_values = 0,
-    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>> string_values = 0) {
+    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>> string_values = 0,
+    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>> blob_files = 0,
+    flatbuffers::Offset<flatbuffers::Vector<const NodeOrderFb *>> node_order = 0,
+    flatbuffers::Offset<flatbuffers::Vector<const NodeLevelFb *>> node_levels = 0) {
   SceneFbBuilder builder_(_fbb);
+  builder_.add_node_levels(node_levels);
+  builder_.add_node_order(node_order);
+  builder_.add_blob_files(blob_files);
   builder_.add_string_values(string_values);
   builder_.add_float_values(float_values);
   builder_.add_int_values(int_values);
@@ -3605,7 +4030,10 @@ inline flatbuffers::Offset<SceneFb> CreateSceneFbDirect(
     const std::vector<uint8_t> *bool_values = nullptr,
     const std::vector<int32_t> *int_values = nullptr,
     const std::vector<float> *float_values = nullptr,
-    const std::vector<flatbuffers::Offset<flatbuffers::String>> *string_values = nullptr) {
+    const std::vector<flatbuffers::Offset<flatbuffers::String>> *string_values = nullptr,
+    const std::vector<flatbuffers::Offset<flatbuffers::String>> *blob_files = nullptr,
+    const std::vector<const NodeOrderFb *> *node_order = nullptr,
+    const std::vector<const NodeLevelFb *> *node_levels = nullptr) {
   return apemodefb::CreateSceneFb(
       _fbb,
       version,
@@ -3627,7 +4055,10 @@ inline flatbuffers::Offset<SceneFb> CreateSceneFbDirect(
       bool_values ? _fbb.CreateVector<uint8_t>(*bool_values) : 0,
       int_values ? _fbb.CreateVector<int32_t>(*int_values) : 0,
       float_values ? _fbb.CreateVector<float>(*float_values) : 0,
-      string_values ? _fbb.CreateVector<flatbuffers::Offset<flatbuffers::String>>(*string_values) : 0);
+      string_values ? _fbb.CreateVector<flatbuffers::Offset<flatbuffers::String>>(*string_values) : 0,
+      blob_files ? _fbb.CreateVector<flatbuffers::Offset<flatbuffers::String>>(*blob_files) : 0,
+      node_order ? _fbb.CreateVector<const NodeOrderFb *>(*node_order) : 0,
+      node_levels ? _fbb.CreateVector<const NodeLevelFb *>(*node_levels) : 0);
 }
 
 inline const apemodefb::SceneFb *GetSceneFb(const void *buf) {
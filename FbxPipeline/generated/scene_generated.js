@@ -10,7 +10,7 @@ var apemodefb = apemodefb || {};
  * @enum
  */
 apemodefb.EVersionFb = {
-  Value: 12
+  Value: 17
 };
 
 /**
@@ -188,7 +188,10 @@ apemodefb.EAreaLightTypeFb = {
  */
 apemodefb.ECompressionTypeFb = {
   None: 0,
-  GoogleDraco3D: 1
+  GoogleDraco3D: 1,
+  Zstd: 2,
+  LZ4: 3,
+  Meshopt: 4
 };
 
 /**
@@ -225,6 +228,21 @@ apemodefb.EIndexTypeFb = {
   Count: 2
 };
 
+/**
+ * @enum
+ */
+apemodefb.ETextureFormatFb = {
+  RGBA8: 0,
+  RGBA8_sRGB: 1,
+  BC1: 2,
+  BC1_sRGB: 3,
+  BC3: 4,
+  BC3_sRGB: 5,
+  BC5: 6,
+  BC7: 7,
+  BC7_sRGB: 8
+};
+
 /**
  * @enum
  */
@@ -1667,7 +1685,7 @@ apemodefb.FatSkinnedVertexFb.createFatSkinnedVertexFb = function(builder, skinne
 /**
  * @constructor
  */
-apemodefb.AnimStackFb = function() {
+apemodefb.BlobRefFb = function() {
   /**
    * @type {flatbuffers.ByteBuffer}
    */
@@ -1682,9 +1700,9 @@ apemodefb.AnimStackFb = function() {
 /**
  * @param {number} i
  * @param {flatbuffers.ByteBuffer} bb
- * @returns {apemodefb.AnimStackFb}
+ * @returns {apemodefb.BlobRefFb}
  */
-apemodefb.AnimStackFb.prototype.__init = function(i, bb) {
+apemodefb.BlobRefFb.prototype.__init = function(i, bb) {
   this.bb_pos = i;
   this.bb = bb;
   return this;
@@ -1693,7 +1711,7 @@ apemodefb.AnimStackFb.prototype.__init = function(i, bb) {
 /**
  * @returns {number}
  */
-apemodefb.AnimStackFb.prototype.id = function() {
+apemodefb.BlobRefFb.prototype.blobFileId = function() {
   return this.bb.readUint32(this.bb_pos);
 };
 
@@ -1701,7 +1719,7 @@ apemodefb.AnimStackFb.prototype.id = function() {
  * @param {number} value
  * @returns {boolean}
  */
-apemodefb.AnimStackFb.prototype.mutate_id = function(value) {
+apemodefb.BlobRefFb.prototype.mutate_blob_file_id = function(value) {
   var offset = this.bb.__offset(this.bb_pos, 0);
 
   if (offset === 0) {
@@ -1715,7 +1733,7 @@ apemodefb.AnimStackFb.prototype.mutate_id = function(value) {
 /**
  * @returns {number}
  */
-apemodefb.AnimStackFb.prototype.nameId = function() {
+apemodefb.BlobRefFb.prototype.size = function() {
   return this.bb.readUint32(this.bb_pos + 4);
 };
 
@@ -1723,7 +1741,7 @@ apemodefb.AnimStackFb.prototype.nameId = function() {
  * @param {number} value
  * @returns {boolean}
  */
-apemodefb.AnimStackFb.prototype.mutate_name_id = function(value) {
+apemodefb.BlobRefFb.prototype.mutate_size = function(value) {
   var offset = this.bb.__offset(this.bb_pos, 4);
 
   if (offset === 0) {
@@ -1734,23 +1752,155 @@ apemodefb.AnimStackFb.prototype.mutate_name_id = function(value) {
   return true;
 };
 
+/**
+ * @returns {flatbuffers.Long}
+ */
+apemodefb.BlobRefFb.prototype.offset = function() {
+  return this.bb.readUint64(this.bb_pos + 8);
+};
+
+/**
+ * @param {flatbuffers.Long} value
+ * @returns {boolean}
+ */
+apemodefb.BlobRefFb.prototype.mutate_offset = function(value) {
+  var offset = this.bb.__offset(this.bb_pos, 8);
+
+  if (offset === 0) {
+    return false;
+  }
+
+  this.bb.writeUint64(this.bb_pos + offset, value);
+  return true;
+};
+
 /**
  * @param {flatbuffers.Builder} builder
- * @param {number} id
- * @param {number} name_id
+ * @param {number} blob_file_id
+ * @param {number} size
+ * @param {flatbuffers.Long} offset
  * @returns {flatbuffers.Offset}
  */
-apemodefb.AnimStackFb.createAnimStackFb = function(builder, id, name_id) {
+apemodefb.BlobRefFb.createBlobRefFb = function(builder, blob_file_id, size, offset) {
+  builder.prep(8, 16);
+  builder.writeInt64(offset);
+  builder.writeInt32(size);
+  builder.writeInt32(blob_file_id);
+  return builder.offset();
+};
+
+/**
+ * @constructor
+ */
+apemodefb.BlockCompressionFb = function() {
+  /**
+   * @type {flatbuffers.ByteBuffer}
+   */
+  this.bb = null;
+
+  /**
+   * @type {number}
+   */
+  this.bb_pos = 0;
+};
+
+/**
+ * @param {number} i
+ * @param {flatbuffers.ByteBuffer} bb
+ * @returns {apemodefb.BlockCompressionFb}
+ */
+apemodefb.BlockCompressionFb.prototype.__init = function(i, bb) {
+  this.bb_pos = i;
+  this.bb = bb;
+  return this;
+};
+
+/**
+ * @returns {apemodefb.ECompressionTypeFb}
+ */
+apemodefb.BlockCompressionFb.prototype.compressionType = function() {
+  return /** @type {apemodefb.ECompressionTypeFb} */ (this.bb.readUint8(this.bb_pos));
+};
+
+/**
+ * @param {apemodefb.ECompressionTypeFb} value
+ * @returns {boolean}
+ */
+apemodefb.BlockCompressionFb.prototype.mutate_compression_type = function(value) {
+  var offset = this.bb.__offset(this.bb_pos, 0);
+
+  if (offset === 0) {
+    return false;
+  }
+
+  this.bb.writeUint8(this.bb_pos + offset, value);
+  return true;
+};
+
+/**
+ * @returns {number}
+ */
+apemodefb.BlockCompressionFb.prototype.level = function() {
+  return this.bb.readInt8(this.bb_pos + 1);
+};
+
+/**
+ * @param {number} value
+ * @returns {boolean}
+ */
+apemodefb.BlockCompressionFb.prototype.mutate_level = function(value) {
+  var offset = this.bb.__offset(this.bb_pos, 1);
+
+  if (offset === 0) {
+    return false;
+  }
+
+  this.bb.writeInt8(this.bb_pos + offset, value);
+  return true;
+};
+
+/**
+ * @returns {number}
+ */
+apemodefb.BlockCompressionFb.prototype.uncompressedSize = function() {
+  return this.bb.readUint32(this.bb_pos + 4);
+};
+
+/**
+ * @param {number} value
+ * @returns {boolean}
+ */
+apemodefb.BlockCompressionFb.prototype.mutate_uncompressed_size = function(value) {
+  var offset = this.bb.__offset(this.bb_pos, 4);
+
+  if (offset === 0) {
+    return false;
+  }
+
+  this.bb.writeUint32(this.bb_pos + offset, value);
+  return true;
+};
+
+/**
+ * @param {flatbuffers.Builder} builder
+ * @param {apemodefb.ECompressionTypeFb} compression_type
+ * @param {number} level
+ * @param {number} uncompressed_size
+ * @returns {flatbuffers.Offset}
+ */
+apemodefb.BlockCompressionFb.createBlockCompressionFb = function(builder, compression_type, level, uncompressed_size) {
   builder.prep(4, 8);
-  builder.writeInt32(name_id);
-  builder.writeInt32(id);
+  builder.writeInt32(uncompressed_size);
+  builder.pad(2);
+  builder.writeInt8(level);
+  builder.writeInt8(compression_type);
   return builder.offset();
 };
 
 /**
  * @constructor
  */
-apemodefb.AnimLayerFb = function() {
+apemodefb.TextureInfoFb = function() {
   /**
    * @type {flatbuffers.ByteBuffer}
    */
@@ -1765,9 +1915,9 @@ apemodefb.AnimLayerFb = function() {
 /**
  * @param {number} i
  * @param {flatbuffers.ByteBuffer} bb
- * @returns {apemodefb.AnimLayerFb}
+ * @returns {apemodefb.TextureInfoFb}
  */
-apemodefb.AnimLayerFb.prototype.__init = function(i, bb) {
+apemodefb.TextureInfoFb.prototype.__init = function(i, bb) {
   this.bb_pos = i;
   this.bb = bb;
   return this;
@@ -1776,7 +1926,7 @@ apemodefb.AnimLayerFb.prototype.__init = function(i, bb) {
 /**
  * @returns {number}
  */
-apemodefb.AnimLayerFb.prototype.id = function() {
+apemodefb.TextureInfoFb.prototype.width = function() {
   return this.bb.readUint32(this.bb_pos);
 };
 
@@ -1784,7 +1934,7 @@ apemodefb.AnimLayerFb.prototype.id = function() {
  * @param {number} value
  * @returns {boolean}
  */
-apemodefb.AnimLayerFb.prototype.mutate_id = function(value) {
+apemodefb.TextureInfoFb.prototype.mutate_width = function(value) {
   var offset = this.bb.__offset(this.bb_pos, 0);
 
   if (offset === 0) {
@@ -1798,7 +1948,7 @@ apemodefb.AnimLayerFb.prototype.mutate_id = function(value) {
 /**
  * @returns {number}
  */
-apemodefb.AnimLayerFb.prototype.animStackId = function() {
+apemodefb.TextureInfoFb.prototype.height = function() {
   return this.bb.readUint32(this.bb_pos + 4);
 };
 
@@ -1806,7 +1956,7 @@ apemodefb.AnimLayerFb.prototype.animStackId = function() {
  * @param {number} value
  * @returns {boolean}
  */
-apemodefb.AnimLayerFb.prototype.mutate_anim_stack_id = function(value) {
+apemodefb.TextureInfoFb.prototype.mutate_height = function(value) {
   var offset = this.bb.__offset(this.bb_pos, 4);
 
   if (offset === 0) {
@@ -1818,70 +1968,71 @@ apemodefb.AnimLayerFb.prototype.mutate_anim_stack_id = function(value) {
 };
 
 /**
- * @returns {number}
+ * @returns {apemodefb.ETextureFormatFb}
  */
-apemodefb.AnimLayerFb.prototype.animStackIdx = function() {
-  return this.bb.readUint32(this.bb_pos + 8);
+apemodefb.TextureInfoFb.prototype.format = function() {
+  return /** @type {apemodefb.ETextureFormatFb} */ (this.bb.readUint8(this.bb_pos + 8));
 };
 
 /**
- * @param {number} value
+ * @param {apemodefb.ETextureFormatFb} value
  * @returns {boolean}
  */
-apemodefb.AnimLayerFb.prototype.mutate_anim_stack_idx = function(value) {
+apemodefb.TextureInfoFb.prototype.mutate_format = function(value) {
   var offset = this.bb.__offset(this.bb_pos, 8);
 
   if (offset === 0) {
     return false;
   }
 
-  this.bb.writeUint32(this.bb_pos + offset, value);
+  this.bb.writeUint8(this.bb_pos + offset, value);
   return true;
 };
 
 /**
  * @returns {number}
  */
-apemodefb.AnimLayerFb.prototype.nameId = function() {
-  return this.bb.readUint32(this.bb_pos + 12);
+apemodefb.TextureInfoFb.prototype.mipCount = function() {
+  return this.bb.readUint8(this.bb_pos + 9);
 };
 
 /**
  * @param {number} value
  * @returns {boolean}
  */
-apemodefb.AnimLayerFb.prototype.mutate_name_id = function(value) {
-  var offset = this.bb.__offset(this.bb_pos, 12);
+apemodefb.TextureInfoFb.prototype.mutate_mip_count = function(value) {
+  var offset = this.bb.__offset(this.bb_pos, 9);
 
   if (offset === 0) {
     return false;
   }
 
-  this.bb.writeUint32(this.bb_pos + offset, value);
+  this.bb.writeUint8(this.bb_pos + offset, value);
   return true;
 };
 
 /**
  * @param {flatbuffers.Builder} builder
- * @param {number} id
- * @param {number} anim_stack_id
- * @param {number} anim_stack_idx
- * @param {number} name_id
+ * @param {number} width
+ * @param {number} height
+ * @param {apemodefb.ETextureFormatFb} format
+ * @param {number} mip_count
  * @returns {flatbuffers.Offset}
  */
-apemodefb.AnimLayerFb.createAnimLayerFb = function(builder, id, anim_stack_id, anim_stack_idx, name_id) {
-  builder.prep(4, 16);
-  builder.writeInt32(name_id);
-  builder.writeInt32(anim_stack_idx);
-  builder.writeInt32(anim_stack_id);
-  builder.writeInt32(id);
+apemodefb.TextureInfoFb.createTextureInfoFb = function(builder, width, height, format, mip_count) {
+  builder.prep(4, 12);
+  builder.pad(2);
+  builder.writeInt8(mip_count);
+  builder.writeInt8(format);
+  builder.writeInt32(height);
+  builder.writeInt32(width);
   return builder.offset();
 };
 
 /**
  * @constructor
  */
-apemodefb.AnimCurveResampledKeyFb = function() {
+apemodefb.AnimStackFb = function() {
   /**
    * @type {flatbuffers.ByteBuffer}
    */
@@ -1896,9 +2047,9 @@ apemodefb.AnimCurveResampledKeyFb = function() {
 /**
  * @param {number} i
  * @param {flatbuffers.ByteBuffer} bb
- * @returns {apemodefb.AnimCurveResampledKeyFb}
+ * @returns {apemodefb.AnimStackFb}
  */
-apemodefb.AnimCurveResampledKeyFb.prototype.__init = function(i, bb) {
+apemodefb.AnimStackFb.prototype.__init = function(i, bb) {
   this.bb_pos = i;
   this.bb = bb;
   return this;
@@ -1907,64 +2058,64 @@ apemodefb.AnimCurveResampledKeyFb.prototype.__init = function(i, bb) {
 /**
  * @returns {number}
  */
-apemodefb.AnimCurveResampledKeyFb.prototype.time = function() {
-  return this.bb.readFloat32(this.bb_pos);
+apemodefb.AnimStackFb.prototype.id = function() {
+  return this.bb.readUint32(this.bb_pos);
 };
 
 /**
  * @param {number} value
  * @returns {boolean}
  */
-apemodefb.AnimCurveResampledKeyFb.prototype.mutate_time = function(value) {
+apemodefb.AnimStackFb.prototype.mutate_id = function(value) {
   var offset = this.bb.__offset(this.bb_pos, 0);
 
   if (offset === 0) {
     return false;
   }
 
-  this.bb.writeFloat32(this.bb_pos + offset, value);
+  this.bb.writeUint32(this.bb_pos + offset, value);
   return true;
 };
 
 /**
  * @returns {number}
  */
-apemodefb.AnimCurveResampledKeyFb.prototype.value = function() {
-  return this.bb.readFloat32(this.bb_pos + 4);
+apemodefb.AnimStackFb.prototype.nameId = function() {
+  return this.bb.readUint32(this.bb_pos + 4);
 };
 
 /**
  * @param {number} value
  * @returns {boolean}
  */
-apemodefb.AnimCurveResampledKeyFb.prototype.mutate_value = function(value) {
+apemodefb.AnimStackFb.prototype.mutate_name_id = function(value) {
   var offset = this.bb.__offset(this.bb_pos, 4);
 
   if (offset === 0) {
     return false;
   }
 
-  this.bb.writeFloat32(this.bb_pos + offset, value);
+  this.bb.writeUint32(this.bb_pos + offset, value);
   return true;
 };
 
 /**
  * @param {flatbuffers.Builder} builder
- * @param {number} time
- * @param {number} value
+ * @param {number} id
+ * @param {number} name_id
  * @returns {flatbuffers.Offset}
  */
-apemodefb.AnimCurveResampledKeyFb.createAnimCurveResampledKeyFb = function(builder, time, value) {
+apemodefb.AnimStackFb.createAnimStackFb = function(builder, id, name_id) {
   builder.prep(4, 8);
-  builder.writeFloat32(value);
-  builder.writeFloat32(time);
+  builder.writeInt32(name_id);
+  builder.writeInt32(id);
   return builder.offset();
 };
 
 /**
  * @constructor
  */
-apemodefb.AnimCurveCubicKeyFb = function() {
+apemodefb.AnimLayerFb = function() {
   /**
    * @type {flatbuffers.ByteBuffer}
    */
@@ -1979,9 +2130,9 @@ apemodefb.AnimCurveCubicKeyFb = function() {
 /**
  * @param {number} i
  * @param {flatbuffers.ByteBuffer} bb
- * @returns {apemodefb.AnimCurveCubicKeyFb}
+ * @returns {apemodefb.AnimLayerFb}
  */
-apemodefb.AnimCurveCubicKeyFb.prototype.__init = function(i, bb) {
+apemodefb.AnimLayerFb.prototype.__init = function(i, bb) {
   this.bb_pos = i;
   this.bb = bb;
   return this;
@@ -1990,104 +2141,318 @@ apemodefb.AnimCurveCubicKeyFb.prototype.__init = function(i, bb) {
 /**
  * @returns {number}
  */
-apemodefb.AnimCurveCubicKeyFb.prototype.time = function() {
-  return this.bb.readFloat32(this.bb_pos);
+apemodefb.AnimLayerFb.prototype.id = function() {
+  return this.bb.readUint32(this.bb_pos);
 };
 
 /**
  * @param {number} value
  * @returns {boolean}
  */
-apemodefb.AnimCurveCubicKeyFb.prototype.mutate_time = function(value) {
+apemodefb.AnimLayerFb.prototype.mutate_id = function(value) {
   var offset = this.bb.__offset(this.bb_pos, 0);
 
   if (offset === 0) {
     return false;
   }
 
-  this.bb.writeFloat32(this.bb_pos + offset, value);
+  this.bb.writeUint32(this.bb_pos + offset, value);
   return true;
 };
 
 /**
  * @returns {number}
  */
-apemodefb.AnimCurveCubicKeyFb.prototype.valueBez0Bez3 = function() {
-  return this.bb.readFloat32(this.bb_pos + 4);
+apemodefb.AnimLayerFb.prototype.animStackId = function() {
+  return this.bb.readUint32(this.bb_pos + 4);
 };
 
 /**
  * @param {number} value
  * @returns {boolean}
  */
-apemodefb.AnimCurveCubicKeyFb.prototype.mutate_value_bez0_bez3 = function(value) {
+apemodefb.AnimLayerFb.prototype.mutate_anim_stack_id = function(value) {
   var offset = this.bb.__offset(this.bb_pos, 4);
 
   if (offset === 0) {
     return false;
   }
 
-  this.bb.writeFloat32(this.bb_pos + offset, value);
+  this.bb.writeUint32(this.bb_pos + offset, value);
   return true;
 };
 
 /**
  * @returns {number}
  */
-apemodefb.AnimCurveCubicKeyFb.prototype.bez1 = function() {
-  return this.bb.readFloat32(this.bb_pos + 8);
+apemodefb.AnimLayerFb.prototype.animStackIdx = function() {
+  return this.bb.readUint32(this.bb_pos + 8);
 };
 
 /**
  * @param {number} value
  * @returns {boolean}
  */
-apemodefb.AnimCurveCubicKeyFb.prototype.mutate_bez1 = function(value) {
+apemodefb.AnimLayerFb.prototype.mutate_anim_stack_idx = function(value) {
   var offset = this.bb.__offset(this.bb_pos, 8);
 
   if (offset === 0) {
     return false;
   }
 
-  this.bb.writeFloat32(this.bb_pos + offset, value);
+  this.bb.writeUint32(this.bb_pos + offset, value);
   return true;
 };
 
 /**
  * @returns {number}
  */
-apemodefb.AnimCurveCubicKeyFb.prototype.bez2 = function() {
-  return this.bb.readFloat32(this.bb_pos + 12);
+apemodefb.AnimLayerFb.prototype.nameId = function() {
+  return this.bb.readUint32(this.bb_pos + 12);
 };
 
 /**
  * @param {number} value
  * @returns {boolean}
  */
-apemodefb.AnimCurveCubicKeyFb.prototype.mutate_bez2 = function(value) {
+apemodefb.AnimLayerFb.prototype.mutate_name_id = function(value) {
   var offset = this.bb.__offset(this.bb_pos, 12);
 
   if (offset === 0) {
     return false;
   }
 
-  this.bb.writeFloat32(this.bb_pos + offset, value);
+  this.bb.writeUint32(this.bb_pos + offset, value);
   return true;
 };
 
 /**
- * @returns {apemodefb.EInterpolationModeFb}
+ * @param {flatbuffers.Builder} builder
+ * @param {number} id
+ * @param {number} anim_stack_id
+ * @param {number} anim_stack_idx
+ * @param {number} name_id
+ * @returns {flatbuffers.Offset}
  */
-apemodefb.AnimCurveCubicKeyFb.prototype.interpolationMode = function() {
-  return /** @type {apemodefb.EInterpolationModeFb} */ (this.bb.readUint8(this.bb_pos + 16));
+apemodefb.AnimLayerFb.createAnimLayerFb = function(builder, id, anim_stack_id, anim_stack_idx, name_id) {
+  builder.prep(4, 16);
+  builder.writeInt32(name_id);
+  builder.writeInt32(anim_stack_idx);
+  builder.writeInt32(anim_stack_id);
+  builder.writeInt32(id);
+  return builder.offset();
 };
 
 /**
- * @param {apemodefb.EInterpolationModeFb} value
- * @returns {boolean}
+ * @constructor
  */
-apemodefb.AnimCurveCubicKeyFb.prototype.mutate_interpolation_mode = function(value) {
-  var offset = this.bb.__offset(this.bb_pos, 16);
+apemodefb.AnimCurveResampledKeyFb = function() {
+  /**
+   * @type {flatbuffers.ByteBuffer}
+   */
+  this.bb = null;
+
+  /**
+   * @type {number}
+   */
+  this.bb_pos = 0;
+};
+
+/**
+ * @param {number} i
+ * @param {flatbuffers.ByteBuffer} bb
+ * @returns {apemodefb.AnimCurveResampledKeyFb}
+ */
+apemodefb.AnimCurveResampledKeyFb.prototype.__init = function(i, bb) {
+  this.bb_pos = i;
+  this.bb = bb;
+  return this;
+};
+
+/**
+ * @returns {number}
+ */
+apemodefb.AnimCurveResampledKeyFb.prototype.time = function() {
+  return this.bb.readFloat32(this.bb_pos);
+};
+
+/**
+ * @param {number} value
+ * @returns {boolean}
+ */
+apemodefb.AnimCurveResampledKeyFb.prototype.mutate_time = function(value) {
+  var offset = this.bb.__offset(this.bb_pos, 0);
+
+  if (offset === 0) {
+    return false;
+  }
+
+  this.bb.writeFloat32(this.bb_pos + offset, value);
+  return true;
+};
+
+/**
+ * @returns {number}
+ */
+apemodefb.AnimCurveResampledKeyFb.prototype.value = function() {
+  return this.bb.readFloat32(this.bb_pos + 4);
+};
+
+/**
+ * @param {number} value
+ * @returns {boolean}
+ */
+apemodefb.AnimCurveResampledKeyFb.prototype.mutate_value = function(value) {
+  var offset = this.bb.__offset(this.bb_pos, 4);
+
+  if (offset === 0) {
+    return false;
+  }
+
+  this.bb.writeFloat32(this.bb_pos + offset, value);
+  return true;
+};
+
+/**
+ * @param {flatbuffers.Builder} builder
+ * @param {number} time
+ * @param {number} value
+ * @returns {flatbuffers.Offset}
+ */
+apemodefb.AnimCurveResampledKeyFb.createAnimCurveResampledKeyFb = function(builder, time, value) {
+  builder.prep(4, 8);
+  builder.writeFloat32(value);
+  builder.writeFloat32(time);
+  return builder.offset();
+};
+
+/**
+ * @constructor
+ */
+apemodefb.AnimCurveCubicKeyFb = function() {
+  /**
+   * @type {flatbuffers.ByteBuffer}
+   */
+  this.bb = null;
+
+  /**
+   * @type {number}
+   */
+  this.bb_pos = 0;
+};
+
+/**
+ * @param {number} i
+ * @param {flatbuffers.ByteBuffer} bb
+ * @returns {apemodefb.AnimCurveCubicKeyFb}
+ */
+apemodefb.AnimCurveCubicKeyFb.prototype.__init = function(i, bb) {
+  this.bb_pos = i;
+  this.bb = bb;
+  return this;
+};
+
+/**
+ * @returns {number}
+ */
+apemodefb.AnimCurveCubicKeyFb.prototype.time = function() {
+  return this.bb.readFloat32(this.bb_pos);
+};
+
+/**
+ * @param {number} value
+ * @returns {boolean}
+ */
+apemodefb.AnimCurveCubicKeyFb.prototype.mutate_time = function(value) {
+  var offset = this.bb.__offset(this.bb_pos, 0);
+
+  if (offset === 0) {
+    return false;
+  }
+
+  this.bb.writeFloat32(this.bb_pos + offset, value);
+  return true;
+};
+
+/**
+ * @returns {number}
+ */
+apemodefb.AnimCurveCubicKeyFb.prototype.valueBez0Bez3 = function() {
+  return this.bb.readFloat32(this.bb_pos + 4);
+};
+
+/**
+ * @param {number} value
+ * @returns {boolean}
+ */
+apemodefb.AnimCurveCubicKeyFb.prototype.mutate_value_bez0_bez3 = function(value) {
+  var offset = this.bb.__offset(this.bb_pos, 4);
+
+  if (offset === 0) {
+    return false;
+  }
+
+  this.bb.writeFloat32(this.bb_pos + offset, value);
+  return true;
+};
+
+/**
+ * @returns {number}
+ */
+apemodefb.AnimCurveCubicKeyFb.prototype.bez1 = function() {
+  return this.bb.readFloat32(this.bb_pos + 8);
+};
+
+/**
+ * @param {number} value
+ * @returns {boolean}
+ */
+apemodefb.AnimCurveCubicKeyFb.prototype.mutate_bez1 = function(value) {
+  var offset = this.bb.__offset(this.bb_pos, 8);
+
+  if (offset === 0) {
+    return false;
+  }
+
+  this.bb.writeFloat32(this.bb_pos + offset, value);
+  return true;
+};
+
+/**
+ * @returns {number}
+ */
+apemodefb.AnimCurveCubicKeyFb.prototype.bez2 = function() {
+  return this.bb.readFloat32(this.bb_pos + 12);
+};
+
+/**
+ * @param {number} value
+ * @returns {boolean}
+ */
+apemodefb.AnimCurveCubicKeyFb.prototype.mutate_bez2 = function(value) {
+  var offset = this.bb.__offset(this.bb_pos, 12);
+
+  if (offset === 0) {
+    return false;
+  }
+
+  this.bb.writeFloat32(this.bb_pos + offset, value);
+  return true;
+};
+
+/**
+ * @returns {apemodefb.EInterpolationModeFb}
+ */
+apemodefb.AnimCurveCubicKeyFb.prototype.interpolationMode = function() {
+  return /** @type {apemodefb.EInterpolationModeFb} */ (this.bb.readUint8(this.bb_pos + 16));
+};
+
+/**
+ * @param {apemodefb.EInterpolationModeFb} value
+ * @returns {boolean}
+ */
+apemodefb.AnimCurveCubicKeyFb.prototype.mutate_interpolation_mode = function(value) {
+  var offset = this.bb.__offset(this.bb_pos, 16);
 
   if (offset === 0) {
     return false;
@@ -2361,11 +2726,29 @@ apemodefb.AnimCurveFb.prototype.mutate_compression_type = function(value) {
   return true;
 };
 
+/**
+ * @param {apemodefb.BlobRefFb=} obj
+ * @returns {apemodefb.BlobRefFb|null}
+ */
+apemodefb.AnimCurveFb.prototype.keysBlob = function(obj) {
+  var offset = this.bb.__offset(this.bb_pos, 22);
+  return offset ? (obj || new apemodefb.BlobRefFb).__init(this.bb_pos + offset, this.bb) : null;
+};
+
+/**
+ * @param {apemodefb.BlockCompressionFb=} obj
+ * @returns {apemodefb.BlockCompressionFb|null}
+ */
+apemodefb.AnimCurveFb.prototype.keysCompression = function(obj) {
+  var offset = this.bb.__offset(this.bb_pos, 24);
+  return offset ? (obj || new apemodefb.BlockCompressionFb).__init(this.bb_pos + offset, this.bb) : null;
+};
+
 /**
  * @param {flatbuffers.Builder} builder
  */
 apemodefb.AnimCurveFb.startAnimCurveFb = function(builder) {
-  builder.startObject(9);
+  builder.startObject(11);
 };
 
 /**
@@ -2461,6 +2844,22 @@ apemodefb.AnimCurveFb.addCompressionType = function(builder, compressionType) {
   builder.addFieldInt8(8, compressionType, apemodefb.ECompressionTypeFb.None);
 };
 
+/**
+ * @param {flatbuffers.Builder} builder
+ * @param {flatbuffers.Offset} keysBlobOffset
+ */
+apemodefb.AnimCurveFb.addKeysBlob = function(builder, keysBlobOffset) {
+  builder.addFieldStruct(9, keysBlobOffset, 0);
+};
+
+/**
+ * @param {flatbuffers.Builder} builder
+ * @param {flatbuffers.Offset} keysCompressionOffset
+ */
+apemodefb.AnimCurveFb.addKeysCompression = function(builder, keysCompressionOffset) {
+  builder.addFieldStruct(10, keysCompressionOffset, 0);
+};
+
 /**
  * @param {flatbuffers.Builder} builder
  * @returns {flatbuffers.Offset}
@@ -4339,11 +4738,47 @@ apemodefb.MeshFb.prototype.mutate_skin_id = function(value) {
   return true;
 };
 
+/**
+ * @param {apemodefb.BlobRefFb=} obj
+ * @returns {apemodefb.BlobRefFb|null}
+ */
+apemodefb.MeshFb.prototype.verticesBlob = function(obj) {
+  var offset = this.bb.__offset(this.bb_pos, 16);
+  return offset ? (obj || new apemodefb.BlobRefFb).__init(this.bb_pos + offset, this.bb) : null;
+};
+
+/**
+ * @param {apemodefb.BlobRefFb=} obj
+ * @returns {apemodefb.BlobRefFb|null}
+ */
+apemodefb.MeshFb.prototype.indicesBlob = function(obj) {
+  var offset = this.bb.__offset(this.bb_pos, 18);
+  return offset ? (obj || new apemodefb.BlobRefFb).__init(this.bb_pos + offset, this.bb) : null;
+};
+
+/**
+ * @param {apemodefb.BlockCompressionFb=} obj
+ * @returns {apemodefb.BlockCompressionFb|null}
+ */
+apemodefb.MeshFb.prototype.verticesCompression = function(obj) {
+  var offset = this.bb.__offset(this.bb_pos, 20);
+  return offset ? (obj || new apemodefb.BlockCompressionFb).__init(this.bb_pos + offset, this.bb) : null;
+};
+
+/**
+ * @param {apemodefb.BlockCompressionFb=} obj
+ * @returns {apemodefb.BlockCompressionFb|null}
+ */
+apemodefb.MeshFb.prototype.indicesCompression = function(obj) {
+  var offset = this.bb.__offset(this.bb_pos, 22);
+  return offset ? (obj || new apemodefb.BlockCompressionFb).__init(this.bb_pos + offset, this.bb) : null;
+};
+
 /**
  * @param {flatbuffers.Builder} builder
  */
 apemodefb.MeshFb.startMeshFb = function(builder) {
-  builder.startObject(6);
+  builder.startObject(10);
 };
 
 /**
@@ -4454,23 +4889,55 @@ apemodefb.MeshFb.addSkinId = function(builder, skinId) {
 
 /**
  * @param {flatbuffers.Builder} builder
- * @returns {flatbuffers.Offset}
+ * @param {flatbuffers.Offset} verticesBlobOffset
  */
-apemodefb.MeshFb.endMeshFb = function(builder) {
-  var offset = builder.endObject();
-  return offset;
+apemodefb.MeshFb.addVerticesBlob = function(builder, verticesBlobOffset) {
+  builder.addFieldStruct(6, verticesBlobOffset, 0);
 };
 
 /**
- * @constructor
+ * @param {flatbuffers.Builder} builder
+ * @param {flatbuffers.Offset} indicesBlobOffset
  */
-apemodefb.MaterialPropFb = function() {
-  /**
-   * @type {flatbuffers.ByteBuffer}
-   */
-  this.bb = null;
+apemodefb.MeshFb.addIndicesBlob = function(builder, indicesBlobOffset) {
+  builder.addFieldStruct(7, indicesBlobOffset, 0);
+};
 
-  /**
+/**
+ * @param {flatbuffers.Builder} builder
+ * @param {flatbuffers.Offset} verticesCompressionOffset
+ */
+apemodefb.MeshFb.addVerticesCompression = function(builder, verticesCompressionOffset) {
+  builder.addFieldStruct(8, verticesCompressionOffset, 0);
+};
+
+/**
+ * @param {flatbuffers.Builder} builder
+ * @param {flatbuffers.Offset} indicesCompressionOffset
+ */
+apemodefb.MeshFb.addIndicesCompression = function(builder, indicesCompressionOffset) {
+  builder.addFieldStruct(9, indicesCompressionOffset, 0);
+};
+
+/**
+ * @param {flatbuffers.Builder} builder
+ * @returns {flatbuffers.Offset}
+ */
+apemodefb.MeshFb.endMeshFb = function(builder) {
+  var offset = builder.endObject();
+  return offset;
+};
+
+/**
+ * @constructor
+ */
+apemodefb.MaterialPropFb = function() {
+  /**
+   * @type {flatbuffers.ByteBuffer}
+   */
+  this.bb = null;
+
+  /**
    * @type {number}
    */
   this.bb_pos = 0;
@@ -5693,6 +6160,172 @@ apemodefb.NodeFb.endNodeFb = function(builder) {
   return offset;
 };
 
+/**
+ * @constructor
+ */
+apemodefb.NodeOrderFb = function() {
+  /**
+   * @type {flatbuffers.ByteBuffer}
+   */
+  this.bb = null;
+
+  /**
+   * @type {number}
+   */
+  this.bb_pos = 0;
+};
+
+/**
+ * @param {number} i
+ * @param {flatbuffers.ByteBuffer} bb
+ * @returns {apemodefb.NodeOrderFb}
+ */
+apemodefb.NodeOrderFb.prototype.__init = function(i, bb) {
+  this.bb_pos = i;
+  this.bb = bb;
+  return this;
+};
+
+/**
+ * @returns {number}
+ */
+apemodefb.NodeOrderFb.prototype.nodeId = function() {
+  return this.bb.readUint32(this.bb_pos);
+};
+
+/**
+ * @param {number} value
+ * @returns {boolean}
+ */
+apemodefb.NodeOrderFb.prototype.mutate_node_id = function(value) {
+  var offset = this.bb.__offset(this.bb_pos, 0);
+
+  if (offset === 0) {
+    return false;
+  }
+
+  this.bb.writeUint32(this.bb_pos + offset, value);
+  return true;
+};
+
+/**
+ * @returns {number}
+ */
+apemodefb.NodeOrderFb.prototype.parentIndex = function() {
+  return this.bb.readUint32(this.bb_pos + 4);
+};
+
+/**
+ * @param {number} value
+ * @returns {boolean}
+ */
+apemodefb.NodeOrderFb.prototype.mutate_parent_index = function(value) {
+  var offset = this.bb.__offset(this.bb_pos, 4);
+
+  if (offset === 0) {
+    return false;
+  }
+
+  this.bb.writeUint32(this.bb_pos + offset, value);
+  return true;
+};
+
+/**
+ * @param {flatbuffers.Builder} builder
+ * @param {number} node_id
+ * @param {number} parent_index
+ * @returns {flatbuffers.Offset}
+ */
+apemodefb.NodeOrderFb.createNodeOrderFb = function(builder, node_id, parent_index) {
+  builder.prep(4, 8);
+  builder.writeInt32(parent_index);
+  builder.writeInt32(node_id);
+  return builder.offset();
+};
+
+/**
+ * @constructor
+ */
+apemodefb.NodeLevelFb = function() {
+  /**
+   * @type {flatbuffers.ByteBuffer}
+   */
+  this.bb = null;
+
+  /**
+   * @type {number}
+   */
+  this.bb_pos = 0;
+};
+
+/**
+ * @param {number} i
+ * @param {flatbuffers.ByteBuffer} bb
+ * @returns {apemodefb.NodeLevelFb}
+ */
+apemodefb.NodeLevelFb.prototype.__init = function(i, bb) {
+  this.bb_pos = i;
+  this.bb = bb;
+  return this;
+};
+
+/**
+ * @returns {number}
+ */
+apemodefb.NodeLevelFb.prototype.firstIndex = function() {
+  return this.bb.readUint32(this.bb_pos);
+};
+
+/**
+ * @param {number} value
+ * @returns {boolean}
+ */
+apemodefb.NodeLevelFb.prototype.mutate_first_index = function(value) {
+  var offset = this.bb.__offset(this.bb_pos, 0);
+
+  if (offset === 0) {
+    return false;
+  }
+
+  this.bb.writeUint32(this.bb_pos + offset, value);
+  return true;
+};
+
+/**
+ * @returns {number}
+ */
+apemodefb.NodeLevelFb.prototype.count = function() {
+  return this.bb.readUint32(this.bb_pos + 4);
+};
+
+/**
+ * @param {number} value
+ * @returns {boolean}
+ */
+apemodefb.NodeLevelFb.prototype.mutate_count = function(value) {
+  var offset = this.bb.__offset(this.bb_pos, 4);
+
+  if (offset === 0) {
+    return false;
+  }
+
+  this.bb.writeUint32(this.bb_pos + offset, value);
+  return true;
+};
+
+/**
+ * @param {flatbuffers.Builder} builder
+ * @param {number} first_index
+ * @param {number} count
+ * @returns {flatbuffers.Offset}
+ */
+apemodefb.NodeLevelFb.createNodeLevelFb = function(builder, first_index, count) {
+  builder.prep(4, 8);
+  builder.writeInt32(count);
+  builder.writeInt32(first_index);
+  return builder.offset();
+};
+
 /**
  * @constructor
  */
@@ -5799,11 +6432,38 @@ apemodefb.FileFb.prototype.bufferArray = function() {
   return offset ? new Uint8Array(this.bb.bytes().buffer, this.bb.bytes().byteOffset + this.bb.__vector(this.bb_pos + offset), this.bb.__vector_len(this.bb_pos + offset)) : null;
 };
 
+/**
+ * @param {apemodefb.BlobRefFb=} obj
+ * @returns {apemodefb.BlobRefFb|null}
+ */
+apemodefb.FileFb.prototype.bufferBlob = function(obj) {
+  var offset = this.bb.__offset(this.bb_pos, 10);
+  return offset ? (obj || new apemodefb.BlobRefFb).__init(this.bb_pos + offset, this.bb) : null;
+};
+
+/**
+ * @param {apemodefb.BlockCompressionFb=} obj
+ * @returns {apemodefb.BlockCompressionFb|null}
+ */
+apemodefb.FileFb.prototype.bufferCompression = function(obj) {
+  var offset = this.bb.__offset(this.bb_pos, 12);
+  return offset ? (obj || new apemodefb.BlockCompressionFb).__init(this.bb_pos + offset, this.bb) : null;
+};
+
+/**
+ * @param {apemodefb.TextureInfoFb=} obj
+ * @returns {apemodefb.TextureInfoFb|null}
+ */
+apemodefb.FileFb.prototype.textureInfo = function(obj) {
+  var offset = this.bb.__offset(this.bb_pos, 14);
+  return offset ? (obj || new apemodefb.TextureInfoFb).__init(this.bb_pos + offset, this.bb) : null;
+};
+
 /**
  * @param {flatbuffers.Builder} builder
  */
 apemodefb.FileFb.startFileFb = function(builder) {
-  builder.startObject(3);
+  builder.startObject(6);
 };
 
 /**
@@ -5851,6 +6511,30 @@ apemodefb.FileFb.startBufferVector = function(builder, numElems) {
   builder.startVector(1, numElems, 1);
 };
 
+/**
+ * @param {flatbuffers.Builder} builder
+ * @param {flatbuffers.Offset} bufferBlobOffset
+ */
+apemodefb.FileFb.addBufferBlob = function(builder, bufferBlobOffset) {
+  builder.addFieldStruct(3, bufferBlobOffset, 0);
+};
+
+/**
+ * @param {flatbuffers.Builder} builder
+ * @param {flatbuffers.Offset} bufferCompressionOffset
+ */
+apemodefb.FileFb.addBufferCompression = function(builder, bufferCompressionOffset) {
+  builder.addFieldStruct(4, bufferCompressionOffset, 0);
+};
+
+/**
+ * @param {flatbuffers.Builder} builder
+ * @param {flatbuffers.Offset} textureInfoOffset
+ */
+apemodefb.FileFb.addTextureInfo = function(builder, textureInfoOffset) {
+  builder.addFieldStruct(5, textureInfoOffset, 0);
+};
+
 /**
  * @param {flatbuffers.Builder} builder
  * @returns {flatbuffers.Offset}
@@ -6271,11 +6955,65 @@ apemodefb.SceneFb.prototype.stringValuesLength = function() {
   return offset ? this.bb.__vector_len(this.bb_pos + offset) : 0;
 };
 
+/**
+ * @param {number} index
+ * @param {flatbuffers.Encoding=} optionalEncoding
+ * @returns {string|Uint8Array}
+ */
+apemodefb.SceneFb.prototype.blobFiles = function(index, optionalEncoding) {
+  var offset = this.bb.__offset(this.bb_pos, 44);
+  return offset ? this.bb.__string(this.bb.__vector(this.bb_pos + offset) + index * 4, optionalEncoding) : null;
+};
+
+/**
+ * @returns {number}
+ */
+apemodefb.SceneFb.prototype.blobFilesLength = function() {
+  var offset = this.bb.__offset(this.bb_pos, 44);
+  return offset ? this.bb.__vector_len(this.bb_pos + offset) : 0;
+};
+
+/**
+ * @param {number} index
+ * @param {apemodefb.NodeOrderFb=} obj
+ * @returns {apemodefb.NodeOrderFb}
+ */
+apemodefb.SceneFb.prototype.nodeOrder = function(index, obj) {
+  var offset = this.bb.__offset(this.bb_pos, 46);
+  return offset ? (obj || new apemodefb.NodeOrderFb).__init(this.bb.__vector(this.bb_pos + offset) + index * 8, this.bb) : null;
+};
+
+/**
+ * @returns {number}
+ */
+apemodefb.SceneFb.prototype.nodeOrderLength = function() {
+  var offset = this.bb.__offset(this.bb_pos, 46);
+  return offset ? this.bb.__vector_len(this.bb_pos + offset) : 0;
+};
+
+/**
+ * @param {number} index
+ * @param {apemodefb.NodeLevelFb=} obj
+ * @returns {apemodefb.NodeLevelFb}
+ */
+apemodefb.SceneFb.prototype.nodeLevels = function(index, obj) {
+  var offset = this.bb.__offset(this.bb_pos, 48);
+  return offset ? (obj || new apemodefb.NodeLevelFb).__init(this.bb.__vector(this.bb_pos + offset) + index * 8, this.bb) : null;
+};
+
+/**
+ * @returns {number}
+ */
+apemodefb.SceneFb.prototype.nodeLevelsLength = function() {
+  var offset = this.bb.__offset(this.bb_pos, 48);
+  return offset ? this.bb.__vector_len(this.bb_pos + offset) : 0;
+};
+
 /**
  * @param {flatbuffers.Builder} builder
  */
 apemodefb.SceneFb.startSceneFb = function(builder) {
-  builder.startObject(20);
+  builder.startObject(23);
 };
 
 /**
@@ -6704,6 +7442,67 @@ apemodefb.SceneFb.startStringValuesVector = function(builder, numElems) {
   builder.startVector(4, numElems, 4);
 };
 
+/**
+ * @param {flatbuffers.Builder} builder
+ * @param {flatbuffers.Offset} blobFilesOffset
+ */
+apemodefb.SceneFb.addBlobFiles = function(builder, blobFilesOffset) {
+  builder.addFieldOffset(20, blobFilesOffset, 0);
+};
+
+/**
+ * @param {flatbuffers.Builder} builder
+ * @param {Array.<flatbuffers.Offset>} data
+ * @returns {flatbuffers.Offset}
+ */
+apemodefb.SceneFb.createBlobFilesVector = function(builder, data) {
+  builder.startVector(4, data.length, 4);
+  for (var i = data.length - 1; i >= 0; i--) {
+    builder.addOffset(data[i]);
+  }
+  return builder.endVector();
+};
+
+/**
+ * @param {flatbuffers.Builder} builder
+ * @param {number} numElems
+ */
+apemodefb.SceneFb.startBlobFilesVector = function(builder, numElems) {
+  builder.startVector(4, numElems, 4);
+};
+
+/**
+ * @param {flatbuffers.Builder} builder
+ * @param {flatbuffers.Offset} nodeOrderOffset
+ */
+apemodefb.SceneFb.addNodeOrder = function(builder, nodeOrderOffset) {
+  builder.addFieldOffset(21, nodeOrderOffset, 0);
+};
+
+/**
+ * @param {flatbuffers.Builder} builder
+ * @param {number} numElems
+ */
+apemodefb.SceneFb.startNodeOrderVector = function(builder, numElems) {
+  builder.startVector(8, numElems, 4);
+};
+
+/**
+ * @param {flatbuffers.Builder} builder
+ * @param {flatbuffers.Offset} nodeLevelsOffset
+ */
+apemodefb.SceneFb.addNodeLevels = function(builder, nodeLevelsOffset) {
+  builder.addFieldOffset(22, nodeLevelsOffset, 0);
+};
+
+/**
+ * @param {flatbuffers.Builder} builder
+ * @param {number} numElems
+ */
+apemodefb.SceneFb.startNodeLevelsVector = function(builder, numElems) {
+  builder.startVector(8, numElems, 4);
+};
+
 /**
  * @param {flatbuffers.Builder} builder
  * @returns {flatbuffers.Offset}
@@ -0,0 +1,339 @@
+#pragma once
+
+#include <flatbuffers/flatbuffers.h>
+#include <scene_generated.h>
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Runtime loader of the exported scenes (fbxp_runtime library).
+ * The scene and its sidecar blob files (--split-blobs) are memory mapped, the meshes, skins, curves and files
+ * are accessed through the typed views over the mapped memory, nothing is copied unless the data is encoded
+ * (block compression, meshopt or Draco), the Decode* functions write the decoded data to the caller buffers then.
+ * DecodeService decodes all the encoded meshes and curves of the scene on the thread pool.
+ **/
+
+namespace apemode {
+namespace runtime {
+
+    /**
+     * Non-owning view over the contiguous items, valid while the scene file is loaded.
+     **/
+    template < typename T >
+    class Span {
+    public:
+        Span( ) = default;
+        Span( const T* pItems, size_t itemCount ) : pItems( pItems ), itemCount( itemCount ) {
+        }
+
+        const T* data( ) const { return pItems; }
+        size_t   size( ) const { return itemCount; }
+        bool     empty( ) const { return 0 == itemCount; }
+        const T* begin( ) const { return pItems; }
+        const T* end( ) const { return pItems + itemCount; }
+
+        const T& operator[]( size_t itemIndex ) const {
+            assert( itemIndex < itemCount );
+            return pItems[ itemIndex ];
+        }
+
+    private:
+        const T* pItems    = nullptr;
+        size_t   itemCount = 0;
+    };
+
+    /**
+     * Read-only memory mapping of the whole file.
+     **/
+    class MappedFile {
+    public:
+        MappedFile( ) = default;
+        ~MappedFile( );
+
+        MappedFile( const MappedFile& ) = delete;
+        MappedFile& operator=( const MappedFile& ) = delete;
+
+        bool Open( const std::string& filePath );
+        void Close( );
+
+        bool           IsOpen( ) const { return nullptr != pData; }
+        const uint8_t* GetData( ) const { return pData; }
+        size_t         GetSize( ) const { return dataSize; }
+
+    private:
+        const uint8_t* pData    = nullptr;
+        size_t         dataSize = 0;
+#ifdef _WIN32
+        void* hFile    = nullptr;
+        void* hMapping = nullptr;
+#endif
+    };
+
+    template < typename TVertex >
+    struct VertexFormatTraits;
+
+    template <>
+    struct VertexFormatTraits< apemodefb::DecompressedVertexFb > {
+        static const apemodefb::EVertexFormatFb format = apemodefb::EVertexFormatFb_Decompressed;
+    };
+
+    template <>
+    struct VertexFormatTraits< apemodefb::DecompressedSkinnedVertexFb > {
+        static const apemodefb::EVertexFormatFb format = apemodefb::EVertexFormatFb_DecompressedSkinned;
+    };
+
+    template <>
+    struct VertexFormatTraits< apemodefb::DecompressedFatSkinnedVertexFb > {
+        static const apemodefb::EVertexFormatFb format = apemodefb::EVertexFormatFb_DecompressedFatSkinned;
+    };
+
+    template <>
+    struct VertexFormatTraits< apemodefb::DefaultVertexFb > {
+        static const apemodefb::EVertexFormatFb format = apemodefb::EVertexFormatFb_Default;
+    };
+
+    template <>
+    struct VertexFormatTraits< apemodefb::SkinnedVertexFb > {
+        static const apemodefb::EVertexFormatFb format = apemodefb::EVertexFormatFb_Skinned;
+    };
+
+    template <>
+    struct VertexFormatTraits< apemodefb::FatSkinnedVertexFb > {
+        static const apemodefb::EVertexFormatFb format = apemodefb::EVertexFormatFb_FatSkinned;
+    };
+
+    /* Returns the size of the vertex in bytes, or 0 for the unknown formats. */
+    size_t GetVertexStride( apemodefb::EVertexFormatFb vertexFormat );
+
+    /**
+     * View over the vertices of any EVertexFormatFb.
+     * The typed view (As) is the fastest way to read the vertices of the known format,
+     * the Get* accessors unpack the attributes of any format (the tangent frame of the packed formats is stored
+     * as the quaternion, the joint indices and weights are packed into the integer and fractional parts).
+     **/
+    class VertexSpan {
+    public:
+        VertexSpan( ) = default;
+        VertexSpan( apemodefb::EVertexFormatFb vertexFormat, const void* pVertices, size_t vertexCount );
+
+        apemodefb::EVertexFormatFb GetFormat( ) const { return vertexFormat; }
+        size_t                     GetStride( ) const { return stride; }
+        size_t                     size( ) const { return vertexCount; }
+        bool                       empty( ) const { return 0 == vertexCount; }
+        const uint8_t*             data( ) const { return pVertices; }
+
+        /* Returns the empty span if the vertices are of the other format. */
+        template < typename TVertex >
+        Span< TVertex > As( ) const {
+            if ( VertexFormatTraits< TVertex >::format != vertexFormat )
+                return Span< TVertex >( );
+            return Span< TVertex >( reinterpret_cast< const TVertex* >( pVertices ), vertexCount );
+        }
+
+        apemodefb::Vec3Fb GetPosition( size_t vertexIndex ) const;
+        apemodefb::Vec2Fb GetTexcoord( size_t vertexIndex ) const;
+        apemodefb::Vec3Fb GetNormal( size_t vertexIndex ) const;
+        /* The w component is the bitangent sign. */
+        apemodefb::Vec4Fb GetTangent( size_t vertexIndex ) const;
+        apemodefb::Vec4Fb GetColor( size_t vertexIndex ) const;
+        /* Returns the joint count (0, 4 or 8) of the vertex format. */
+        uint32_t GetJoints( size_t vertexIndex, uint32_t ( &jointIndices )[ 8 ], float ( &jointWeights )[ 8 ] ) const;
+
+    private:
+        apemodefb::EVertexFormatFb vertexFormat = apemodefb::EVertexFormatFb_Decompressed;
+        const uint8_t*             pVertices    = nullptr;
+        size_t                     vertexCount  = 0;
+        size_t                     stride       = 0;
+    };
+
+    /**
+     * View over the 16 or 32 bit indices.
+     **/
+    class IndexSpan {
+    public:
+        IndexSpan( ) = default;
+        IndexSpan( apemodefb::EIndexTypeFb indexType, const void* pIndices, size_t indexCount )
+            : indexType( indexType ), pIndices( reinterpret_cast< const uint8_t* >( pIndices ) ), indexCount( indexCount ) {
+        }
+
+        apemodefb::EIndexTypeFb GetIndexType( ) const { return indexType; }
+        size_t                  size( ) const { return indexCount; }
+        bool                    empty( ) const { return 0 == indexCount; }
+        const uint8_t*          data( ) const { return pIndices; }
+
+        uint32_t operator[]( size_t index ) const {
+            assert( index < indexCount );
+            return indexType == apemodefb::EIndexTypeFb_UInt16 ? reinterpret_cast< const uint16_t* >( pIndices )[ index ]
+                                                               : reinterpret_cast< const uint32_t* >( pIndices )[ index ];
+        }
+
+        /* Returns the empty span if the indices are of the other type. */
+        template < typename TIndex >
+        Span< TIndex > As( ) const {
+            if ( sizeof( TIndex ) != ( indexType == apemodefb::EIndexTypeFb_UInt16 ? sizeof( uint16_t ) : sizeof( uint32_t ) ) )
+                return Span< TIndex >( );
+            return Span< TIndex >( reinterpret_cast< const TIndex* >( pIndices ), indexCount );
+        }
+
+    private:
+        apemodefb::EIndexTypeFb indexType  = apemodefb::EIndexTypeFb_UInt16;
+        const uint8_t*          pIndices   = nullptr;
+        size_t                  indexCount = 0;
+    };
+
+    enum EVerification {
+        eVerification_None,   /* The file is trusted and accessed as is. */
+        eVerification_Lazy,   /* The file is verified on the first access to the scene. */
+        eVerification_OnLoad, /* The file is verified while loading, loading fails if the file is invalid. */
+    };
+
+    /**
+     * Memory mapped scene file.
+     * The views are valid until the scene is unloaded, the functions are safe to call from multiple threads.
+     * The views over the encoded data (IsMeshEncoded, IsCurveEncoded, IsFileEncoded) are empty,
+     * the stored bytes are still accessible (Get*Bytes) and are decoded with the Decode* functions.
+     **/
+    class SceneFile {
+    public:
+        SceneFile( ) = default;
+        ~SceneFile( );
+
+        SceneFile( const SceneFile& ) = delete;
+        SceneFile& operator=( const SceneFile& ) = delete;
+
+        bool Load( const std::string& filePath, EVerification verification = eVerification_Lazy );
+        void Unload( );
+
+        /* Verifies the scene once, returns the cached result afterwards. */
+        bool Verify( );
+
+        /* Returns nullptr if the scene is not loaded or failed the verification. */
+        const apemodefb::SceneFb* GetScene( );
+
+        Span< apemodefb::SubmeshFb > GetSubmeshes( uint32_t meshIndex );
+        Span< apemodefb::SubsetFb >  GetSubsets( uint32_t meshIndex );
+        Span< uint8_t >              GetVertexBytes( uint32_t meshIndex );
+        Span< uint8_t >              GetIndexBytes( uint32_t meshIndex );
+        bool                         IsMeshEncoded( uint32_t meshIndex );
+        VertexSpan                   GetVertices( uint32_t meshIndex );
+        IndexSpan                    GetIndices( uint32_t meshIndex );
+
+        /* The nodes in the breadth-first order and the depth ranges, the parents precede their children. */
+        Span< apemodefb::NodeOrderFb > GetNodeOrder( );
+        Span< apemodefb::NodeLevelFb > GetNodeLevels( );
+
+        Span< uint32_t >          GetSkinLinks( uint32_t skinIndex );
+        Span< apemodefb::Mat4Fb > GetInvBindPoseMatrices( uint32_t skinIndex );
+
+        Span< uint8_t >                            GetCurveKeyBytes( uint32_t curveIndex );
+        bool                                       IsCurveEncoded( uint32_t curveIndex );
+        Span< apemodefb::AnimCurveResampledKeyFb > GetResampledKeys( uint32_t curveIndex );
+        Span< apemodefb::AnimCurveCubicKeyFb >     GetCubicKeys( uint32_t curveIndex );
+
+        Span< uint8_t > GetFileBytes( uint32_t fileIndex );
+        bool            IsFileEncoded( uint32_t fileIndex );
+
+        /**
+         * Decodes the vertices and indices of the encoded mesh (block compression, meshopt, Draco) into the buffers,
+         * the plain meshes are copied. The views over the buffers are returned in the spans.
+         * The Draco meshes are decoded into the Decompressed* vertex formats with the indices of the needed size.
+         **/
+        bool DecodeMesh( uint32_t                meshIndex,
+                         std::vector< uint8_t >& vertices,
+                         std::vector< uint8_t >& indices,
+                         VertexSpan&             vertexSpan,
+                         IndexSpan&              indexSpan );
+
+        /* Decodes the block compressed or Draco keys into the buffer (sorted by time), the plain keys are copied. */
+        bool DecodeCurveKeys( uint32_t curveIndex, std::vector< uint8_t >& keys );
+
+        /* Decodes the block compressed file buffer, the plain buffers are copied. */
+        bool DecodeFile( uint32_t fileIndex, std::vector< uint8_t >& buffer );
+
+    private:
+        const apemodefb::MeshFb*      GetMesh( uint32_t meshIndex );
+        const apemodefb::AnimCurveFb* GetCurve( uint32_t curveIndex );
+        const apemodefb::FileFb*      GetFile( uint32_t fileIndex );
+        Span< uint8_t >               GetBytes( const flatbuffers::Vector< uint8_t >* pInlined, const apemodefb::BlobRefFb* pBlob );
+
+        enum EVerificationState {
+            eVerificationState_Pending,
+            eVerificationState_Succeeded,
+            eVerificationState_Failed,
+        };
+
+        std::string                                  filePath;
+        MappedFile                                   mappedFile;
+        std::vector< std::unique_ptr< MappedFile > > blobFiles;
+        std::mutex                                   blobFilesMutex;
+        std::mutex                                   verificationMutex;
+        std::atomic< EVerificationState >            verificationState{eVerificationState_Pending};
+    };
+
+    /**
+     * Decodes the encoded meshes and curves (block compression, meshopt, Draco) on the worker threads.
+     * The results are written to the caller items, that must stay alive until the returned future is ready,
+     * the items keep their buffers between the decodings, so the same items can be reused as a pool for the next scenes.
+     **/
+    class DecodeService {
+    public:
+        struct DecodedMesh {
+            uint32_t               meshIndex = (uint32_t) -1;
+            std::vector< uint8_t > vertices;
+            std::vector< uint8_t > indices;
+            VertexSpan             vertexSpan;
+            IndexSpan              indexSpan;
+            bool                   decoded = false;
+        };
+
+        struct DecodedCurve {
+            uint32_t               curveIndex = (uint32_t) -1;
+            std::vector< uint8_t > keys;
+            bool                   decoded = false;
+        };
+
+        /* Called on the worker thread after the last item is decoded, the argument is false if any item failed. */
+        typedef std::function< void( bool ) > CompletionCallback;
+
+        /* The hardware thread count is used if the thread count is 0. */
+        explicit DecodeService( uint32_t threadCount = 0 );
+        ~DecodeService( );
+
+        DecodeService( const DecodeService& ) = delete;
+        DecodeService& operator=( const DecodeService& ) = delete;
+
+        std::future< bool > DecodeMesh( SceneFile& sceneFile, uint32_t meshIndex, DecodedMesh& decodedMesh );
+        std::future< bool > DecodeCurve( SceneFile& sceneFile, uint32_t curveIndex, DecodedCurve& decodedCurve );
+
+        /**
+         * Decodes all the encoded meshes and curves of the scene, the items are resized to their counts.
+         * The largest items are scheduled first, so the threads finish at about the same time.
+         **/
+        std::future< bool > DecodeScene( SceneFile&                   sceneFile,
+                                         std::vector< DecodedMesh >&  decodedMeshes,
+                                         std::vector< DecodedCurve >& decodedCurves,
+                                         CompletionCallback           onCompleted = CompletionCallback( ) );
+
+    private:
+        void Enqueue( std::vector< std::function< void( ) > >& newTasks );
+        void Run( );
+
+        std::vector< std::thread >              threads;
+        std::deque< std::function< void( ) > >  tasks;
+        std::mutex                              tasksMutex;
+        std::condition_variable                 tasksCondition;
+        bool                                    stopping = false;
+    };
+
+} // namespace runtime
+} // namespace apemode